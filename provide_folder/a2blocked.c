@@ -1,14 +1,34 @@
 #include <string.h>
 
-#include <a2blocked.h>
+#include "a2methods.h"
+#include "a2blocked.h"
 #include "uarray2b.h"
 
 /* define a private version of each function in A2Methods_T that we implement */
 
 typedef A2Methods_UArray2 A2;   /* private abbreviation */
 
+static int new_blocksize = 0;   /* 0: as large as fits in 64KB */
+static int cache_sized = 0;     /* 1: two levels, from the caches */
+
+void a2blocked_set_blocksize(int blocksize)
+{
+    new_blocksize = blocksize < 0 ? 0 : blocksize;
+}
+
+void a2blocked_set_cache_sized(int on)
+{
+    cache_sized = (on != 0);
+}
+
 static A2 new(int width, int height, int size)
 {
+    if (cache_sized) {
+        return UArray2b_new_cache_sized(width, height, size);
+    }
+    if (new_blocksize > 0) {
+        return UArray2b_new(width, height, size, new_blocksize);
+    }
     return UArray2b_new_64K_block(width, height, size);
 }
 
@@ -44,6 +64,23 @@ static A2Methods_Object *at(A2 array2, int i, int j)
     return UArray2b_at(array2, i, j);
 }
 
+static void copy(A2 array2, A2Methods_Object *dst,
+                 const A2Methods_Object *src)
+{
+    UArray2b_copy(array2, dst, src);
+}
+
+static void copy_span(A2 array2, A2Methods_Object *dst,
+                      const A2Methods_Object *src, int n, long step)
+{
+    UArray2b_copy_span(array2, dst, src, n, step);
+}
+
+static void swap(A2 array2, A2Methods_Object *a, A2Methods_Object *b)
+{
+    UArray2b_swap(array2, a, b);
+}
+
 typedef void applyfun(int i, int j, UArray2b_T array2b, void *elem, void *cl);
 
 static void map_block_major(A2 array2, A2Methods_applyfun apply, void *cl)
@@ -51,6 +88,16 @@ static void map_block_major(A2 array2, A2Methods_applyfun apply, void *cl)
     UArray2b_map(array2, (applyfun *) apply, cl);
 }
 
+static void map_row_major(A2 array2, A2Methods_applyfun apply, void *cl)
+{
+    UArray2b_map_row_major(array2, (applyfun *) apply, cl);
+}
+
+static void map_col_major(A2 array2, A2Methods_applyfun apply, void *cl)
+{
+    UArray2b_map_col_major(array2, (applyfun *) apply, cl);
+}
+
 struct small_closure {
     A2Methods_smallapplyfun *apply;
     void *cl;
@@ -72,6 +119,62 @@ static void small_map_block_major(A2 a2, A2Methods_smallapplyfun apply,
     UArray2b_map(a2, apply_small, &mycl);
 }
 
+static void small_map_row_major(A2 a2, A2Methods_smallapplyfun apply,
+                  void *cl)
+{
+    struct small_closure mycl = { apply, cl };
+    UArray2b_map_row_major(a2, apply_small, &mycl);
+}
+
+static void small_map_col_major(A2 a2, A2Methods_smallapplyfun apply,
+                  void *cl)
+{
+    struct small_closure mycl = { apply, cl };
+    UArray2b_map_col_major(a2, apply_small, &mycl);
+}
+
+/* each row is one span per block it crosses, left to right */
+static void span_map_row_major(A2 array2, A2Methods_spanfun apply, void *cl)
+{
+    int w = UArray2b_width(array2);
+    int h = UArray2b_height(array2);
+    int bs = UArray2b_blocksize(array2);
+
+    for (int row = 0; row < h; row++) {
+        for (int left = 0; left < w; left += bs) {
+            int n = left + bs < w ? bs : w - left;
+            apply(left, row, n, array2, UArray2b_at(array2, left, row), cl);
+        }
+    }
+}
+
+/* each row of a block is a span; blocks go in the order of UArray2b_map,
+ * superblock by superblock */
+static void span_map_block_major(A2 array2, A2Methods_spanfun apply, void *cl)
+{
+    int w = UArray2b_width(array2);
+    int h = UArray2b_height(array2);
+    int bs = UArray2b_blocksize(array2);
+    int super = bs * UArray2b_superblock(array2);
+
+    for (int stop = 0; stop < h; stop += super) {
+        int sbottom = stop + super < h ? stop + super : h;
+        for (int sleft = 0; sleft < w; sleft += super) {
+            int sright = sleft + super < w ? sleft + super : w;
+            for (int top = stop; top < sbottom; top += bs) {
+                int bottom = top + bs < sbottom ? top + bs : sbottom;
+                for (int left = sleft; left < sright; left += bs) {
+                    int n = left + bs < sright ? bs : sright - left;
+                    for (int row = top; row < bottom; row++) {
+                        apply(left, row, n, array2,
+                              UArray2b_at(array2, left, row), cl);
+                    }
+                }
+            }
+        }
+    }
+}
+
 static struct A2Methods_T uarray2_methods_blocked_struct = {
     new,
     new_with_blocksize,
@@ -81,14 +184,20 @@ static struct A2Methods_T uarray2_methods_blocked_struct = {
     size,
     blocksize,
     at,
-    NULL,           /* map_row_major */
-    NULL,           /* map_col_major */
+    map_row_major,
+    map_col_major,
     map_block_major,
     map_block_major,    /* map_default */
-    NULL,           /* small_map_row_major */
-    NULL,           /* small_map_col_major */
+    small_map_row_major,
+    small_map_col_major,
     small_map_block_major,
     small_map_block_major,  /* small_map_default */
+    span_map_row_major,
+    span_map_block_major,
+    span_map_block_major,   /* span_map_default */
+    copy,
+    copy_span,
+    swap,
 };
 
 /* finally the payoff: here is the exported pointer to the struct */
@@ -0,0 +1,33 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** a2blocked.h
+ ** 19 October 2026
+ **
+ ** Purpose: our copy of the course's a2blocked.h, which exports only the
+ **          methods suite, with ways to choose the block size the suite's
+ **          new() uses.
+ **/
+
+#ifndef A2BLOCKED_INCLUDED
+#define A2BLOCKED_INCLUDED
+
+#include "a2methods.h"
+
+extern A2Methods_T uarray2_methods_blocked;
+
+/* @function: a2blocked_set_blocksize
+ * @purpose: set the block size uarray2_methods_blocked->new uses; 0 (the
+ *           default) gives the largest block that fits in 64KB, as
+ *           UArray2b_new_64K_block does
+ */
+extern void a2blocked_set_blocksize(int blocksize);
+
+/* @function: a2blocked_set_cache_sized
+ * @purpose: with on nonzero, make uarray2_methods_blocked->new build
+ *           two-level arrays sized from the caches, as
+ *           UArray2b_new_cache_sized does, whatever the block size set;
+ *           with on 0, go back to one level
+ */
+extern void a2blocked_set_cache_sized(int on);
+
+#endif
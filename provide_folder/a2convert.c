@@ -0,0 +1,120 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** a2convert.c
+ ** 19 October 2026
+ **
+ ** Purpose: copies between plain and blocked arrays, one block-row
+ **          segment at a time. A segment is where a row meets a block:
+ **          up to blocksize cells that are next to each other in both
+ **          layouts, so both directions are the same loop.
+ **/
+
+#include <string.h>
+#include <pthread.h>
+
+#include "assert.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+#include "a2convert.h"
+
+typedef A2Methods_UArray2 A2;
+
+/* one thread's share of a copy: rows [firstRow, lastRow) */
+struct Band {
+    A2Methods_T dstMethods, srcMethods;
+    A2 dst, src;
+    int blocksize;
+    int firstRow, lastRow;
+};
+
+/* @function: copyBand
+ * @purpose: copy a band of rows, a segment at a time
+ */
+static void *copyBand(void *vband)
+{
+    struct Band *band = vband;
+    A2Methods_T src = band->srcMethods;
+    int width = src->width(band->src);
+    int size = src->size(band->src);
+    int bs = band->blocksize;
+
+    for (int row = band->firstRow; row < band->lastRow; row++) {
+        for (int left = 0; left < width; left += bs) {
+            int n = left + bs < width ? bs : width - left;
+            memcpy(band->dstMethods->at(band->dst, left, row),
+                   src->at(band->src, left, row), (size_t)n * size);
+        }
+    }
+    return NULL;
+}
+
+/* @function: copyInBands
+ * @purpose: copy src into dst, which has the same shape, on nthreads
+ *           threads. Bands are whole block rows, so no two threads
+ *           write to the same block.
+ */
+static void copyInBands(A2Methods_T dstMethods, A2 dst,
+                        A2Methods_T srcMethods, A2 src, int blocksize,
+                        int nthreads)
+{
+    assert(nthreads > 0);
+    int height = srcMethods->height(src);
+    int units = (height + blocksize - 1) / blocksize;
+    if (nthreads > units) {
+        nthreads = units > 0 ? units : 1;
+    }
+
+    struct Band bands[nthreads];
+    pthread_t threads[nthreads];
+    for (int i = 0; i < nthreads; i++) {
+        bands[i].dstMethods = dstMethods;
+        bands[i].srcMethods = srcMethods;
+        bands[i].dst = dst;
+        bands[i].src = src;
+        bands[i].blocksize = blocksize;
+        bands[i].firstRow = (units * i / nthreads) * blocksize;
+        bands[i].lastRow = (units * (i + 1) / nthreads) * blocksize;
+        if (bands[i].lastRow > height) {
+            bands[i].lastRow = height;
+        }
+    }
+
+    /* the calling thread takes the first band itself */
+    for (int i = 1; i < nthreads; i++) {
+        pthread_create(&threads[i], NULL, copyBand, &bands[i]);
+    }
+    copyBand(&bands[0]);
+    for (int i = 1; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+extern A2 A2Convert_toBlocked(A2 plain, int blocksize, int nthreads)
+{
+    A2Methods_T from = uarray2_methods_plain;
+    A2Methods_T to = uarray2_methods_blocked;
+    assert(plain != NULL && blocksize >= 0);
+
+    int width = from->width(plain);
+    int height = from->height(plain);
+    int size = from->size(plain);
+    A2 blocked = blocksize == 0
+                 ? to->new(width, height, size)
+                 : to->new_with_blocksize(width, height, size, blocksize);
+    copyInBands(to, blocked, from, plain, to->blocksize(blocked), nthreads);
+    return blocked;
+}
+
+extern A2 A2Convert_toPlain(A2 blocked, int nthreads)
+{
+    A2Methods_T from = uarray2_methods_blocked;
+    A2Methods_T to = uarray2_methods_plain;
+    assert(blocked != NULL);
+
+    A2 plain = to->new(from->width(blocked), from->height(blocked),
+                       from->size(blocked));
+    copyInBands(to, plain, from, blocked, from->blocksize(blocked),
+                nthreads);
+    return plain;
+}
@@ -0,0 +1,42 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** a2convert.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for a2convert.c, which copies an image
+ **          between plain (UArray2) and blocked (UArray2b) storage. Each
+ **          row of a blocked array is one run of cells per block it
+ **          crosses, and each row of a plain array is one run, so the copy
+ **          is one memcpy per block-row segment instead of an at() per
+ **          cell on each side.
+ **/
+
+#ifndef A2CONVERT_INCLUDED
+#define A2CONVERT_INCLUDED
+
+#include "a2methods.h"
+
+/* @function: A2Convert_toBlocked
+ * @purpose: make a blocked copy of a plain array
+ *
+ * @parameters: 1) A2Methods_UArray2 plain, made by uarray2_methods_plain
+ *              2) int blocksize, or 0 for the blocked suite's default
+ *              3) int nthreads, > 0; each thread copies a band of whole
+ *                 block rows
+ * @returns: the copy, made by uarray2_methods_blocked; the caller frees
+ *           it
+ */
+extern A2Methods_UArray2 A2Convert_toBlocked(A2Methods_UArray2 plain,
+                                             int blocksize, int nthreads);
+
+/* @function: A2Convert_toPlain
+ * @purpose: make a plain copy of a blocked array
+ *
+ * @parameters: 1) A2Methods_UArray2 blocked, made by uarray2_methods_blocked
+ *              2) int nthreads, > 0
+ * @returns: the copy, made by uarray2_methods_plain; the caller frees it
+ */
+extern A2Methods_UArray2 A2Convert_toPlain(A2Methods_UArray2 blocked,
+                                           int nthreads);
+
+#endif /* A2CONVERT_INCLUDED */
@@ -9,10 +9,11 @@
 
 #include <string.h>
 
-#include <a2plain.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include "a2methods.h"
+#include <a2plain.h>
 #include "uarray2.h"
 
 typedef A2Methods_UArray2 A2;
@@ -57,6 +58,23 @@ static A2Methods_Object *at(A2 array2, int i, int j)
     return UArray2_at(array2, i, j);
 }
 
+static void copy(A2 array2, A2Methods_Object *dst,
+                 const A2Methods_Object *src)
+{
+    UArray2_copy(array2, dst, src);
+}
+
+static void copy_span(A2 array2, A2Methods_Object *dst,
+                      const A2Methods_Object *src, int n, long step)
+{
+    UArray2_copy_span(array2, dst, src, n, step);
+}
+
+static void swap(A2 array2, A2Methods_Object *a, A2Methods_Object *b)
+{
+    UArray2_swap(array2, a, b);
+}
+
 static int blocksize(A2 array2)
 {
     (void) array2;
@@ -113,6 +131,89 @@ static void small_map_col_major(A2Methods_UArray2        a2,
 
 
 
+    /* a UArray2 is one row-major run, so each row is a span */
+static void span_map_row_major(A2Methods_UArray2 uarray2,
+                               A2Methods_spanfun apply,
+                               void *cl)
+{
+    int width = UArray2_width(uarray2);
+    int height = UArray2_height(uarray2);
+    if (width == 0) {
+        return;
+    }
+    for (int row = 0; row < height; row++) {
+        apply(0, row, width, uarray2, UArray2_at(uarray2, 0, row), cl);
+    }
+}
+
+/********** tiled traversal **********/
+
+#define DEFAULT_L1_BYTES (32 * 1024)
+
+static int tile_size = 0;       /* 0: pick one per array */
+
+void a2plain_set_tile_size(int tile)
+{
+    tile_size = tile < 0 ? 0 : tile;
+}
+
+int a2plain_tile_size(A2Methods_UArray2 array2)
+{
+    if (tile_size > 0) {
+        return tile_size;
+    }
+    long l1 = -1;
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+#endif
+    if (l1 <= 0) {
+        l1 = DEFAULT_L1_BYTES;
+    }
+    /* a destination tile and a source tile, tile * tile elements each */
+    long elements = l1 / (2 * UArray2_size(array2));
+    int tile = 1;
+    while ((long)(2 * tile) * (2 * tile) <= elements) {
+        tile *= 2;
+    }
+    return tile;
+}
+
+void a2plain_map_tile_major(A2Methods_UArray2 uarray2,
+                            A2Methods_applyfun apply,
+                            void *cl)
+{
+    UArray2_map_tiled(uarray2, a2plain_tile_size(uarray2),
+                      (UArray2_applyfun*)apply, cl);
+}
+
+void a2plain_small_map_tile_major(A2Methods_UArray2        a2,
+                                  A2Methods_smallapplyfun  apply,
+                                  void *cl)
+{
+    struct small_closure mycl = { apply, cl };
+    UArray2_map_tiled(a2, a2plain_tile_size(a2), apply_small, &mycl);
+}
+
+void a2plain_span_map_tile_major(A2Methods_UArray2 uarray2,
+                                 A2Methods_spanfun apply,
+                                 void *cl)
+{
+    int width = UArray2_width(uarray2);
+    int height = UArray2_height(uarray2);
+    int tile = a2plain_tile_size(uarray2);
+
+    for (int top = 0; top < height; top += tile) {
+        int bottom = top + tile < height ? top + tile : height;
+        for (int left = 0; left < width; left += tile) {
+            int n = left + tile < width ? tile : width - left;
+            for (int row = top; row < bottom; row++) {
+                apply(left, row, n, uarray2,
+                      UArray2_at(uarray2, left, row), cl);
+            }
+        }
+    }
+}
+
 static struct A2Methods_T uarray2_methods_plain_struct = {
     new,
     new_with_blocksize,
@@ -134,6 +235,12 @@ static struct A2Methods_T uarray2_methods_plain_struct = {
     small_map_col_major,
     NULL,                /* again, no block major */
     small_map_row_major, /* again map_default is one with best locality */
+    span_map_row_major,
+    NULL,                /* no block major spans either */
+    span_map_row_major,  /* and row major is still the best */
+    copy,
+    copy_span,
+    swap,
 };
 
 
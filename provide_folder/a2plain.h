@@ -0,0 +1,44 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** a2plain.h
+ ** 19 October 2026
+ **
+ ** Purpose: our copy of the course's a2plain.h, which exports only the
+ **          methods suite, with tiled traversal of plain arrays added.
+ **          The suite's block-major maps stay NULL, since a UArray2 has
+ **          no blocks; the tiled maps are exported on their own and have
+ **          the same types as the suite's maps.
+ **/
+
+#ifndef A2PLAIN_INCLUDED
+#define A2PLAIN_INCLUDED
+
+#include "a2methods.h"
+
+extern A2Methods_T uarray2_methods_plain;
+
+/* @function: a2plain_map_tile_major, a2plain_small_map_tile_major,
+ *            a2plain_span_map_tile_major
+ * @purpose: visit a UArray2 made by uarray2_methods_plain tile by tile:
+ *           square tiles row-major, row-major within each tile. The span
+ *           map calls back once per row of a tile.
+ */
+extern A2Methods_mapfun a2plain_map_tile_major;
+extern A2Methods_smallmapfun a2plain_small_map_tile_major;
+extern A2Methods_spanmapfun a2plain_span_map_tile_major;
+
+/* @function: a2plain_set_tile_size
+ * @purpose: set the tile size the tiled maps use; 0 (the default) picks
+ *           one per array, see a2plain_tile_size
+ */
+extern void a2plain_set_tile_size(int tile);
+
+/* @function: a2plain_tile_size
+ * @purpose: the tile size the tiled maps use for array2. Unless one has
+ *           been set it is the largest power of two for which a tile of
+ *           the destination and the tile of the source it is copied from
+ *           fit in the L1 data cache together.
+ */
+extern int a2plain_tile_size(A2Methods_UArray2 array2);
+
+#endif
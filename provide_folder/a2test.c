@@ -1,9 +1,20 @@
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include "assert.h"
+#include "mem.h"
 #include "a2methods.h"
 #include "a2plain.h"
 #include "a2blocked.h"
+#include "a2convert.h"
+#include "a2view.h"
+#include "uarray2b.h"
+#include "pnm.h"
+#include "transform.h"
+#include "pipeline.h"
+#include "pnmgray.h"
+#include "planar.h"
+#include "anyangle.h"
 
 
 #define W 13
@@ -66,6 +77,214 @@ static void double_row_major_plus()
         methods->free(&array);
 }
 
+static void double_col_major_plus()
+{
+        /* store increasing integers in column-major order */
+        A2 array = methods->new_with_blocksize(W, H, sizeof(int), BS);
+        int counter = 1;
+        for (int i = 0; i < W; i++) {
+                for (int j = 0; j < H; j++) { /* row index varies faster */
+                        int *p = methods->at(array, i, j);
+                        *p = counter++;
+                }
+        }
+        if (methods->map_col_major) {
+                counter = 1;
+                methods->map_col_major(array, check_and_increment, &counter);
+        }
+        if (methods->small_map_col_major) {
+                counter = 1;
+                methods->small_map_col_major(array,
+                                             small_check_and_increment,
+                                             &counter);
+        }
+        methods->free(&array);
+}
+
+/* each span must hold the elements at (i, j) .. (i + n - 1, j), in order,
+ * and every element must be in exactly one span */
+static void check_span(int i, int j, int n, A2 a, void *elem, void *cl)
+{
+        int *visited = cl;
+        int size = methods->size(a);
+        assert(n > 0 && i + n <= methods->width(a));
+        for (int k = 0; k < n; k++) {
+                assert((char *)elem + k * size == methods->at(a, i + k, j));
+                assert(visited[j * W + i + k] == 0);
+                visited[j * W + i + k] = 1;
+        }
+}
+
+static void test_spans(A2Methods_T methods_under_test)
+{
+        methods = methods_under_test;
+        A2Methods_spanmapfun *maps[] = {
+                methods->span_map_row_major,
+                methods->span_map_block_major,
+                methods->span_map_default
+        };
+        assert(methods->span_map_default != NULL);
+
+        A2 array = methods->new_with_blocksize(W, H, sizeof(int), BS);
+        for (unsigned m = 0; m < sizeof(maps) / sizeof(maps[0]); m++) {
+                if (maps[m] == NULL) {
+                        continue;
+                }
+                int visited[W * H] = { 0 };
+                maps[m](array, check_span, visited);
+                for (int k = 0; k < W * H; k++) {
+                        assert(visited[k] == 1);
+                }
+        }
+        methods->free(&array);
+}
+
+/* every byte of an element holds its own column, row and byte index */
+static unsigned char element_byte(int i, int j, int b)
+{
+        return (unsigned char)(i * 31 + j * 7 + b);
+}
+
+/* a run copied forwards and backwards must match the array, and two
+ * swaps must leave it as it was */
+static void check_copies(int i, int j, int n, A2 a, void *elem, void *cl)
+{
+        (void) cl;
+        int size = methods->size(a);
+        unsigned char copied[W * 16];
+        methods->copy_span(a, copied, elem, n, size);
+        for (int k = 0; k < n * size; k++) {
+                assert(copied[k] == element_byte(i + k / size, j, k % size));
+        }
+        methods->copy_span(a, copied, (char *)elem + (n - 1) * size, n,
+                           -size);
+        for (int k = 0; k < n * size; k++) {
+                assert(copied[k] ==
+                       element_byte(i + n - 1 - k / size, j, k % size));
+        }
+        methods->copy(a, copied, elem);
+        for (int b = 0; b < size; b++) {
+                assert(copied[b] == element_byte(i, j, b));
+        }
+        void *last = (char *)elem + (n - 1) * size;
+        methods->swap(a, elem, last);
+        for (int b = 0; b < size; b++) {
+                assert(((unsigned char *)elem)[b] ==
+                       element_byte(i + n - 1, j, b));
+        }
+        methods->swap(a, elem, last);
+        for (int b = 0; b < size; b++) {
+                assert(((unsigned char *)elem)[b] == element_byte(i, j, b));
+        }
+}
+
+/* the copies specialized for each size, and the one for any size (5) */
+static void test_copies(A2Methods_T methods_under_test)
+{
+        methods = methods_under_test;
+        int sizes[] = { 1, 2, 3, 4, 5, 6, 8, 12, 16 };
+        for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+                A2 array = methods->new_with_blocksize(W, H, sizes[s], BS);
+                for (int j = 0; j < H; j++) {
+                        for (int i = 0; i < W; i++) {
+                                unsigned char *elem = methods->at(array, i,
+                                                                  j);
+                                for (int b = 0; b < sizes[s]; b++) {
+                                        elem[b] = element_byte(i, j, b);
+                                }
+                        }
+                }
+                methods->span_map_default(array, check_copies, NULL);
+                methods->free(&array);
+        }
+}
+
+/* a plain array copied into blocks and back must come back unchanged */
+static void test_convert(int blocksize, int nthreads)
+{
+        A2Methods_T plain = uarray2_methods_plain;
+        A2Methods_T blocked = uarray2_methods_blocked;
+        A2 array = plain->new(W, H, sizeof(int));
+        for (int j = 0; j < H; j++) {
+                for (int i = 0; i < W; i++) {
+                        *(int *)plain->at(array, i, j) = 1000 * i + j;
+                }
+        }
+        A2 blocks = A2Convert_toBlocked(array, blocksize, nthreads);
+        A2 back = A2Convert_toPlain(blocks, nthreads);
+        for (int j = 0; j < H; j++) {
+                for (int i = 0; i < W; i++) {
+                        assert(*(int *)blocked->at(blocks, i, j)
+                               == 1000 * i + j);
+                        assert(*(int *)plain->at(back, i, j) == 1000 * i + j);
+                }
+        }
+        plain->free(&array);
+        plain->free(&back);
+        blocked->free(&blocks);
+}
+
+/* where (i, j) of a w x h array rotated and then flipped comes from */
+static void view_source(int rotation, const char *flip, int w, int h,
+                        int i, int j, int *x, int *y)
+{
+        int rw = (rotation == 90 || rotation == 270) ? h : w;
+        int rh = (rotation == 90 || rotation == 270) ? w : h;
+        if (flip[0] == 'h') {
+                j = rh - 1 - j;
+        } else if (flip[0] == 'v') {
+                i = rw - 1 - i;
+        }
+        switch (rotation) {
+                case 90:  *x = j;         *y = h - 1 - i; break;
+                case 180: *x = w - 1 - i; *y = h - 1 - j; break;
+                case 270: *x = w - 1 - j; *y = i;         break;
+                default:  *x = i;         *y = j;         break;
+        }
+}
+
+/* every view, of a view too, must show what the transform would make */
+static void test_views(A2Methods_T under)
+{
+        A2Methods_T view_methods = a2view_methods;
+        const char *flips[] = { " ", "horizontal", "vertical" };
+        A2 array = under->new_with_blocksize(W, H, sizeof(int), BS);
+        for (int j = 0; j < H; j++) {
+                for (int i = 0; i < W; i++) {
+                        *(int *)under->at(array, i, j) = 1000 * i + j;
+                }
+        }
+        for (int r = 0; r < 360; r += 90) {
+                for (int f = 0; f < 3; f++) {
+                        A2 view = A2View_new(under, array, r, flips[f]);
+                        A2 twice = A2View_new(view_methods, view, 90, " ");
+                        A2 copy = A2View_materialize(view,
+                                                     uarray2_methods_plain);
+                        int vw = view_methods->width(view);
+                        int vh = view_methods->height(view);
+                        assert(view_methods->width(twice) == vh);
+                        for (int j = 0; j < vh; j++) {
+                                for (int i = 0; i < vw; i++) {
+                                        int x, y;
+                                        view_source(r, flips[f], W, H, i, j,
+                                                    &x, &y);
+                                        int n = 1000 * x + y;
+                                        assert(*(int *)view_methods->at(
+                                                view, i, j) == n);
+                                        assert(*(int *)view_methods->at(
+                                                twice, vh - 1 - j, i) == n);
+                                        assert(*(int *)uarray2_methods_plain
+                                               ->at(copy, i, j) == n);
+                                }
+                        }
+                        view_methods->free(&twice);
+                        view_methods->free(&view);
+                        uarray2_methods_plain->free(&copy);
+                }
+        }
+        under->free(&array);
+}
+
 #if 0
 static void show(int i, int j, A2 a, void *elem, void *cl) 
 {
@@ -127,10 +346,8 @@ static void test_methods(A2Methods_T methods_under_test)
         assert(has_minimum_methods(methods));
         assert(has_small_plain_methods(methods)
                || has_small_blocked_methods(methods));
-        assert(!(has_small_plain_methods(methods)
-                 && has_small_blocked_methods(methods)));
-        assert(!(has_plain_methods(methods)
-                 && has_blocked_methods(methods)));
+        /* a blocked array can also be mapped in row and column order,
+         * so a suite may have both kinds of maps */
 
         if (!(has_plain_methods(methods) || has_blocked_methods(methods)))
                 fprintf(stderr, "Some full mapping methods are missing\n");
@@ -158,15 +375,611 @@ static void test_methods(A2Methods_T methods_under_test)
                 }
         }
         double_row_major_plus();
+        double_col_major_plus();
+        methods->free(&array);
+
+        /* a single element still needs a whole block */
+        array = methods->new_with_blocksize(1, 1, sizeof(unsigned), BS);
+        copy_unsigned(methods, array, 0, 0, 42);
+        check(array, 0, 0, 42);
         methods->free(&array);
 }
 
+/*................... ROTATE, THEN FLIP ...................*/
+
+static const int rotations[] = { 0, 90, 180, 270 };
+static char *flips[] = { "none", "horizontal", "vertical" };
+
+/* the pixel at (i, j) of the test image */
+static struct Pnm_rgb test_pixel(int i, int j)
+{
+        struct Pnm_rgb pixel = { i, j, (31 * i + j) % 256 };
+        return pixel;
+}
+
+/* where pixel (i, j) of a W x H image rotated clockwise by rotation and
+ * then flipped comes from */
+static void rotated_source(int rotation, const char *flip, int i, int j,
+                           int *si, int *sj)
+{
+        int quarter = (rotation == 90 || rotation == 270);
+        int width = quarter ? H : W;
+        int height = quarter ? W : H;
+        if (strcmp(flip, "horizontal") == 0) {
+                j = height - j - 1;
+        } else if (strcmp(flip, "vertical") == 0) {
+                i = width - i - 1;
+        }
+        switch (rotation) {
+                case 90:  *si = j;         *sj = H - i - 1; break;
+                case 180: *si = W - i - 1; *sj = H - j - 1; break;
+                case 270: *si = W - j - 1; *sj = i;         break;
+                default:  *si = i;         *sj = j;         break;
+        }
+}
+
+/* a width x height image of test_pixel, in arrays of under */
+static Pnm_ppm new_sized_image(A2Methods_T under, int width, int height)
+{
+        Pnm_ppm ppm;
+        NEW(ppm);
+        ppm->width = width;
+        ppm->height = height;
+        ppm->denominator = 255;
+        ppm->methods = under;
+        ppm->pixels = under->new_with_blocksize(width, height,
+                                                sizeof(struct Pnm_rgb), BS);
+        for (int j = 0; j < height; j++) {
+                for (int i = 0; i < width; i++) {
+                        *(Pnm_rgb)under->at(ppm->pixels, i, j) =
+                                test_pixel(i, j);
+                }
+        }
+        return ppm;
+}
+
+static Pnm_ppm new_test_image(A2Methods_T under)
+{
+        return new_sized_image(under, W, H);
+}
+
+/* result, of under, must be the test image rotated and then flipped */
+static void check_rotated(A2Methods_T under, A2 result, int rotation,
+                          const char *flip)
+{
+        int quarter = (rotation == 90 || rotation == 270);
+        assert(under->width(result) == (quarter ? H : W));
+        assert(under->height(result) == (quarter ? W : H));
+        for (int j = 0; j < under->height(result); j++) {
+                for (int i = 0; i < under->width(result); i++) {
+                        int si, sj;
+                        rotated_source(rotation, flip, i, j, &si, &sj);
+                        struct Pnm_rgb want = test_pixel(si, sj);
+                        Pnm_rgb got = under->at(result, i, j);
+                        assert(got->red == want.red &&
+                               got->green == want.green &&
+                               got->blue == want.blue);
+                }
+        }
+}
+
+/* every rotation with every flip gives the same image in each way
+ * ppmtrans can transform: alterImage with each layout, on threads, the
+ * pipeline, and a view */
+static void test_rotate_then_flip(void)
+{
+        for (unsigned r = 0; r < sizeof(rotations) / sizeof(rotations[0]);
+             r++) {
+                for (unsigned f = 0; f < sizeof(flips) / sizeof(flips[0]);
+                     f++) {
+                        int rotation = rotations[r];
+                        char *flip = flips[f];
+                        int quarter = (rotation == 90 || rotation == 270);
+                        int width = quarter ? H : W;
+                        int height = quarter ? W : H;
+
+                        A2Methods_T suites[] = { uarray2_methods_plain,
+                                                 uarray2_methods_plain,
+                                                 uarray2_methods_blocked };
+                        A2Methods_mapfun *maps[] = {
+                                uarray2_methods_plain->map_row_major,
+                                uarray2_methods_plain->map_col_major,
+                                uarray2_methods_blocked->map_block_major
+                        };
+                        /* with neither, ppmtrans writes the source */
+                        int arrays = rotation == 0 && f == 0 ? 0 : 3;
+                        for (int s = 0; s < arrays; s++) {
+                                A2Methods_T under = suites[s];
+                                Pnm_ppm ppm = new_test_image(under);
+                                A2 result = under->new_with_blocksize(
+                                        width, height,
+                                        sizeof(struct Pnm_rgb), BS);
+                                alterImage(rotation, flip, ppm, maps[s],
+                                           result);
+                                check_rotated(under, result, rotation,
+                                              flip);
+                                alterImageThreaded(rotation, flip, ppm,
+                                                   maps[s], result, 3);
+                                check_rotated(under, result, rotation,
+                                              flip);
+                                A2 view = A2View_new(under, ppm->pixels,
+                                                     rotation, flip);
+                                check_rotated(a2view_methods, view,
+                                              rotation, flip);
+                                A2View_fill(view, under, result);
+                                check_rotated(under, result, rotation,
+                                              flip);
+                                a2view_methods->free(&view);
+                                under->free(&result);
+                                Pnm_ppmfree(&ppm);
+                        }
+
+                        FILE *in = tmpfile();
+                        FILE *out = tmpfile();
+                        assert(in != NULL && out != NULL);
+                        Pnm_ppm ppm = new_test_image(uarray2_methods_plain);
+                        Pnm_ppmwrite(in, ppm);
+                        Pnm_ppmfree(&ppm);
+                        rewind(in);
+                        assert(Pipeline_run(in, out, rotation, flip,
+                                            uarray2_methods_plain, 4,
+                                            IMAGEIO_PLAIN, NULL, NULL) == 0);
+                        rewind(out);
+                        ppm = Pnm_ppmread(out, uarray2_methods_plain);
+                        check_rotated(uarray2_methods_plain, ppm->pixels,
+                                      rotation, flip);
+                        Pnm_ppmfree(&ppm);
+                        fclose(in);
+                        fclose(out);
+                }
+        }
+}
+
+/* images with no rows or no columns rotate and flip to empty images of
+ * the turned shape in every layout, on one thread or several, as they did
+ * before the specialized loops */
+static void test_empty_images(void)
+{
+        static const int shapes[][2] = { { 5, 0 }, { 0, 5 }, { 0, 0 } };
+        A2Methods_T suites[] = { uarray2_methods_plain,
+                                 uarray2_methods_plain,
+                                 uarray2_methods_blocked };
+        A2Methods_mapfun *maps[] = {
+                uarray2_methods_plain->map_row_major,
+                uarray2_methods_plain->map_col_major,
+                uarray2_methods_blocked->map_block_major
+        };
+        for (unsigned k = 0; k < sizeof(shapes) / sizeof(shapes[0]); k++) {
+                for (unsigned r = 0;
+                     r < sizeof(rotations) / sizeof(rotations[0]); r++) {
+                        for (unsigned f = 0;
+                             f < sizeof(flips) / sizeof(flips[0]); f++) {
+                                int quarter = (rotations[r] == 90 ||
+                                               rotations[r] == 270);
+                                int width = shapes[k][quarter];
+                                int height = shapes[k][!quarter];
+                                for (int s = 0; s < 3; s++) {
+                                        A2Methods_T under = suites[s];
+                                        Pnm_ppm ppm = new_sized_image(
+                                                under, shapes[k][0],
+                                                shapes[k][1]);
+                                        A2 result = under->new_with_blocksize(
+                                                width, height,
+                                                sizeof(struct Pnm_rgb), BS);
+                                        alterImage(rotations[r], flips[f],
+                                                   ppm, maps[s], result);
+                                        assert(under->width(result) == width);
+                                        assert(under->height(result) ==
+                                               height);
+                                        alterImageThreaded(
+                                                rotations[r], flips[f], ppm,
+                                                maps[s], result, 4);
+                                        assert(under->width(result) == width);
+                                        assert(under->height(result) ==
+                                               height);
+                                        under->free(&result);
+                                        Pnm_ppmfree(&ppm);
+                                }
+                        }
+                }
+        }
+}
+
+/* the sample at (i, j) of the test graymap; the test bitmap's pixel there
+ * is its low bit */
+static unsigned char test_sample(int i, int j)
+{
+        return (unsigned char)(7 * i + 3 * j + i * j);
+}
+
+/* a view of the test graymap, read by PNMGray_read */
+static void check_graymap(int rotation, const char *flip)
+{
+        FILE *fp = tmpfile();
+        assert(fp != NULL);
+        fprintf(fp, "P5\n%d %d\n255\n", W, H);
+        for (int j = 0; j < H; j++) {
+                for (int i = 0; i < W; i++) {
+                        putc(test_sample(i, j), fp);
+                }
+        }
+        rewind(fp);
+        Pnm_ppm gray = PNMGray_read(fp, uarray2_methods_plain);
+        fclose(fp);
+
+        A2 view = A2View_new(gray->methods, gray->pixels, rotation, flip);
+        for (int j = 0; j < a2view_methods->height(view); j++) {
+                for (int i = 0; i < a2view_methods->width(view); i++) {
+                        int si, sj;
+                        rotated_source(rotation, flip, i, j, &si, &sj);
+                        unsigned char *got = a2view_methods->at(view, i, j);
+                        assert(*got == test_sample(si, sj));
+                }
+        }
+        a2view_methods->free(&view);
+        Pnm_ppmfree(&gray);
+}
+
+/* the test bitmap transformed by PNMGray_transformBitmap, as written */
+static void check_bitmap(int rotation, const char *flip)
+{
+        FILE *fp = tmpfile();
+        assert(fp != NULL);
+        fprintf(fp, "P4\n%d %d\n", W, H);
+        for (int j = 0; j < H; j++) {
+                for (int i = 0; i < W; i += 8) {
+                        int bits = 0;
+                        for (int k = 0; k < 8; k++) {
+                                int bit = i + k < W &&
+                                          (test_sample(i + k, j) & 1);
+                                bits = bits << 1 | bit;
+                        }
+                        putc(bits, fp);
+                }
+        }
+        rewind(fp);
+        PNMGray_Bitmap bitmap = PNMGray_readBitmap(fp);
+        fclose(fp);
+        PNMGray_Bitmap turned = PNMGray_transformBitmap(bitmap, rotation,
+                                                        flip);
+
+        fp = tmpfile();
+        assert(fp != NULL);
+        PNMGray_writeBitmap(fp, turned);
+        rewind(fp);
+        int quarter = (rotation == 90 || rotation == 270);
+        int width, height;
+        assert(fscanf(fp, "P4 %d %d", &width, &height) == 2);
+        assert(width == (quarter ? H : W) && height == (quarter ? W : H));
+        getc(fp);
+        for (int j = 0; j < height; j++) {
+                int bits = 0;
+                for (int i = 0; i < width; i++) {
+                        if (i % 8 == 0) {
+                                bits = getc(fp);
+                        }
+                        int si, sj;
+                        rotated_source(rotation, flip, i, j, &si, &sj);
+                        assert((bits >> (7 - i % 8) & 1) ==
+                               (test_sample(si, sj) & 1));
+                }
+        }
+        fclose(fp);
+        PNMGray_freeBitmap(&bitmap);
+        PNMGray_freeBitmap(&turned);
+}
+
+/* graymaps and bitmaps rotate and then flip, as color images do */
+static void test_gray_rotate_then_flip(void)
+{
+        for (unsigned r = 0; r < sizeof(rotations) / sizeof(rotations[0]);
+             r++) {
+                for (unsigned f = 0; f < sizeof(flips) / sizeof(flips[0]);
+                     f++) {
+                        check_graymap(rotations[r], flips[f]);
+                        check_bitmap(rotations[r], flips[f]);
+                }
+        }
+}
+
+/* the planes of the test image, split by Planar_read and transformed by
+ * Planar_transform on nthreads threads */
+static void check_planar(int rotation, const char *flip, int nthreads)
+{
+        FILE *fp = tmpfile();
+        assert(fp != NULL);
+        Pnm_ppm ppm = new_test_image(uarray2_methods_plain);
+        Pnm_ppmwrite(fp, ppm);
+        Pnm_ppmfree(&ppm);
+        fflush(fp);
+        rewind(fp);
+        Planar_T planar = Planar_read(fp, uarray2_methods_blocked);
+        fclose(fp);
+        Planar_T turned = Planar_transform(planar, rotation, flip, nthreads);
+
+        A2Methods_T under = uarray2_methods_blocked;
+        A2 red = Planar_plane(turned, PLANAR_RED);
+        A2 green = Planar_plane(turned, PLANAR_GREEN);
+        A2 blue = Planar_plane(turned, PLANAR_BLUE);
+        for (int j = 0; j < (int)Planar_height(turned); j++) {
+                for (int i = 0; i < (int)Planar_width(turned); i++) {
+                        int si, sj;
+                        rotated_source(rotation, flip, i, j, &si, &sj);
+                        struct Pnm_rgb want = test_pixel(si, sj);
+                        assert(*(unsigned char *)under->at(red, i, j) ==
+                               want.red);
+                        assert(*(unsigned char *)under->at(green, i, j) ==
+                               want.green);
+                        assert(*(unsigned char *)under->at(blue, i, j) ==
+                               want.blue);
+                }
+        }
+        Planar_free(&planar);
+        Planar_free(&turned);
+}
+
+/* a planar image rotates and then flips, as one array of pixels does */
+static void test_planar_rotate_then_flip(void)
+{
+        for (unsigned r = 0; r < sizeof(rotations) / sizeof(rotations[0]);
+             r++) {
+                for (unsigned f = 0; f < sizeof(flips) / sizeof(flips[0]);
+                     f++) {
+                        check_planar(rotations[r], flips[f], 1);
+                        check_planar(rotations[r], flips[f], 3);
+                }
+        }
+}
+
+/* an image rotated by an angle that is not a multiple of 90 */
+static A2 any_angle(A2Methods_T under, double degrees, const char *flip,
+                    AnyAngle_Filter filter, int nthreads)
+{
+        Pnm_ppm ppm = new_sized_image(under, 300, 200);
+        A2 rotated = AnyAngle_new(degrees, ppm);
+        AnyAngle_rotate(degrees, flip, filter, ppm, rotated, nthreads);
+        Pnm_ppmfree(&ppm);
+        return rotated;
+}
+
+/* any angle gives the same pixels whatever the layout, tile size and
+ * number of threads: each source position is rounded alike */
+static void test_any_angle_layouts(void)
+{
+        const double angles[] = { 45, 30, -17.5, 123 };
+        for (unsigned a = 0; a < sizeof(angles) / sizeof(angles[0]); a++) {
+                for (int filter = ANYANGLE_NEAREST;
+                     filter <= ANYANGLE_BILINEAR; filter++) {
+                        A2 want = any_angle(uarray2_methods_plain, angles[a],
+                                            "vertical", filter, 1);
+                        A2 got[4];
+                        got[0] = any_angle(uarray2_methods_blocked,
+                                           angles[a], "vertical", filter, 1);
+                        got[1] = any_angle(uarray2_methods_blocked,
+                                           angles[a], "vertical", filter, 3);
+                        a2plain_set_tile_size(7);
+                        got[2] = any_angle(uarray2_methods_plain, angles[a],
+                                           "vertical", filter, 1);
+                        got[3] = any_angle(uarray2_methods_plain, angles[a],
+                                           "vertical", filter, 2);
+                        a2plain_set_tile_size(0);
+
+                        A2Methods_T plain = uarray2_methods_plain;
+                        for (int g = 0; g < 4; g++) {
+                                A2Methods_T under = g < 2
+                                        ? uarray2_methods_blocked : plain;
+                                for (int j = 0; j < plain->height(want);
+                                     j++) {
+                                        for (int i = 0;
+                                             i < plain->width(want); i++) {
+                                                Pnm_rgb p = plain->at(want,
+                                                                      i, j);
+                                                Pnm_rgb q = under->at(got[g],
+                                                                      i, j);
+                                                assert(p->red == q->red &&
+                                                       p->green == q->green &&
+                                                       p->blue == q->blue);
+                                        }
+                                }
+                                under->free(&got[g]);
+                        }
+                        plain->free(&want);
+                }
+        }
+}
+
+/* rotated, of under, rotated by 45 degrees from the empty image ppm on
+ * nthreads threads, must be all black, whatever it held before */
+static void check_any_angle_black(A2Methods_T under, Pnm_ppm ppm, A2 rotated,
+                                  AnyAngle_Filter filter, int nthreads)
+{
+        int width = under->width(rotated);
+        int height = under->height(rotated);
+        for (int j = 0; j < height; j++) {
+                for (int i = 0; i < width; i++) {
+                        *(Pnm_rgb)under->at(rotated, i, j) =
+                                test_pixel(i + 1, j);
+                }
+        }
+        AnyAngle_rotate(45, "none", filter, ppm, rotated, nthreads);
+        for (int j = 0; j < height; j++) {
+                for (int i = 0; i < width; i++) {
+                        Pnm_rgb p = under->at(rotated, i, j);
+                        assert(p->red == 0 && p->green == 0 && p->blue == 0);
+                }
+        }
+}
+
+/* an image with no rows or no columns turns to an image of black, on
+ * one thread or several, in either layout */
+static void test_any_angle_empty(void)
+{
+        static const int shapes[][2] = { { 5, 0 }, { 0, 5 } };
+        A2Methods_T suites[] = { uarray2_methods_plain,
+                                 uarray2_methods_blocked };
+        for (unsigned k = 0; k < sizeof(shapes) / sizeof(shapes[0]); k++) {
+                for (int s = 0; s < 2; s++) {
+                        Pnm_ppm ppm = new_sized_image(suites[s], shapes[k][0],
+                                                      shapes[k][1]);
+                        A2 rotated = AnyAngle_new(45, ppm);
+                        for (int filter = ANYANGLE_NEAREST;
+                             filter <= ANYANGLE_BILINEAR; filter++) {
+                                check_any_angle_black(suites[s], ppm, rotated,
+                                                      filter, 1);
+                                check_any_angle_black(suites[s], ppm, rotated,
+                                                      filter, 8);
+                        }
+                        suites[s]->free(&rotated);
+                        Pnm_ppmfree(&ppm);
+                }
+        }
+}
+
+/* where check_superblocks is in its walk of a two-level array */
+struct Walk {
+        int super;              /* the superblock of the last cell */
+        char *last;             /* the address of the last cell */
+        int visits[W][H];
+};
+
+static void check_superblocks(int i, int j, UArray2b_T array2b, void *elem,
+                              void *cl)
+{
+        struct Walk *walk = cl;
+        int side = UArray2b_blocksize(array2b) *
+                   UArray2b_superblock(array2b);
+        int across = (W + side - 1) / side;
+        int super = (j / side) * across + i / side;
+
+        /* superblocks one at a time, in order, and each one's blocks in
+         * increasing addresses: they are one run of memory */
+        assert(super >= walk->super);
+        if (super == walk->super) {
+                assert((char *)elem > walk->last);
+        }
+        assert(elem == UArray2b_at(array2b, i, j));
+        walk->super = super;
+        walk->last = elem;
+        walk->visits[i][j]++;
+}
+
+/* the order UArray2b_map visits a two-level array in, for the suite's
+ * maps to follow */
+struct Visits {
+        int n, next;
+        int *cols, *rows;
+};
+
+static void record_visit(int i, int j, UArray2b_T array2b, void *elem,
+                         void *cl)
+{
+        (void) array2b;
+        (void) elem;
+        struct Visits *visits = cl;
+        visits->cols[visits->n] = i;
+        visits->rows[visits->n] = j;
+        visits->n++;
+}
+
+static void check_visit(int i, int j, A2 array2, void *elem, void *cl)
+{
+        struct Visits *visits = cl;
+        assert(visits->next < visits->n);
+        assert(i == visits->cols[visits->next] &&
+               j == visits->rows[visits->next]);
+        assert(elem == uarray2_methods_blocked->at(array2, i, j));
+        visits->next++;
+}
+
+static void check_visit_span(int i, int j, int n, A2 array2,
+                             A2Methods_Object *ptr, void *cl)
+{
+        for (int k = 0; k < n; k++) {
+                check_visit(i + k, j, array2, (char *)ptr + k * sizeof(int),
+                            cl);
+        }
+}
+
+/* the blocked suite's new() with a2blocked_set_cache_sized makes the
+ * array UArray2b_new_cache_sized does, and its block-major maps and span
+ * maps visit it in UArray2b_map's order, superblock by superblock */
+static void test_cache_sized_suite(void)
+{
+        const int width = 700, height = 500;
+        UArray2b_T expected = UArray2b_new_cache_sized(width, height,
+                                                       sizeof(int));
+        a2blocked_set_cache_sized(1);
+        A2 array = uarray2_methods_blocked->new(width, height, sizeof(int));
+        a2blocked_set_cache_sized(0);
+        assert(UArray2b_blocksize(array) == UArray2b_blocksize(expected));
+        assert(UArray2b_superblock(array) == UArray2b_superblock(expected));
+        UArray2b_free(&expected);
+
+        struct Visits visits = { 0, 0, NULL, NULL };
+        visits.cols = CALLOC(width * height, sizeof(int));
+        visits.rows = CALLOC(width * height, sizeof(int));
+        UArray2b_map(array, record_visit, &visits);
+        assert(visits.n == width * height);
+        uarray2_methods_blocked->map_block_major(array, check_visit,
+                                                 &visits);
+        assert(visits.next == visits.n);
+        visits.next = 0;
+        uarray2_methods_blocked->span_map_block_major(array,
+                                                      check_visit_span,
+                                                      &visits);
+        assert(visits.next == visits.n);
+        FREE(visits.cols);
+        FREE(visits.rows);
+        uarray2_methods_blocked->free(&array);
+}
+
+/* UArray2b_map over superblocks of 2 x 2 blocks, and a cache-sized array */
+static void test_two_level(void)
+{
+        UArray2b_T array2b = UArray2b_new_two_level(W, H, sizeof(int), 2, 2);
+        assert(UArray2b_blocksize(array2b) == 2);
+        assert(UArray2b_superblock(array2b) == 2);
+        struct Walk walk = { -1, NULL, { { 0 } } };
+        UArray2b_map(array2b, check_superblocks, &walk);
+        for (int i = 0; i < W; i++) {
+                for (int j = 0; j < H; j++) {
+                        assert(walk.visits[i][j] == 1);
+                }
+        }
+        UArray2b_free(&array2b);
+
+        array2b = UArray2b_new_cache_sized(W, H, sizeof(int));
+        assert(UArray2b_blocksize(array2b) >= 1);
+        assert(UArray2b_superblock(array2b) >= 1);
+        UArray2b_free(&array2b);
+
+        test_cache_sized_suite();
+}
+
 int main(int argc, char *argv[])
 {
         assert(argc == 1);
         (void)argv;
         test_methods(uarray2_methods_plain);
-        /*  test_methods(uarray2_methods_blocked); */
+        test_methods(uarray2_methods_blocked);
+        test_spans(uarray2_methods_plain);
+        test_spans(uarray2_methods_blocked);
+        test_copies(uarray2_methods_plain);
+        test_copies(uarray2_methods_blocked);
+        test_two_level();
+        test_rotate_then_flip();
+        test_empty_images();
+        test_gray_rotate_then_flip();
+        test_planar_rotate_then_flip();
+        test_any_angle_layouts();
+        test_any_angle_empty();
+        test_convert(BS, 1);
+        test_convert(BS, 3);
+        test_convert(0, 2);
+        test_methods(a2view_methods);
+        test_spans(a2view_methods);
+        test_views(uarray2_methods_plain);
+        test_views(uarray2_methods_blocked);
         printf("Passed.\n");  /* only if we reach this point without
                                * assertion failure
                                */
@@ -0,0 +1,320 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** a2trace.c
+ ** 18 October 2026
+ **
+ ** Purpose: the tracing A2Methods suite. A methods suite has no room for
+ **          state of its own, so the wrapped suite, the simulator and the
+ **          layout model are file-level state, and tracing is single
+ **          threaded.
+ **
+ **          For a modelled layout every array gets its own base address,
+ **          one page past the end of the array before it, as consecutive
+ **          allocations would.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "assert.h"
+#include "a2methods.h"
+#include "cachesim.h"
+#include "a2trace.h"
+
+typedef A2Methods_UArray2 A2;
+
+#define PAGE 4096
+#define FIRST_BASE (1 << 20)
+#define MAXARRAYS 8
+
+enum Model { MODEL_ACTUAL, MODEL_ROW, MODEL_COL, MODEL_BLOCKED,
+             MODEL_MORTON, MODEL_PADDED };
+
+/* an array seen while tracing, and where the model puts it */
+struct Placed {
+    A2 array;
+    uintptr_t base;
+};
+
+static struct A2Methods_T traced;
+static A2Methods_T inner = NULL;
+static CacheSim_T sim = NULL;
+static int tracing = 0;
+static enum Model model = MODEL_ACTUAL;
+static int modelParameter = 0;      /* block size or padding */
+static struct Placed placed[MAXARRAYS];
+static int nplaced = 0;
+static uintptr_t nextBase = FIRST_BASE;
+
+/* @function: interleave
+ * @purpose: spread the bits of x out to the even bit positions
+ */
+static uint64_t interleave(uint32_t x)
+{
+    uint64_t v = x;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8))  & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2))  & 0x3333333333333333ULL;
+    v = (v | (v << 1))  & 0x5555555555555555ULL;
+    return v;
+}
+
+/* @function: modelIndex
+ * @purpose: the element index of (col, row) in the modelled layout of a
+ *           width x height array
+ */
+static uint64_t modelIndex(int col, int row, int width, int height)
+{
+    uint64_t bs = modelParameter;
+    switch (model) {
+        case MODEL_COL:
+            return (uint64_t)col * height + row;
+        case MODEL_BLOCKED: {
+            uint64_t blocksWide = (width + bs - 1) / bs;
+            uint64_t block = (row / bs) * blocksWide + col / bs;
+            return block * bs * bs + (row % bs) * bs + col % bs;
+        }
+        case MODEL_MORTON:
+            return interleave(col) | (interleave(row) << 1);
+        case MODEL_PADDED:
+            return (uint64_t)row * (width + modelParameter) + col;
+        default:
+            return (uint64_t)row * width + col;
+    }
+}
+
+/* @function: modelBytes
+ * @purpose: how much address space the modelled layout of an array needs
+ */
+static uint64_t modelBytes(A2 array)
+{
+    int width = inner->width(array);
+    int height = inner->height(array);
+    uint64_t elements;
+    if (model == MODEL_BLOCKED) {   /* edge blocks are whole blocks */
+        uint64_t bs = modelParameter;
+        elements = ((width + bs - 1) / bs) * ((height + bs - 1) / bs) *
+                   bs * bs;
+    } else {
+        elements = modelIndex(width - 1, height - 1, width, height) + 1;
+    }
+    return elements * inner->size(array);
+}
+
+/* @function: baseOf
+ * @purpose: the modelled base address of array, placing it if new
+ */
+static uintptr_t baseOf(A2 array)
+{
+    for (int i = 0; i < nplaced; i++) {
+        if (placed[i].array == array) {
+            return placed[i].base;
+        }
+    }
+    if (nplaced == MAXARRAYS) {     /* forget the oldest */
+        memmove(&placed[0], &placed[1],
+                (MAXARRAYS - 1) * sizeof(struct Placed));
+        nplaced--;
+    }
+    placed[nplaced].array = array;
+    placed[nplaced].base = nextBase;
+    nextBase += (modelBytes(array) + PAGE - 1) / PAGE * PAGE + PAGE;
+    return placed[nplaced++].base;
+}
+
+/* @function: record
+ * @purpose: send one element access to the simulator
+ */
+static void record(A2 array, int col, int row, A2Methods_Object *ptr,
+                   CacheSim_Stream stream)
+{
+    int size = inner->size(array);
+    uintptr_t address = (uintptr_t)ptr;
+    if (model != MODEL_ACTUAL) {
+        address = baseOf(array) +
+                  modelIndex(col, row, inner->width(array),
+                             inner->height(array)) * size;
+    }
+    CacheSim_access(sim, address, size, stream);
+}
+
+/********** the tracing suite **********/
+
+static void tracedFree(A2 *array2p)
+{
+    /* a later array may get the same pointer */
+    for (int i = 0; i < nplaced; i++) {
+        if (placed[i].array == *array2p) {
+            placed[i] = placed[--nplaced];
+            break;
+        }
+    }
+    inner->free(array2p);
+}
+
+static A2Methods_Object *tracedAt(A2 array2, int col, int row)
+{
+    A2Methods_Object *ptr = inner->at(array2, col, row);
+    if (tracing) {
+        record(array2, col, row, ptr, CACHESIM_SOURCE);
+    }
+    return ptr;
+}
+
+/* closure for the apply function given to the inner map */
+struct Apply {
+    A2Methods_applyfun *apply;
+    void *cl;
+};
+
+static void tracedApply(int col, int row, A2 array2, A2Methods_Object *ptr,
+                        void *vcl)
+{
+    struct Apply *closure = vcl;
+    closure->apply(col, row, array2, ptr, closure->cl);
+    if (tracing) {
+        record(array2, col, row, ptr, CACHESIM_DEST);
+    }
+}
+
+#define TRACED_MAP(NAME, MAP)                                           \
+static void NAME(A2 array2, A2Methods_applyfun apply, void *cl)         \
+{                                                                       \
+    struct Apply closure = { apply, cl };                               \
+    (MAP)(array2, tracedApply, &closure);                               \
+}
+
+TRACED_MAP(tracedRowMajor, inner->map_row_major)
+TRACED_MAP(tracedColMajor, inner->map_col_major)
+TRACED_MAP(tracedBlockMajor, inner->map_block_major)
+TRACED_MAP(tracedDefault, inner->map_default)
+
+/* any other map of the inner suite's arrays, such as a tiled one */
+static A2Methods_mapfun *otherMap = NULL;
+TRACED_MAP(tracedOther, otherMap == NULL ? inner->map_default : otherMap)
+
+#undef TRACED_MAP
+
+/* closure for the span function given to the inner span map */
+struct SpanApply {
+    A2Methods_spanfun *apply;
+    void *cl;
+};
+
+static void tracedSpan(int col, int row, int n, A2 array2,
+                       A2Methods_Object *ptr, void *vcl)
+{
+    struct SpanApply *closure = vcl;
+    closure->apply(col, row, n, array2, ptr, closure->cl);
+    if (tracing) {
+        int size = inner->size(array2);
+        for (int k = 0; k < n; k++) {
+            record(array2, col + k, row, (char *)ptr + k * size,
+                   CACHESIM_DEST);
+        }
+    }
+}
+
+#define TRACED_SPAN_MAP(NAME, FIELD)                                    \
+static void NAME(A2 array2, A2Methods_spanfun apply, void *cl)          \
+{                                                                       \
+    struct SpanApply closure = { apply, cl };                           \
+    inner->FIELD(array2, tracedSpan, &closure);                         \
+}
+
+TRACED_SPAN_MAP(tracedSpanRowMajor, span_map_row_major)
+TRACED_SPAN_MAP(tracedSpanBlockMajor, span_map_block_major)
+TRACED_SPAN_MAP(tracedSpanDefault, span_map_default)
+
+#undef TRACED_SPAN_MAP
+
+/* @function: parseModel
+ * @purpose: set the layout model from its name
+ *
+ * @returns: 0, or -1 if malformed
+ */
+static int parseModel(const char *layout)
+{
+    char *end;
+    modelParameter = 0;
+    if (strcmp(layout, "actual") == 0) {
+        model = MODEL_ACTUAL;
+    } else if (strcmp(layout, "row") == 0) {
+        model = MODEL_ROW;
+    } else if (strcmp(layout, "col") == 0) {
+        model = MODEL_COL;
+    } else if (strcmp(layout, "morton") == 0) {
+        model = MODEL_MORTON;
+    } else if (strncmp(layout, "blocked:", 8) == 0) {
+        model = MODEL_BLOCKED;
+        modelParameter = strtol(layout + 8, &end, 10);
+        return (*end == '\0' && modelParameter > 0) ? 0 : -1;
+    } else if (strncmp(layout, "padded:", 7) == 0) {
+        model = MODEL_PADDED;
+        modelParameter = strtol(layout + 7, &end, 10);
+        return (*end == '\0' && modelParameter >= 0) ? 0 : -1;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+extern A2Methods_T A2Trace_wrap(A2Methods_T wrapped, CacheSim_T simulator,
+                                const char *layout)
+{
+    assert(wrapped != NULL && simulator != NULL && layout != NULL);
+    if (parseModel(layout) != 0) {
+        return NULL;
+    }
+    inner = wrapped;
+    sim = simulator;
+    tracing = 0;
+    otherMap = NULL;
+    nplaced = 0;
+    nextBase = FIRST_BASE;
+
+    traced = *wrapped;
+    traced.free = tracedFree;
+    traced.at = tracedAt;
+    traced.map_row_major = wrapped->map_row_major ? tracedRowMajor : NULL;
+    traced.map_col_major = wrapped->map_col_major ? tracedColMajor : NULL;
+    traced.map_block_major = wrapped->map_block_major ? tracedBlockMajor
+                                                      : NULL;
+    traced.map_default = wrapped->map_default ? tracedDefault : NULL;
+    traced.span_map_row_major = wrapped->span_map_row_major
+                                ? tracedSpanRowMajor : NULL;
+    traced.span_map_block_major = wrapped->span_map_block_major
+                                  ? tracedSpanBlockMajor : NULL;
+    traced.span_map_default = wrapped->span_map_default ? tracedSpanDefault
+                                                        : NULL;
+    return &traced;
+}
+
+extern A2Methods_mapfun *A2Trace_map(A2Methods_mapfun *innerMap)
+{
+    assert(inner != NULL);
+    if (innerMap == inner->map_row_major) {
+        return traced.map_row_major;
+    } else if (innerMap == inner->map_col_major) {
+        return traced.map_col_major;
+    } else if (innerMap == inner->map_block_major) {
+        return traced.map_block_major;
+    } else if (innerMap == inner->map_default) {
+        return traced.map_default;
+    }
+    otherMap = innerMap;
+    return tracedOther;
+}
+
+extern void A2Trace_start(void)
+{
+    assert(inner != NULL);
+    tracing = 1;
+}
+
+extern void A2Trace_stop(void)
+{
+    tracing = 0;
+}
@@ -0,0 +1,56 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** a2trace.h
+ ** 18 October 2026
+ **
+ ** Purpose: public interface for a2trace.c, an A2Methods suite that wraps
+ **          another one and feeds the addresses a transform touches into
+ **          a cache simulator: every at() is a source read and every
+ **          element a map (or span map) hands to its apply function is a
+ **          destination write. The addresses can be the real ones, or the ones the
+ **          same elements would have in a layout that does not exist
+ **          here, so layouts can be compared before they are written.
+ **/
+
+#ifndef A2TRACE_INCLUDED
+#define A2TRACE_INCLUDED
+
+#include "a2methods.h"
+#include "cachesim.h"
+
+/* @function: A2Trace_wrap
+ * @purpose: make the tracing suite. There is one tracing suite per
+ *           program; wrapping again replaces it.
+ *
+ * @parameters: 1) A2Methods_T inner, the suite that does the work
+ *              2) CacheSim_T sim, where accesses go
+ *              3) const char *layout, how addresses are made:
+ *                 "actual"      the real addresses
+ *                 "row", "col"  row- or column-major, no padding
+ *                 "blocked:N"   N x N blocks, row-major within and between
+ *                 "morton"      Z-order (bit-interleaved) index
+ *                 "padded:N"    row-major with N elements of padding per
+ *                               row
+ * @returns: the tracing suite, or NULL if layout is malformed
+ *
+ * Note: the small maps are passed through untraced, since their apply
+ *       functions do not know where in the array an element is.
+ */
+extern A2Methods_T A2Trace_wrap(A2Methods_T inner, CacheSim_T sim,
+                                const char *layout);
+
+/* @function: A2Trace_map
+ * @purpose: return the tracing suite's version of one of inner's maps, or
+ *           of any other map of inner's arrays (such as
+ *           a2plain_map_tile_major); only one such map at a time
+ */
+extern A2Methods_mapfun *A2Trace_map(A2Methods_mapfun *innerMap);
+
+/* @function: A2Trace_start, A2Trace_stop
+ * @purpose: accesses are only fed to the simulator between these, so
+ *           reading and writing the image are left out
+ */
+extern void A2Trace_start(void);
+extern void A2Trace_stop(void);
+
+#endif /* A2TRACE_INCLUDED */
@@ -0,0 +1,413 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** a2view.c
+ ** 19 October 2026
+ **
+ ** Purpose: the views suite. Every rotation and flip, and any chain of
+ **          them, moves position (i, j) of the view to a position of the
+ **          array that is linear in i and j, with coefficients 0, 1 or
+ **          -1. A view keeps those coefficients, so at() is two
+ **          multiply-adds and a call to the array's own at().
+ **/
+
+#include <string.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2view.h"
+
+typedef A2Methods_UArray2 A2;
+
+/* position (i, j) of the view is (x0 + xc * i + xr * j,
+ * y0 + yc * i + yr * j) of the array under it */
+struct Map {
+    int x0, xc, xr;
+    int y0, yc, yr;
+};
+
+struct View {
+    A2Methods_T methods;        /* of the array under the view */
+    A2 array;
+    int owned;                  /* 1 if freeing the view frees array */
+    int width, height;
+    struct Map map;
+};
+
+/* @function: compose
+ * @purpose: the map that applies first, then second: a position of the
+ *           view goes through first to a position of an intermediate
+ *           image, which goes through second to the array
+ */
+static struct Map compose(struct Map first, struct Map second)
+{
+    struct Map m;
+    m.x0 = second.x0 + second.xc * first.x0 + second.xr * first.y0;
+    m.xc = second.xc * first.xc + second.xr * first.yc;
+    m.xr = second.xc * first.xr + second.xr * first.yr;
+    m.y0 = second.y0 + second.yc * first.x0 + second.yr * first.y0;
+    m.yc = second.yc * first.xc + second.yr * first.yc;
+    m.yr = second.yc * first.xr + second.yr * first.yr;
+    return m;
+}
+
+/* @function: transformMap
+ * @purpose: the map of rotating a w x h image and then flipping it, and
+ *           the size of the result
+ */
+static struct Map transformMap(int rotation, const char *flip, int w, int h,
+                               int *width, int *height)
+{
+    struct Map rotate = { 0, 1, 0, 0, 0, 1 };
+    int quarter = (rotation == 90 || rotation == 270);
+    int rw = quarter ? h : w, rh = quarter ? w : h;
+    switch (rotation) {
+        case 90: {                  /* from (j, h - 1 - i) */
+            struct Map m = { 0, 0, 1, h - 1, -1, 0 };
+            rotate = m;
+            break;
+        }
+        case 180: {                 /* from (w - 1 - i, h - 1 - j) */
+            struct Map m = { w - 1, -1, 0, h - 1, 0, -1 };
+            rotate = m;
+            break;
+        }
+        case 270: {                 /* from (w - 1 - j, i) */
+            struct Map m = { w - 1, 0, -1, 0, 1, 0 };
+            rotate = m;
+            break;
+        }
+        default:
+            assert(rotation == 0);
+    }
+
+    struct Map mirror = { 0, 1, 0, 0, 0, 1 };
+    if (strcmp(flip, "horizontal") == 0) {          /* rows swap */
+        struct Map m = { 0, 1, 0, rh - 1, 0, -1 };
+        mirror = m;
+    } else if (strcmp(flip, "vertical") == 0) {     /* columns swap */
+        struct Map m = { rw - 1, -1, 0, 0, 0, 1 };
+        mirror = m;
+    }
+    *width = rw;
+    *height = rh;
+    return compose(mirror, rotate);
+}
+
+/********** the views suite **********/
+
+static A2 viewNewWithBlocksize(int width, int height, int size,
+                               int blocksize)
+{
+    (void) blocksize;
+    A2Methods_T plain = uarray2_methods_plain;
+    struct View *view;
+    NEW(view);
+    view->methods = plain;
+    view->array = plain->new(width, height, size);
+    view->owned = 1;
+    view->width = width;
+    view->height = height;
+    struct Map identity = { 0, 1, 0, 0, 0, 1 };
+    view->map = identity;
+    return view;
+}
+
+static A2 viewNew(int width, int height, int size)
+{
+    return viewNewWithBlocksize(width, height, size, 1);
+}
+
+static void viewFree(A2 *array2p)
+{
+    assert(array2p != NULL && *array2p != NULL);
+    struct View *view = *array2p;
+    if (view->owned) {
+        view->methods->free(&view->array);
+    }
+    FREE(view);
+    *array2p = NULL;
+}
+
+static int viewWidth(A2 array2)
+{
+    struct View *view = array2;
+    return view->width;
+}
+
+static int viewHeight(A2 array2)
+{
+    struct View *view = array2;
+    return view->height;
+}
+
+static int viewSize(A2 array2)
+{
+    struct View *view = array2;
+    return view->methods->size(view->array);
+}
+
+static int viewBlocksize(A2 array2)
+{
+    (void) array2;
+    return 1;
+}
+
+/* copies go to the array under the view, which chose them for its size */
+static void viewCopy(A2 array2, A2Methods_Object *dst,
+                     const A2Methods_Object *src)
+{
+    struct View *view = array2;
+    view->methods->copy(view->array, dst, src);
+}
+
+static void viewCopySpan(A2 array2, A2Methods_Object *dst,
+                         const A2Methods_Object *src, int n, long step)
+{
+    struct View *view = array2;
+    view->methods->copy_span(view->array, dst, src, n, step);
+}
+
+static void viewSwap(A2 array2, A2Methods_Object *a, A2Methods_Object *b)
+{
+    struct View *view = array2;
+    view->methods->swap(view->array, a, b);
+}
+
+static A2Methods_Object *viewAt(A2 array2, int i, int j)
+{
+    struct View *view = array2;
+    assert(i >= 0 && i < view->width && j >= 0 && j < view->height);
+    const struct Map *m = &view->map;
+    return view->methods->at(view->array, m->x0 + m->xc * i + m->xr * j,
+                             m->y0 + m->yc * i + m->yr * j);
+}
+
+static void viewMapRowMajor(A2 array2, A2Methods_applyfun apply, void *cl)
+{
+    struct View *view = array2;
+    for (int j = 0; j < view->height; j++) {
+        for (int i = 0; i < view->width; i++) {
+            apply(i, j, array2, viewAt(array2, i, j), cl);
+        }
+    }
+}
+
+static void viewMapColMajor(A2 array2, A2Methods_applyfun apply, void *cl)
+{
+    struct View *view = array2;
+    for (int i = 0; i < view->width; i++) {
+        for (int j = 0; j < view->height; j++) {
+            apply(i, j, array2, viewAt(array2, i, j), cl);
+        }
+    }
+}
+
+/* closure for the apply function given to the array's own map */
+struct Apply {
+    struct View *view;
+    A2Methods_applyfun *apply;
+    void *cl;
+};
+
+/* @function: applyThrough
+ * @purpose: hand an element of the array to the view's apply function at
+ *           its position in the view. The map is a rotation and/or
+ *           reflection, so undoing it is its transpose.
+ */
+static void applyThrough(int x, int y, A2 array, A2Methods_Object *ptr,
+                         void *vcl)
+{
+    (void) array;
+    struct Apply *closure = vcl;
+    const struct Map *m = &closure->view->map;
+    int dx = x - m->x0, dy = y - m->y0;
+    closure->apply(m->xc * dx + m->yc * dy, m->xr * dx + m->yr * dy,
+                   closure->view, ptr, closure->cl);
+}
+
+/* the best order for a view is the best order for the array under it */
+static void viewMapDefault(A2 array2, A2Methods_applyfun apply, void *cl)
+{
+    struct View *view = array2;
+    struct Apply closure = { view, apply, cl };
+    view->methods->map_default(view->array, applyThrough, &closure);
+}
+
+static void viewSmallMapRowMajor(A2 array2, A2Methods_smallapplyfun apply,
+                                 void *cl)
+{
+    struct View *view = array2;
+    for (int j = 0; j < view->height; j++) {
+        for (int i = 0; i < view->width; i++) {
+            apply(viewAt(array2, i, j), cl);
+        }
+    }
+}
+
+static void viewSmallMapColMajor(A2 array2, A2Methods_smallapplyfun apply,
+                                 void *cl)
+{
+    struct View *view = array2;
+    for (int i = 0; i < view->width; i++) {
+        for (int j = 0; j < view->height; j++) {
+            apply(viewAt(array2, i, j), cl);
+        }
+    }
+}
+
+static void viewSmallMapDefault(A2 array2, A2Methods_smallapplyfun apply,
+                                void *cl)
+{
+    struct View *view = array2;
+    view->methods->small_map_default(view->array, apply, cl);
+}
+
+/* @function: viewSpanMap
+ * @purpose: the view's rows in order, each cut into the runs that are
+ *           next to each other in memory; a view that reverses or turns
+ *           the rows of its array has runs of one element
+ */
+static void viewSpanMap(A2 array2, A2Methods_spanfun apply, void *cl)
+{
+    struct View *view = array2;
+    int size = viewSize(array2);
+    for (int j = 0; j < view->height; j++) {
+        int i = 0;
+        while (i < view->width) {
+            char *first = viewAt(array2, i, j);
+            int n = 1;
+            while (i + n < view->width &&
+                   (char *)viewAt(array2, i + n, j) == first + n * size) {
+                n++;
+            }
+            apply(i, j, n, array2, first, cl);
+            i += n;
+        }
+    }
+}
+
+static struct A2Methods_T a2view_methods_struct = {
+    viewNew,
+    viewNewWithBlocksize,
+    viewFree,
+    viewWidth,
+    viewHeight,
+    viewSize,
+    viewBlocksize,
+    viewAt,
+    viewMapRowMajor,
+    viewMapColMajor,
+    NULL,                       /* map_block_major */
+    viewMapDefault,
+    viewSmallMapRowMajor,
+    viewSmallMapColMajor,
+    NULL,                       /* small_map_block_major */
+    viewSmallMapDefault,
+    viewSpanMap,                /* span_map_row_major */
+    NULL,                       /* span_map_block_major */
+    viewSpanMap,                /* span_map_default */
+    viewCopy,
+    viewCopySpan,
+    viewSwap
+};
+
+A2Methods_T a2view_methods = &a2view_methods_struct;
+
+extern A2 A2View_new(A2Methods_T methods, A2 array, int rotation,
+                     const char *flip)
+{
+    assert(methods != NULL && array != NULL && flip != NULL);
+    struct View *view;
+    NEW(view);
+    view->owned = 0;
+    view->map = transformMap(rotation, flip, methods->width(array),
+                             methods->height(array), &view->width,
+                             &view->height);
+    if (methods == a2view_methods) {    /* see through to the array */
+        struct View *under = array;
+        view->methods = under->methods;
+        view->array = under->array;
+        view->map = compose(view->map, under->map);
+    } else {
+        view->methods = methods;
+        view->array = array;
+    }
+    return view;
+}
+
+/* what copyRun needs to find the source of a run */
+struct Copy {
+    struct View *view;
+    char *base;                 /* UArray2: element (0, 0), else NULL */
+    long rowBytes;              /* UArray2: from one row to the next */
+    int size;
+};
+
+/* @function: copyRun
+ * @purpose: fill a run of the new array from the view, stepping through
+ *           the source one view column at a time
+ */
+static void copyRun(int i, int j, int n, A2 array2, A2Methods_Object *ptr,
+                    void *vcl)
+{
+    (void) array2;
+    struct Copy *copy = vcl;
+    const struct Map *m = &copy->view->map;
+    A2Methods_T under = copy->view->methods;
+    A2 source = copy->view->array;
+    char *out = ptr;
+    int size = copy->size;
+    if (copy->base == NULL) {
+        for (int k = 0; k < n; k++) {
+            under->copy(source, out + k * size,
+                        viewAt(copy->view, i + k, j));
+        }
+        return;
+    }
+    long x = m->x0 + (long)m->xc * i + (long)m->xr * j;
+    long y = m->y0 + (long)m->yc * i + (long)m->yr * j;
+    const char *in = copy->base + y * copy->rowBytes + x * size;
+    long step = m->yc * copy->rowBytes + (long)m->xc * size;
+    under->copy_span(source, out, in, n, step);
+}
+
+extern A2 A2View_materialize(A2 array2, A2Methods_T methods)
+{
+    assert(array2 != NULL && methods != NULL);
+    struct View *view = array2;
+    A2 result = methods->new(view->width, view->height, viewSize(array2));
+    A2View_fill(array2, methods, result);
+    return result;
+}
+
+extern void A2View_fill(A2 array2, A2Methods_T methods, A2 result)
+{
+    assert(array2 != NULL && methods != NULL && result != NULL);
+    struct View *view = array2;
+    int size = viewSize(array2);
+    assert(methods->width(result) == view->width);
+    assert(methods->height(result) == view->height);
+    assert(methods->size(result) == size);
+
+    struct Copy copy = { view, NULL, 0, size };
+    A2Methods_T under = view->methods;
+    if (under == uarray2_methods_plain && under->width(view->array) > 0 &&
+        under->height(view->array) > 0) {
+        copy.base = under->at(view->array, 0, 0);
+        copy.rowBytes = under->height(view->array) > 1
+                        ? (char *)under->at(view->array, 0, 1) - copy.base
+                        : 0;
+    }
+
+    if (methods->span_map_default != NULL) {
+        methods->span_map_default(result, copyRun, &copy);
+    } else {
+        for (int j = 0; j < view->height; j++) {
+            for (int i = 0; i < view->width; i++) {
+                copyRun(i, j, 1, result, methods->at(result, i, j), &copy);
+            }
+        }
+    }
+}
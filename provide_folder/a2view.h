@@ -0,0 +1,63 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** a2view.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for a2view.c, an A2Methods suite whose
+ **          arrays are views: an existing array seen rotated and/or
+ **          flipped, without copying it. at() and the maps turn each
+ **          position of the view into the position of the array under
+ **          it, so a view can be written out, transformed again or cropped
+ **          straight from the original pixels. A2View_materialize makes
+ **          a real array when one is wanted.
+ **/
+
+#ifndef A2VIEW_INCLUDED
+#define A2VIEW_INCLUDED
+
+#include "a2methods.h"
+
+/* the views suite. new() makes a view of a new UArray2, which the view
+ * owns; a view from A2View_new does not own the array it shows. A view
+ * has no blocks (blocksize is 1) and no block-major maps. */
+extern A2Methods_T a2view_methods;
+
+/* @function: A2View_new
+ * @purpose: make a view of array rotated by rotation degrees clockwise
+ *           and then flipped. A view of a view is a view of the array
+ *           under it, with the two transforms composed.
+ *
+ * @precondition: rotation is 0, 90, 180 or 270; array outlives the view
+ *
+ * @parameters: 1) A2Methods_T methods, the suite of array
+ *              2) A2Methods_UArray2 array, the array to show
+ *              3) int rotation, the degrees to rotate
+ *              4) const char *flip, "horizontal", "vertical" or anything
+ *                 else for no flip
+ * @returns: the view, for a2view_methods; freeing it leaves array alone
+ */
+extern A2Methods_UArray2 A2View_new(A2Methods_T methods,
+                                    A2Methods_UArray2 array, int rotation,
+                                    const char *flip);
+
+/* @function: A2View_materialize
+ * @purpose: copy what view shows into a new array of methods, a run of
+ *           the new array at a time; where the array under the view is a
+ *           UArray2 the source of each run is stepped through with
+ *           pointer arithmetic rather than at()
+ *
+ * @parameters: 1) A2Methods_UArray2 view, made by a2view_methods
+ *              2) A2Methods_T methods, the suite of the new array
+ * @returns: the new array, the size of the view
+ */
+extern A2Methods_UArray2 A2View_materialize(A2Methods_UArray2 view,
+                                            A2Methods_T methods);
+
+/* @function: A2View_fill
+ * @purpose: the copy A2View_materialize makes, into an existing array of
+ *           methods the size of the view
+ */
+extern void A2View_fill(A2Methods_UArray2 view, A2Methods_T methods,
+                        A2Methods_UArray2 array);
+
+#endif /* A2VIEW_INCLUDED */
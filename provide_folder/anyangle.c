@@ -0,0 +1,378 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** anyangle.c
+ ** 19 October 2026
+ **
+ ** Purpose: rotation by any angle. Destination (col, row) is mapped back
+ **          to a source position that is linear in col and row, so along
+ **          a row the position only moves by a fixed step per pixel.
+ **          UArray2 and UArray2b images are read and written through
+ **          their storage, as transloops.h does; any other methods suite
+ **          goes through at().
+ **/
+
+#include <math.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "assert.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+#include "pnm.h"
+#include "transloops.h"
+#include "anyangle.h"
+
+#define PI 3.14159265358979323846
+#define DEFAULT_TILE 32         /* for suites without storage access */
+#define MAX_TILE 256
+
+typedef A2Methods_UArray2 A2;
+
+/* the source position of destination (col, row) is
+ * (x0 + col * xc + row * xr, y0 + col * yc + row * yr) */
+struct Mapping {
+    double x0, xc, xr;
+    double y0, yc, yr;
+};
+
+/* an image, and how to get at its pixels */
+struct Image {
+    TransLoops_Image storage;   /* unused when direct is 0 */
+    int direct;                 /* 1 for UArray2 and UArray2b */
+    A2Methods_T methods;
+    A2 array;
+    int width, height;
+};
+
+/* one thread's share: rows [firstRow, lastRow) of the destination */
+struct Strip {
+    const struct Mapping *mapping;
+    const struct Image *src, *dst;
+    AnyAngle_Filter filter;
+    int tile;
+    int firstRow, lastRow;
+};
+
+/* @function: boundingBox
+ * @purpose: the size of a w x h image rotated by radians
+ */
+static void boundingBox(double radians, int w, int h, int *rw, int *rh)
+{
+    double c = fabs(cos(radians)), s = fabs(sin(radians));
+    /* allow for rounding in cos and sin near the axes */
+    *rw = (int)ceil(w * c + h * s - 1e-6);
+    *rh = (int)ceil(w * s + h * c - 1e-6);
+    if (w > 0 && h > 0) {
+        *rw = *rw > 0 ? *rw : 1;
+        *rh = *rh > 0 ? *rh : 1;
+    }
+}
+
+extern A2 AnyAngle_new(double degrees, Pnm_ppm ppm)
+{
+    assert(ppm != NULL);
+    int w, h;
+    boundingBox(degrees * PI / 180, ppm->width, ppm->height, &w, &h);
+    return ppm->methods->new(w, h, sizeof(struct Pnm_rgb));
+}
+
+/* @function: findImage
+ * @purpose: fill in an Image, finding its storage where it can be
+ */
+static void findImage(struct Image *img, A2Methods_T methods, A2 array)
+{
+    img->methods = methods;
+    img->array = array;
+    img->width = methods->width(array);
+    img->height = methods->height(array);
+    img->direct = (methods == uarray2_methods_plain ||
+                   methods == uarray2_methods_blocked) &&
+                  img->width > 0 && img->height > 0;
+    if (img->direct) {
+        TransLoops_image(&img->storage, methods, array,
+                         methods == uarray2_methods_blocked);
+    }
+}
+
+/* @function: pixelAt
+ * @purpose: the pixel at (col, row), which must be in the image
+ */
+static inline Pnm_rgb pixelAt(const struct Image *img, int col, int row)
+{
+    if (!img->direct) {
+        return img->methods->at(img->array, col, row);
+    }
+    return TransLoops_at(&img->storage, col, row);
+}
+
+/* @function: nearest
+ * @purpose: the source pixel closest to (x, y), or black off the image
+ */
+static inline struct Pnm_rgb nearest(const struct Image *src, double x,
+                                     double y)
+{
+    struct Pnm_rgb black = { 0, 0, 0 };
+    int col = (int)floor(x + 0.5);
+    int row = (int)floor(y + 0.5);
+    if (col < 0 || row < 0 || col >= src->width || row >= src->height) {
+        return black;
+    }
+    return *pixelAt(src, col, row);
+}
+
+/* @function: bilinear
+ * @purpose: the four source pixels around (x, y), weighted by how close
+ *           they are; pixels off the edge are the edge pixels, and a
+ *           position more than half a pixel off the image is black
+ */
+static inline struct Pnm_rgb bilinear(const struct Image *src, double x,
+                                      double y)
+{
+    struct Pnm_rgb black = { 0, 0, 0 };
+    if (x < -0.5 || y < -0.5 || x > src->width - 0.5 ||
+        y > src->height - 0.5) {
+        return black;
+    }
+    int x0 = (int)floor(x), y0 = (int)floor(y);
+    double fx = x - x0, fy = y - y0;
+    int x1 = x0 + 1 < src->width ? x0 + 1 : src->width - 1;
+    int y1 = y0 + 1 < src->height ? y0 + 1 : src->height - 1;
+    x0 = x0 < 0 ? 0 : x0;
+    y0 = y0 < 0 ? 0 : y0;
+
+    Pnm_rgb p00 = pixelAt(src, x0, y0), p10 = pixelAt(src, x1, y0);
+    Pnm_rgb p01 = pixelAt(src, x0, y1), p11 = pixelAt(src, x1, y1);
+    double w00 = (1 - fx) * (1 - fy), w10 = fx * (1 - fy);
+    double w01 = (1 - fx) * fy, w11 = fx * fy;
+    struct Pnm_rgb out;
+    out.red = (unsigned)(w00 * p00->red + w10 * p10->red +
+                         w01 * p01->red + w11 * p11->red + 0.5);
+    out.green = (unsigned)(w00 * p00->green + w10 * p10->green +
+                           w01 * p01->green + w11 * p11->green + 0.5);
+    out.blue = (unsigned)(w00 * p00->blue + w10 * p10->blue +
+                          w01 * p01->blue + w11 * p11->blue + 0.5);
+    return out;
+}
+
+/* @function: rotateStrip
+ * @purpose: fill a strip of the destination, a tile at a time
+ */
+static void *rotateStrip(void *vstrip)
+{
+    struct Strip *strip = vstrip;
+    const struct Mapping *m = strip->mapping;
+    const struct Image *dst = strip->dst;
+    int t = strip->tile;
+    double xs[MAX_TILE], ys[MAX_TILE];
+
+    for (int top = strip->firstRow; top < strip->lastRow; top += t) {
+        int bottom = top + t < strip->lastRow ? top + t : strip->lastRow;
+        for (int left = 0; left < dst->width; left += t) {
+            int n = left + t < dst->width ? t : dst->width - left;
+            for (int row = top; row < bottom; row++) {
+                /* positions first: no branches, so this vectorizes. Each
+                 * is worked out from its own column and row, the same
+                 * sum whatever the tile, so every layout and thread
+                 * count rounds alike */
+                for (int k = 0; k < n; k++) {
+                    xs[k] = m->x0 + (left + k) * m->xc + row * m->xr;
+                    ys[k] = m->y0 + (left + k) * m->yc + row * m->yr;
+                }
+                /* a row of a tile is one run, even in a blocked array,
+                 * since there the tiles are the blocks */
+                Pnm_rgb out = dst->direct ? pixelAt(dst, left, row) : NULL;
+                for (int k = 0; k < n; k++) {
+                    struct Pnm_rgb pixel =
+                        strip->filter == ANYANGLE_NEAREST
+                            ? nearest(strip->src, xs[k], ys[k])
+                            : bilinear(strip->src, xs[k], ys[k]);
+                    if (out != NULL) {
+                        out[k] = pixel;
+                    } else {
+                        *pixelAt(dst, left + k, row) = pixel;
+                    }
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+/* @function: mappingFor
+ * @purpose: the source position of each destination pixel. The centre of
+ *           destination pixel (col, row), after undoing the flip, is
+ *           turned back about the centre of the destination onto the
+ *           source, centre to centre.
+ */
+static struct Mapping mappingFor(double degrees, const char *flip, int sw,
+                                 int sh, int dw, int dh)
+{
+    double radians = degrees * PI / 180;
+    double c = cos(radians), s = sin(radians);
+    /* unflipped col = colOrigin + colSign * col, and the same for rows */
+    int colSign = strcmp(flip, "vertical") == 0 ? -1 : 1;
+    int rowSign = strcmp(flip, "horizontal") == 0 ? -1 : 1;
+    double colOrigin = colSign < 0 ? dw - 1 : 0;
+    double rowOrigin = rowSign < 0 ? dh - 1 : 0;
+    double x = colOrigin + 0.5 - dw / 2.0;   /* of col 0, row 0 */
+    double y = rowOrigin + 0.5 - dh / 2.0;
+
+    struct Mapping m;
+    m.x0 = x * c + y * s + sw / 2.0 - 0.5;
+    m.xc = colSign * c;
+    m.xr = rowSign * s;
+    m.y0 = -x * s + y * c + sh / 2.0 - 0.5;
+    m.yc = -colSign * s;
+    m.yr = rowSign * c;
+    return m;
+}
+
+/* @function: wholeMapping
+ * @purpose: the mapping of a region from the whole rotated image onto
+ *           the whole source
+ */
+static struct Mapping wholeMapping(double degrees, const char *flip,
+                                   const AnyAngle_Region *region)
+{
+    int dw, dh;
+    boundingBox(degrees * PI / 180, region->width, region->height, &dw,
+                &dh);
+    return mappingFor(degrees, flip, region->width, region->height, dw, dh);
+}
+
+extern int AnyAngle_region(double degrees, const char *flip,
+                           AnyAngle_Region *region)
+{
+    assert(flip != NULL && region != NULL);
+    int dw, dh;
+    boundingBox(degrees * PI / 180, region->width, region->height, &dw,
+                &dh);
+    if (region->w <= 0 || region->h <= 0 || region->col < 0 ||
+        region->row < 0 || region->col + region->w > dw ||
+        region->row + region->h > dh || region->width <= 0 ||
+        region->height <= 0) {
+        return -1;
+    }
+
+    /* the mapping is linear, so the corners bound the positions */
+    struct Mapping m = wholeMapping(degrees, flip, region);
+    double xmin = HUGE_VAL, xmax = -HUGE_VAL;
+    double ymin = HUGE_VAL, ymax = -HUGE_VAL;
+    for (int corner = 0; corner < 4; corner++) {
+        int col = region->col + (corner & 1 ? region->w - 1 : 0);
+        int row = region->row + (corner & 2 ? region->h - 1 : 0);
+        double x = m.x0 + col * m.xc + row * m.xr;
+        double y = m.y0 + col * m.yc + row * m.yr;
+        xmin = x < xmin ? x : xmin;
+        xmax = x > xmax ? x : xmax;
+        ymin = y < ymin ? y : ymin;
+        ymax = y > ymax ? y : ymax;
+    }
+
+    /* nearest reaches floor(x + 0.5) and bilinear floor(x) + 1; a region
+     * wholly off the source keeps one edge pixel, which is still too far
+     * away to be sampled */
+    int left = (int)floor(xmin) - 1, right = (int)ceil(xmax) + 2;
+    int top = (int)floor(ymin) - 1, bottom = (int)ceil(ymax) + 2;
+    left = left < 0 ? 0 : (left < region->width ? left : region->width - 1);
+    top = top < 0 ? 0 : (top < region->height ? top : region->height - 1);
+    right = right > region->width ? region->width : right;
+    bottom = bottom > region->height ? region->height : bottom;
+    region->srcCol = left;
+    region->srcRow = top;
+    region->srcW = right > left ? right - left : 1;
+    region->srcH = bottom > top ? bottom - top : 1;
+    return 0;
+}
+
+extern void AnyAngle_rotate(double degrees, const char *flip,
+                            AnyAngle_Filter filter, Pnm_ppm ppm,
+                            A2 rotated, int nthreads)
+{
+    assert(ppm != NULL && rotated != NULL);
+    AnyAngle_Region whole = { ppm->width, ppm->height, 0, 0,
+                              ppm->methods->width(rotated),
+                              ppm->methods->height(rotated),
+                              0, 0, ppm->width, ppm->height };
+    AnyAngle_rotateRegion(degrees, flip, filter, &whole, ppm, rotated,
+                          nthreads);
+}
+
+extern void AnyAngle_rotateRegion(double degrees, const char *flip,
+                                  AnyAngle_Filter filter,
+                                  const AnyAngle_Region *region,
+                                  Pnm_ppm ppm, A2 rotated, int nthreads)
+{
+    assert(flip != NULL && region != NULL && ppm != NULL);
+    assert(rotated != NULL && nthreads > 0);
+    struct Image src, dst;
+    findImage(&src, ppm->methods, ppm->pixels);
+    findImage(&dst, ppm->methods, rotated);
+
+    /* an empty source has no pixels for the filters to read, even at its
+     * edge, so everything it covers is off the image */
+    if (src.width == 0 || src.height == 0) {
+        struct Pnm_rgb black = { 0, 0, 0 };
+        for (int row = 0; row < dst.height; row++) {
+            for (int col = 0; col < dst.width; col++) {
+                *pixelAt(&dst, col, row) = black;
+            }
+        }
+        if (dst.direct) {
+            TransLoops_free(&dst.storage);
+        }
+        return;
+    }
+
+    /* shift the whole mapping to start at the region's first pixel and
+     * to land in the source's rectangle */
+    struct Mapping m = wholeMapping(degrees, flip, region);
+    m.x0 += region->col * m.xc + region->row * m.xr - region->srcCol;
+    m.y0 += region->col * m.yc + region->row * m.yr - region->srcRow;
+
+    /* a tile must not cross a block */
+    int tile = DEFAULT_TILE;
+    if (ppm->methods == uarray2_methods_blocked) {
+        tile = ppm->methods->blocksize(rotated);
+    } else if (ppm->methods == uarray2_methods_plain) {
+        tile = a2plain_tile_size(rotated);
+        tile = tile < MAX_TILE ? tile : MAX_TILE;
+    }
+    assert(tile > 0 && tile <= MAX_TILE);
+
+    int units = (dst.height + tile - 1) / tile;
+    if (nthreads > units) {
+        nthreads = units > 0 ? units : 1;
+    }
+    struct Strip strips[nthreads];
+    pthread_t threads[nthreads];
+    for (int i = 0; i < nthreads; i++) {
+        strips[i].mapping = &m;
+        strips[i].src = &src;
+        strips[i].dst = &dst;
+        strips[i].filter = filter;
+        strips[i].tile = tile;
+        strips[i].firstRow = (units * i / nthreads) * tile;
+        strips[i].lastRow = (units * (i + 1) / nthreads) * tile;
+        if (strips[i].lastRow > dst.height) {
+            strips[i].lastRow = dst.height;
+        }
+    }
+
+    /* the calling thread takes the first strip itself */
+    for (int i = 1; i < nthreads; i++) {
+        pthread_create(&threads[i], NULL, rotateStrip, &strips[i]);
+    }
+    rotateStrip(&strips[0]);
+    for (int i = 1; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    if (src.direct) {
+        TransLoops_free(&src.storage);
+    }
+    if (dst.direct) {
+        TransLoops_free(&dst.storage);
+    }
+}
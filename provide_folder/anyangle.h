@@ -0,0 +1,91 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** anyangle.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for anyangle.c, which rotates an image by
+ **          any number of degrees clockwise, with an optional flip fused
+ **          into the same pass. The result is the bounding box of the
+ **          rotated image; the corners no source pixel lands on are
+ **          black.
+ **/
+
+#ifndef ANYANGLE_INCLUDED
+#define ANYANGLE_INCLUDED
+
+#include "a2methods.h"
+#include "pnm.h"
+
+/* how a destination pixel is sampled from the source */
+typedef enum AnyAngle_Filter {
+    ANYANGLE_NEAREST = 0,       /* the closest source pixel */
+    ANYANGLE_BILINEAR           /* the four closest, weighted by distance */
+} AnyAngle_Filter;
+
+/* a rectangle of the rotated image, and the rectangle of the source it
+ * is made from */
+typedef struct AnyAngle_Region {
+    int width, height;          /* the whole source */
+    int col, row, w, h;         /* wanted, in the whole rotated image */
+    int srcCol, srcRow;         /* needed, in the source: set by */
+    int srcW, srcH;             /* AnyAngle_region */
+} AnyAngle_Region;
+
+/* @function: AnyAngle_new
+ * @purpose: make the destination for rotating ppm by degrees: an array
+ *           of ppm->methods big enough for the rotated image
+ */
+extern A2Methods_UArray2 AnyAngle_new(double degrees, Pnm_ppm ppm);
+
+/* @function: AnyAngle_rotate
+ * @purpose: fill rotated, made by AnyAngle_new, with ppm rotated by
+ *           degrees clockwise about its centre and then flipped as the
+ *           exact transforms flip. The destination is walked tile by
+ *           tile (block by block for a blocked array); along each row of
+ *           a tile the source coordinates are computed from each pixel's
+ *           own column and row, in a loop the compiler can vectorize,
+ *           before the pixels are sampled, so the result is the same for
+ *           every layout, tile size and thread count.
+ *
+ * @parameters: 1) double degrees, clockwise
+ *              2) const char *flip, "horizontal", "vertical" or anything
+ *                 else for no flip
+ *              3) AnyAngle_Filter filter, how to sample
+ *              4) Pnm_ppm ppm, the source image
+ *              5) A2Methods_UArray2 rotated, the destination
+ *              6) int nthreads, > 0; threads take whole rows of tiles
+ * @returns: none
+ */
+extern void AnyAngle_rotate(double degrees, const char *flip,
+                            AnyAngle_Filter filter, Pnm_ppm ppm,
+                            A2Methods_UArray2 rotated, int nthreads);
+
+/* @function: AnyAngle_region
+ * @purpose: find the rectangle of the source that the wanted rectangle of
+ *           the rotated image samples, with a pixel to spare around it
+ *           for bilinear sampling, cut down to the source
+ *
+ * @parameters: 1) double degrees, const char *flip, as AnyAngle_rotate
+ *              2) AnyAngle_Region *region, with the source size and the
+ *                 wanted rectangle filled in
+ * @returns: 0, or -1 if the wanted rectangle is empty or not inside the
+ *           rotated image
+ */
+extern int AnyAngle_region(double degrees, const char *flip,
+                           AnyAngle_Region *region);
+
+/* @function: AnyAngle_rotateRegion
+ * @purpose: do the work of AnyAngle_rotate for just the wanted rectangle
+ *           of the rotated image
+ *
+ * @precondition: region was filled in by AnyAngle_region; ppm holds the
+ *                srcW x srcH rectangle of the source it names, and
+ *                rotated is w x h
+ */
+extern void AnyAngle_rotateRegion(double degrees, const char *flip,
+                                  AnyAngle_Filter filter,
+                                  const AnyAngle_Region *region,
+                                  Pnm_ppm ppm, A2Methods_UArray2 rotated,
+                                  int nthreads);
+
+#endif /* ANYANGLE_INCLUDED */
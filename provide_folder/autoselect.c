@@ -0,0 +1,258 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** autoselect.c
+ ** 19 October 2026
+ **
+ ** Purpose: the cost model behind ppmtrans -auto. The numbers are rough
+ **          (nanoseconds per cache line or TLB miss on a current desktop
+ **          part); only their order matters, since the model is used to
+ **          rank layouts, not to predict times. It agrees with what we
+ **          measured: row-major for 180 and the flips, a walk that keeps
+ **          the source column cached (tiles) for 90 and 270 once the
+ **          image no longer fits in the caches.
+ **/
+
+#include <string.h>
+#include <unistd.h>
+
+#include "assert.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+#include "autoselect.h"
+
+#define LINE 64
+#define PAGE 4096
+#define TLB_ENTRIES 64
+#define STLB_ENTRIES 1536
+#define BLOCK_BYTES 65536       /* as UArray2b_new_64K_block */
+#define MAX_THREADS 8
+
+#define DEFAULT_L1 (32L * 1024)
+#define DEFAULT_L2 (1024L * 1024)
+#define DEFAULT_L3 (32L * 1024 * 1024)
+
+enum Level { LEVEL_L1 = 0, LEVEL_L2, LEVEL_L3, LEVEL_MEMORY };
+
+/* ns to bring in a line from each level, when the prefetcher is ahead of
+ * us and when it is not */
+static const double streamed[] = { 0.0, 0.5, 1.5, 4.0 };
+static const double onDemand[] = { 0.0, 4.0, 15.0, 70.0 };
+
+#define STLB_HIT 1.5            /* ns, a miss in the first-level TLB */
+#define PAGE_WALK 20.0          /* ns, a miss in both TLBs */
+#define LOOP_PLAIN 0.5          /* ns per pixel of loop and copy */
+#define LOOP_BLOCKED 1.5        /* the same with a division per pixel */
+#define SHORT_RUNS 1.25         /* streams cut into tile-wide runs */
+#define FIRST_TOUCH 250.0       /* ns to fault in a fresh page */
+
+static const char *names[AUTOSELECT_NLAYOUTS] = {
+    "row-major", "col-major", "tile-major", "block-major"
+};
+
+struct Caches {
+    long l1, l2, l3;
+};
+
+/* @function: machineCaches
+ * @purpose: the data cache sizes, or typical ones where sysconf does not
+ *           know
+ */
+static struct Caches machineCaches(void)
+{
+    struct Caches c = { -1, -1, -1 };
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    c.l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    c.l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    c.l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+    c.l1 = c.l1 > 0 ? c.l1 : DEFAULT_L1;
+    c.l2 = c.l2 > 0 ? c.l2 : DEFAULT_L2;
+    c.l3 = c.l3 > 0 ? c.l3 : DEFAULT_L3;
+    return c;
+}
+
+/* @function: levelFor
+ * @purpose: the closest level that holds bytes
+ */
+static enum Level levelFor(double bytes, const struct Caches *c)
+{
+    if (bytes <= c->l1) {
+        return LEVEL_L1;
+    } else if (bytes <= c->l2) {
+        return LEVEL_L2;
+    } else if (bytes <= c->l3) {
+        return LEVEL_L3;
+    }
+    return LEVEL_MEMORY;
+}
+
+/* @function: sequential
+ * @purpose: ns per pixel for walking along rows of data kept at home
+ */
+static double sequential(int size, enum Level home)
+{
+    return (double)size / LINE * streamed[home];
+}
+
+/* @function: columnWalk
+ * @purpose: ns per pixel for walking down columns length elements long,
+ *           pitch bytes between rows, one column after the next. Each
+ *           line of a column is used again by the next column if the
+ *           column's lines (of both images) are still cached; otherwise
+ *           every pixel is a miss to wherever they are.
+ */
+static double columnWalk(int length, long pitch, int size, enum Level home,
+                         const struct Caches *c)
+{
+    double cost = sequential(size, home);
+    enum Level reuse = levelFor(2.0 * length * LINE, c);
+    if (reuse != LEVEL_L1) {
+        cost += onDemand[reuse < home ? reuse : home];
+    }
+    if (pitch >= PAGE) {            /* a page per element */
+        if (length > STLB_ENTRIES) {
+            cost += PAGE_WALK;
+        } else if (length > TLB_ENTRIES) {
+            cost += STLB_HIT;
+        }
+    }
+    return cost;
+}
+
+/* @function: tileFor
+ * @purpose: the tile a2plain_tile_size picks by default
+ */
+static int tileFor(int size, const struct Caches *c)
+{
+    long elements = c->l1 / (2 * size);
+    int tile = 1;
+    while ((long)(2 * tile) * (2 * tile) <= elements) {
+        tile *= 2;
+    }
+    return tile;
+}
+
+/* @function: passCost
+ * @purpose: ns per pixel for one pass writing a w x h destination, in
+ *           layout; quarter is set for 90 and 270, where the source is
+ *           read down its columns when the destination is written along
+ *           its rows
+ */
+static double passCost(AutoSelect_Layout layout, int quarter, int w, int h,
+                       int size, const struct Caches *c)
+{
+    enum Level home = levelFor(2.0 * w * h * size, c);
+    double seq = sequential(size, home);
+    long pitch = (long)w * size;            /* destination rows */
+    long srcPitch = (long)(quarter ? h : w) * size;
+
+    switch (layout) {
+        case AUTOSELECT_ROW:
+            return LOOP_PLAIN + seq + (quarter ? columnWalk(w, srcPitch,
+                                                            size, home, c)
+                                               : seq);
+        case AUTOSELECT_COL:
+            return LOOP_PLAIN + columnWalk(h, pitch, size, home, c) +
+                   (quarter ? seq : columnWalk(h, srcPitch, size, home, c));
+        case AUTOSELECT_TILE: {
+            int t = tileFor(size, c);
+            return LOOP_PLAIN + SHORT_RUNS * seq +
+                   SHORT_RUNS * (quarter ? columnWalk(t, srcPitch, size,
+                                                      home, c)
+                                         : seq);
+        }
+        case AUTOSELECT_BLOCK: {
+            int bs = 1;
+            while ((long)(bs + 1) * (bs + 1) * size <= BLOCK_BYTES) {
+                bs++;
+            }
+            return LOOP_BLOCKED + seq +
+                   (quarter ? columnWalk(bs, (long)bs * size, size, home, c)
+                            : seq);
+        }
+        default:
+            assert(0);
+            return 0;
+    }
+}
+
+/* @function: conversionCost
+ * @purpose: ns per pixel for the blocked layout's copies in and out: each
+ *           reads one image, writes a fresh one
+ */
+static double conversionCost(int w, int h, int size, const struct Caches *c)
+{
+    enum Level home = levelFor(2.0 * w * h * size, c);
+    return 2 * (2 * sequential(size, home) + size * FIRST_TOUCH / PAGE);
+}
+
+extern AutoSelect_Choice AutoSelect_choose(int rotation, const char *flip,
+                                           int width, int height, int size)
+{
+    assert(rotation == 0 || rotation == 90 || rotation == 180 ||
+           rotation == 270);
+    assert(flip != NULL && width >= 0 && height >= 0 && size > 0);
+    struct Caches c = machineCaches();
+    int quarter = (rotation == 90 || rotation == 270);
+    int w = quarter ? height : width;           /* of the destination */
+    int h = quarter ? width : height;
+    int flipped = strcmp(flip, "horizontal") == 0 ||
+                  strcmp(flip, "vertical") == 0;
+
+    AutoSelect_Choice choice;
+    choice.layout = AUTOSELECT_ROW;
+    for (int l = 0; l < AUTOSELECT_NLAYOUTS; l++) {
+        double cost = 0;
+        if (rotation != 0) {
+            cost += passCost(l, quarter, w, h, size, &c);
+        }
+        if (flipped) {
+            cost += passCost(l, 0, w, h, size, &c);
+        }
+        if (l == AUTOSELECT_BLOCK) {
+            cost += conversionCost(w, h, size, &c);
+        }
+        choice.estimates[l] = cost;
+        if (cost < choice.estimates[choice.layout]) {
+            choice.layout = l;
+        }
+    }
+
+    choice.name = names[choice.layout];
+    choice.blocksize = 0;
+    switch (choice.layout) {
+        case AUTOSELECT_ROW:
+            choice.methods = uarray2_methods_plain;
+            choice.map = choice.methods->map_row_major;
+            break;
+        case AUTOSELECT_COL:
+            choice.methods = uarray2_methods_plain;
+            choice.map = choice.methods->map_col_major;
+            break;
+        case AUTOSELECT_TILE:
+            choice.methods = uarray2_methods_plain;
+            choice.map = a2plain_map_tile_major;
+            break;
+        default:
+            choice.methods = uarray2_methods_blocked;
+            choice.map = choice.methods->map_block_major;
+            break;
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    long pixels = (long)width * height;
+    long threads = pixels / AUTOSELECT_PIXELS_PER_THREAD;
+    if (cpus > MAX_THREADS) {
+        cpus = MAX_THREADS;
+    }
+    if (threads > cpus) {
+        threads = cpus;
+    }
+    choice.nthreads = threads > 1 ? threads : 1;
+    return choice;
+}
@@ -0,0 +1,60 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** autoselect.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for autoselect.c, which picks the storage
+ **          layout, traversal, block or tile size and thread count for a
+ **          transform from the image's shape and this machine's caches,
+ **          so ppmtrans -auto can be used without knowing which flag is
+ **          fastest for which transform.
+ **/
+
+#ifndef AUTOSELECT_INCLUDED
+#define AUTOSELECT_INCLUDED
+
+#include "a2methods.h"
+
+/* the layouts there is a choice between */
+typedef enum AutoSelect_Layout {
+    AUTOSELECT_ROW = 0,     /* plain, row-major */
+    AUTOSELECT_COL,         /* plain, column-major */
+    AUTOSELECT_TILE,        /* plain, tile-major */
+    AUTOSELECT_BLOCK,       /* converted to blocked, block-major */
+    AUTOSELECT_NLAYOUTS
+} AutoSelect_Layout;
+
+typedef struct AutoSelect_Choice {
+    AutoSelect_Layout layout;
+    const char *name;           /* "row-major", "col-major", ... */
+    A2Methods_T methods;        /* the suite to transform with */
+    A2Methods_mapfun *map;
+    int blocksize;              /* block or tile size, 0 for the default */
+    int nthreads;
+    double estimates[AUTOSELECT_NLAYOUTS];  /* ns per pixel, each layout */
+} AutoSelect_Choice;
+
+/* @function: AutoSelect_choose
+ * @purpose: pick the layout with the lowest estimated cost for rotating
+ *           and/or flipping a width x height image of size-byte pixels.
+ *           The estimate counts, for every pass, the cache lines each
+ *           layout brings in per pixel and where they come from (L1, L2,
+ *           L3 or memory, going by the cache sizes sysconf reports),
+ *           plus TLB misses for column walks, the loop's own cost, and
+ *           for the blocked layout the conversions in and out.
+ *
+ * @parameters: 1) int rotation, 0, 90, 180 or 270
+ *              2) const char *flip, "horizontal", "vertical" or anything
+ *                 else for no flip
+ *              3) int width, int height, of the source image
+ *              4) int size, bytes per pixel
+ * @returns: the choice; the thread count is one per
+ *           AUTOSELECT_PIXELS_PER_THREAD pixels, up to the number of
+ *           online CPUs
+ */
+extern AutoSelect_Choice AutoSelect_choose(int rotation, const char *flip,
+                                           int width, int height, int size);
+
+#define AUTOSELECT_PIXELS_PER_THREAD (1 << 18)
+
+#endif /* AUTOSELECT_INCLUDED */
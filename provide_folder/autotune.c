@@ -0,0 +1,350 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** autotune.c
+ ** 19 October 2026
+ **
+ ** Purpose: the autotuner behind ppmtune and ppmtrans. Every candidate
+ **          is timed on the same synthetic image through alterImage, so
+ **          the trials run exactly the code ppmtrans runs. The only pixel
+ **          format transform.c handles is struct Pnm_rgb ("rgb").
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+
+#include "assert.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+#include "pnm.h"
+#include "cputiming.h"
+#include "transform.h"
+#include "autotune.h"
+
+#define FILE_NAME ".ppmtrans-tune"
+#define LINE_MAX_LEN 512
+#define MAX_LINES 1024
+
+static const int blocksizes[] = { 8, 16, 32, 48, 64, 0 };  /* 0: 64KB */
+static const int tiles[] = { 8, 16, 32, 64, 128 };
+#define NBLOCKSIZES ((int)(sizeof(blocksizes) / sizeof(blocksizes[0])))
+#define NTILES ((int)(sizeof(tiles) / sizeof(tiles[0])))
+
+struct Transform {
+    int rotation;
+    char *flip;
+    const char *name;       /* as in the tuning file */
+};
+
+static const struct Transform transforms[] = {
+    { 90,  " ",          "rotate90" },
+    { 180, " ",          "rotate180" },
+    { 270, " ",          "rotate270" },
+    { 0,   "horizontal", "flip-horizontal" },
+    { 0,   "vertical",   "flip-vertical" },
+};
+#define NTRANSFORMS ((int)(sizeof(transforms) / sizeof(transforms[0])))
+
+extern const char *Autotune_file(void)
+{
+    static char path[LINE_MAX_LEN];
+    const char *file = getenv("PPMTRANS_TUNE_FILE");
+    if (file != NULL && *file != '\0') {
+        return file;
+    }
+    const char *home = getenv("HOME");
+    snprintf(path, sizeof(path), "%s/%s", home != NULL ? home : ".",
+             FILE_NAME);
+    return path;
+}
+
+extern const char *Autotune_cpu(void)
+{
+    static char cpu[LINE_MAX_LEN] = "";
+    if (cpu[0] != '\0') {
+        return cpu;
+    }
+
+    FILE *fp = fopen("/proc/cpuinfo", "r");
+    char line[LINE_MAX_LEN];
+    while (fp != NULL && fgets(line, sizeof(line), fp) != NULL) {
+        char *colon = strchr(line, ':');
+        if (strncmp(line, "model name", 10) == 0 && colon != NULL) {
+            char *name = colon + 1;
+            while (*name == ' ') {
+                name++;
+            }
+            snprintf(cpu, sizeof(cpu), "%s", name);
+            break;
+        }
+    }
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    if (cpu[0] == '\0') {           /* no model name: the architecture */
+        struct utsname u;
+        snprintf(cpu, sizeof(cpu), "%s",
+                 uname(&u) == 0 ? u.machine : "unknown");
+    }
+
+    /* the name is one field of the file */
+    for (char *p = cpu; *p != '\0'; p++) {
+        if (*p == '\t' || *p == '\n') {
+            *p = ' ';
+        }
+    }
+    for (size_t n = strlen(cpu); n > 0 && cpu[n - 1] == ' '; n--) {
+        cpu[n - 1] = '\0';
+    }
+    return cpu;
+}
+
+/* @function: transformName
+ * @purpose: the file's name for a transform; a rotation with a flip goes
+ *           by the rotation
+ *
+ * @returns: the name, or NULL if there is no transform
+ */
+static const char *transformName(int rotation, const char *flip)
+{
+    for (int t = 0; t < NTRANSFORMS; t++) {
+        if ((rotation != 0 && transforms[t].rotation == rotation) ||
+            (rotation == 0 && strcmp(transforms[t].flip, flip) == 0)) {
+            return transforms[t].name;
+        }
+    }
+    return NULL;
+}
+
+/* @function: fillPixel
+ * @purpose: apply function giving every pixel of the trial image a value
+ */
+static void fillPixel(int col, int row, A2Methods_UArray2 array2,
+                      A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    (void) cl;
+    Pnm_rgb pixel = ptr;
+    pixel->red = col & 0xff;
+    pixel->green = row & 0xff;
+    pixel->blue = (col ^ row) & 0xff;
+}
+
+/* @function: trial
+ * @purpose: time one transform with one suite, map and block size
+ *
+ * @returns: the median of reps runs, after one untimed run, in ns
+ */
+static double trial(const struct Transform *transform, A2Methods_T methods,
+                    A2Methods_mapfun *map, int blocksize, int width,
+                    int height, int reps)
+{
+    int size = sizeof(struct Pnm_rgb);
+    int turned = (transform->rotation == 90 || transform->rotation == 270);
+    A2Methods_UArray2 source = blocksize > 0
+        ? methods->new_with_blocksize(width, height, size, blocksize)
+        : methods->new(width, height, size);
+    A2Methods_UArray2 dest = blocksize > 0
+        ? methods->new_with_blocksize(turned ? height : width,
+                                      turned ? width : height, size,
+                                      blocksize)
+        : methods->new(turned ? height : width, turned ? width : height,
+                       size);
+    struct Pnm_ppm image = { width, height, 255, source, methods };
+    /* uarray2's maps insist on a closure */
+    methods->map_default(source, fillPixel, &image);
+
+    CPUStats_T stats = CPUStats_New(transform->name, CPUTIME_WALL);
+    for (int i = 0; i <= reps; i++) {
+        if (i > 0) {
+            CPUStats_Start(stats);
+        }
+        alterImage(transform->rotation, transform->flip, &image, map, dest);
+        if (i > 0) {
+            CPUStats_Stop(stats);
+        }
+    }
+    double median = CPUStats_Median(stats);
+    CPUStats_Free(&stats);
+    methods->free(&dest);
+    methods->free(&source);
+    return median;
+}
+
+/* @function: readOtherLines
+ * @purpose: the lines of file that are not this CPU's
+ *
+ * @returns: how many were read into lines, each malloc'd
+ */
+static int readOtherLines(const char *file, const char *cpu, char **lines)
+{
+    FILE *fp = fopen(file, "r");
+    if (fp == NULL) {
+        return 0;
+    }
+    int n = 0;
+    size_t cpuLength = strlen(cpu);
+    char line[LINE_MAX_LEN];
+    while (n < MAX_LINES && fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, cpu, cpuLength) == 0 && line[cpuLength] == '\t') {
+            continue;
+        }
+        lines[n] = malloc(strlen(line) + 1);
+        assert(lines[n] != NULL);
+        strcpy(lines[n++], line);
+    }
+    fclose(fp);
+    return n;
+}
+
+extern int Autotune_run(const char *file, int width, int height, int reps,
+                        FILE *log)
+{
+    assert(file != NULL && width > 0 && height > 0 && reps > 0);
+    const char *cpu = Autotune_cpu();
+    A2Methods_T blocked = uarray2_methods_blocked;
+    A2Methods_T plain = uarray2_methods_plain;
+    int bestBlock[NTRANSFORMS], bestTile[NTRANSFORMS];
+
+    if (log != NULL) {
+        fprintf(log, "Tuning for %s on a %dx%d image\n", cpu, width,
+                height);
+    }
+    for (int t = 0; t < NTRANSFORMS; t++) {
+        double best = -1;
+        for (int b = 0; b < NBLOCKSIZES; b++) {
+            double ns = trial(&transforms[t], blocked,
+                              blocked->map_block_major, blocksizes[b],
+                              width, height, reps);
+            if (log != NULL) {
+                fprintf(log, "%-16s block %3d: %.2f ns/pixel\n",
+                        transforms[t].name, blocksizes[b],
+                        ns / ((double)width * height));
+            }
+            if (best < 0 || ns < best) {
+                best = ns;
+                bestBlock[t] = blocksizes[b];
+            }
+        }
+        best = -1;
+        for (int k = 0; k < NTILES; k++) {
+            a2plain_set_tile_size(tiles[k]);
+            double ns = trial(&transforms[t], plain, a2plain_map_tile_major,
+                              0, width, height, reps);
+            if (log != NULL) {
+                fprintf(log, "%-16s tile  %3d: %.2f ns/pixel\n",
+                        transforms[t].name, tiles[k],
+                        ns / ((double)width * height));
+            }
+            if (best < 0 || ns < best) {
+                best = ns;
+                bestTile[t] = tiles[k];
+            }
+        }
+        a2plain_set_tile_size(0);
+    }
+
+    /* replace this CPU's lines, through a temporary file of our own in
+     * the same directory, so that processes tuning at once each rename
+     * a whole file over it */
+    char *lines[MAX_LINES];
+    int n = readOtherLines(file, cpu, lines);
+    char temporary[LINE_MAX_LEN];
+    snprintf(temporary, sizeof(temporary), "%s.XXXXXX", file);
+    int fd = mkstemp(temporary);
+    FILE *fp = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (fp != NULL) {
+        for (int i = 0; i < n; i++) {
+            fputs(lines[i], fp);
+        }
+        for (int t = 0; t < NTRANSFORMS; t++) {
+            fprintf(fp, "%s\trgb\t%s\t%d\t%d\n", cpu, transforms[t].name,
+                    bestBlock[t], bestTile[t]);
+        }
+    } else if (fd >= 0) {
+        close(fd);
+    }
+    for (int i = 0; i < n; i++) {
+        free(lines[i]);
+    }
+    if (fp == NULL || fclose(fp) != 0 || rename(temporary, file) != 0) {
+        if (fd >= 0) {
+            unlink(temporary);
+        }
+        return -1;
+    }
+    return 0;
+}
+
+/* @function: lookup
+ * @purpose: Autotune_lookup for a given CPU
+ *
+ * @returns: 0 if found, -1 if not, -2 if there is no file
+ */
+static int lookup(const char *file, const char *cpu, const char *format,
+                  const char *transform, int *blocksize, int *tile)
+{
+    FILE *fp = fopen(file, "r");
+    if (fp == NULL) {
+        return -2;
+    }
+    int found = -1;
+    char line[LINE_MAX_LEN];
+    while (found != 0 && fgets(line, sizeof(line), fp) != NULL) {
+        char *fields[5];
+        int n = 0;
+        for (char *field = strtok(line, "\t\n"); field != NULL && n < 5;
+             field = strtok(NULL, "\t\n")) {
+            fields[n++] = field;
+        }
+        if (n == 5 && strcmp(fields[0], cpu) == 0 &&
+            strcmp(fields[1], format) == 0 &&
+            strcmp(fields[2], transform) == 0) {
+            *blocksize = atoi(fields[3]);
+            *tile = atoi(fields[4]);
+            found = 0;
+        }
+    }
+    fclose(fp);
+    return found;
+}
+
+extern int Autotune_lookup(const char *file, const char *format,
+                           int rotation, const char *flip,
+                           int *blocksize, int *tile)
+{
+    assert(file != NULL && format != NULL && flip != NULL);
+    assert(blocksize != NULL && tile != NULL);
+    const char *transform = transformName(rotation, flip);
+    if (transform == NULL) {
+        return -1;
+    }
+    return lookup(file, Autotune_cpu(), format, transform, blocksize,
+                  tile) == 0 ? 0 : -1;
+}
+
+extern int Autotune_consult(const char *format, int rotation,
+                            const char *flip, int *blocksize, int *tile)
+{
+    const char *file = Autotune_file();
+    const char *transform = transformName(rotation, flip);
+    if (transform == NULL) {
+        return -1;
+    }
+    int found = lookup(file, Autotune_cpu(), format, transform, blocksize,
+                       tile);
+    if (found == -1) {              /* a file, but not for this CPU */
+        fprintf(stderr, "Tuning for %s into %s (a few seconds, once)\n",
+                Autotune_cpu(), file);
+        if (Autotune_run(file, AUTOTUNE_WIDTH, AUTOTUNE_HEIGHT,
+                         AUTOTUNE_REPS, NULL) != 0) {
+            return -1;
+        }
+        found = lookup(file, Autotune_cpu(), format, transform, blocksize,
+                       tile);
+    }
+    return found == 0 ? 0 : -1;
+}
@@ -0,0 +1,77 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** autotune.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for autotune.c, which times short trials of
+ **          candidate block and tile sizes on this machine and keeps the
+ **          fastest for every pixel format and transform in a tuning
+ **          file. The file is plain text, one tab-separated line per
+ **          CPU model, pixel format and transform:
+ **
+ **              cpu model <TAB> format <TAB> transform <TAB> block <TAB> tile
+ **
+ **          so one file can be shared by machines with different CPUs.
+ **/
+
+#ifndef AUTOTUNE_INCLUDED
+#define AUTOTUNE_INCLUDED
+
+#include <stdio.h>
+
+/* the trial image, and how many timed runs each candidate gets */
+#define AUTOTUNE_WIDTH 1024
+#define AUTOTUNE_HEIGHT 1024
+#define AUTOTUNE_REPS 3
+
+/* @function: Autotune_file
+ * @purpose: the tuning file: $PPMTRANS_TUNE_FILE if set, otherwise
+ *           .ppmtrans-tune in $HOME (or the current directory)
+ */
+extern const char *Autotune_file(void);
+
+/* @function: Autotune_cpu
+ * @purpose: this machine's CPU model, as the tuning file names it
+ */
+extern const char *Autotune_cpu(void);
+
+/* @function: Autotune_run
+ * @purpose: tune every transform for this CPU and replace its lines in
+ *           file, keeping the other CPUs' lines
+ *
+ * @parameters: 1) const char *file, the tuning file
+ *              2) int width, int height, int reps, the trials
+ *              3) FILE *log, NULL or where to describe every trial
+ * @returns: 0, or -1 if the file could not be written
+ */
+extern int Autotune_run(const char *file, int width, int height, int reps,
+                        FILE *log);
+
+/* @function: Autotune_lookup
+ * @purpose: the tuned sizes for this CPU, a pixel format ("rgb") and a
+ *           transform
+ *
+ * @parameters: 1) const char *file, the tuning file
+ *              2) const char *format, the pixel format
+ *              3) int rotation, const char *flip, the transform; a
+ *                 rotation with a flip is tuned as the rotation
+ *              4) int *blocksize, int *tile, set if found
+ * @returns: 0 if found, -1 if not (or there is no transform)
+ */
+extern int Autotune_lookup(const char *file, const char *format,
+                           int rotation, const char *flip,
+                           int *blocksize, int *tile);
+
+/* @function: Autotune_consult
+ * @purpose: what ppmtrans does at startup: Autotune_lookup in the default
+ *           file, first re-tuning (which takes a few seconds) if the
+ *           file exists but has nothing for this CPU, as when it was
+ *           tuned on another machine, and saying so on stderr. Without a
+ *           file nothing is tuned.
+ *
+ * @returns: as Autotune_lookup
+ */
+extern int Autotune_consult(const char *format, int rotation,
+                            const char *flip, int *blocksize, int *tile);
+
+#endif /* AUTOTUNE_INCLUDED */
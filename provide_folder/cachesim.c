@@ -0,0 +1,280 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** cachesim.c
+ ** 18 October 2026
+ **
+ ** Purpose: set-associative cache and TLB simulation. A level (cache or
+ **          TLB) is an array of sets, each holding ways tags with an LRU
+ **          time stamp; a line number (or page number) maps to set
+ **          number % sets. Tag 0 marks an empty way, so tags are stored
+ **          as number + 1.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "assert.h"
+#include "mem.h"
+#include "cachesim.h"
+
+#define T CacheSim_T
+#define MAXLEVELS 8
+#define NAMELEN 16
+
+struct Level {
+    char name[NAMELEN];
+    unsigned long long capacity;    /* bytes, or entries for the TLB */
+    unsigned blockSize;             /* line or page size in bytes */
+    int blockShift;
+    unsigned long long sets;
+    int ways;
+    unsigned long long *tags;       /* sets * ways */
+    unsigned long long *stamps;
+    unsigned long long hits[CACHESIM_NSTREAMS];
+    unsigned long long misses[CACHESIM_NSTREAMS];
+};
+
+struct T {
+    struct Level levels[MAXLEVELS];
+    int nlevels;
+    struct Level tlb;
+    int hasTLB;
+    unsigned long long clock;       /* for LRU */
+};
+
+/* @function: parseSize
+ * @purpose: read a number with an optional K, M or G suffix
+ *
+ * @returns: the number, or 0 if malformed; *rest is left after it
+ */
+static unsigned long long parseSize(const char *s, char **rest)
+{
+    unsigned long long n = strtoull(s, rest, 10);
+    if (*rest == s) {
+        return 0;
+    }
+    switch (**rest) {
+        case 'K': case 'k': n <<= 10; (*rest)++; break;
+        case 'M': case 'm': n <<= 20; (*rest)++; break;
+        case 'G': case 'g': n <<= 30; (*rest)++; break;
+        default: break;
+    }
+    return n;
+}
+
+/* @function: log2Exact
+ * @purpose: return k if n is 2 to the k, otherwise -1
+ */
+static int log2Exact(unsigned long long n)
+{
+    int k = 0;
+    if (n == 0 || (n & (n - 1)) != 0) {
+        return -1;
+    }
+    while ((1ULL << k) != n) {
+        k++;
+    }
+    return k;
+}
+
+/* @function: makeLevel
+ * @purpose: parse "a/b/c" for one level and allocate its sets
+ *
+ * @returns: 0, or -1 if malformed
+ */
+static int makeLevel(struct Level *level, const char *name, const char *spec,
+                     int isTLB)
+{
+    char *rest;
+    unsigned long long first = parseSize(spec, &rest);
+    if (first == 0 || *rest != '/') {
+        return -1;
+    }
+    unsigned long long second = parseSize(rest + 1, &rest);
+    if (second == 0 || *rest != '/') {
+        return -1;
+    }
+    unsigned long long third = parseSize(rest + 1, &rest);
+    if (third == 0 || *rest != '\0') {
+        return -1;
+    }
+
+    /* cache: size/line/ways, TLB: entries/ways/pagesize */
+    unsigned long long blocks = isTLB ? first : first / second;
+    int ways = isTLB ? second : third;
+    unsigned long long blockSize = isTLB ? third : second;
+
+    level->blockShift = log2Exact(blockSize);
+    if (level->blockShift < 0 || ways <= 0 || blocks < (unsigned)ways ||
+        blocks % ways != 0) {
+        return -1;
+    }
+    snprintf(level->name, NAMELEN, "%s", name);
+    level->capacity = first;
+    level->blockSize = blockSize;
+    level->sets = blocks / ways;
+    level->ways = ways;
+    level->tags = CALLOC(blocks, sizeof(unsigned long long));
+    level->stamps = CALLOC(blocks, sizeof(unsigned long long));
+    for (int s = 0; s < CACHESIM_NSTREAMS; s++) {
+        level->hits[s] = 0;
+        level->misses[s] = 0;
+    }
+    return 0;
+}
+
+extern T CacheSim_new(const char *machine)
+{
+    assert(machine != NULL);
+    if (strcmp(machine, "default") == 0) {
+        machine = CACHESIM_DEFAULT_MACHINE;
+    }
+
+    T sim;
+    NEW(sim);
+    sim->nlevels = 0;
+    sim->hasTLB = 0;
+    sim->clock = 0;
+
+    char *copy = ALLOC(strlen(machine) + 1);
+    strcpy(copy, machine);
+    int ok = 1;
+    for (char *item = strtok(copy, ","); item != NULL && ok;
+         item = strtok(NULL, ",")) {
+        char *equals = strchr(item, '=');
+        if (equals == NULL || equals == item) {
+            ok = 0;
+            break;
+        }
+        *equals = '\0';
+        if (strcmp(item, "TLB") == 0) {
+            ok = !sim->hasTLB &&
+                 makeLevel(&sim->tlb, item, equals + 1, 1) == 0;
+            sim->hasTLB = ok;
+        } else if (sim->nlevels < MAXLEVELS) {
+            ok = makeLevel(&sim->levels[sim->nlevels], item, equals + 1,
+                           0) == 0;
+            sim->nlevels += ok;
+        } else {
+            ok = 0;
+        }
+    }
+    FREE(copy);
+
+    if (!ok || sim->nlevels + sim->hasTLB == 0) {
+        CacheSim_free(&sim);
+        return NULL;
+    }
+    return sim;
+}
+
+extern void CacheSim_free(T *sim)
+{
+    assert(sim != NULL && *sim != NULL);
+    for (int i = 0; i < (*sim)->nlevels; i++) {
+        FREE((*sim)->levels[i].tags);
+        FREE((*sim)->levels[i].stamps);
+    }
+    if ((*sim)->hasTLB) {
+        FREE((*sim)->tlb.tags);
+        FREE((*sim)->tlb.stamps);
+    }
+    FREE(*sim);
+}
+
+/* @function: lookup
+ * @purpose: look block up in level, filling it in on a miss
+ *
+ * @returns: 1 on a hit, 0 on a miss
+ */
+static int lookup(T sim, struct Level *level, unsigned long long block,
+                  CacheSim_Stream stream)
+{
+    unsigned long long *tags = level->tags +
+                               (block % level->sets) * level->ways;
+    unsigned long long *stamps = level->stamps +
+                                 (block % level->sets) * level->ways;
+    unsigned long long tag = block + 1;
+    int victim = 0;
+
+    sim->clock++;
+    for (int w = 0; w < level->ways; w++) {
+        if (tags[w] == tag) {
+            stamps[w] = sim->clock;
+            level->hits[stream]++;
+            return 1;
+        }
+        if (stamps[w] < stamps[victim]) {
+            victim = w;
+        }
+    }
+    tags[victim] = tag;
+    stamps[victim] = sim->clock;
+    level->misses[stream]++;
+    return 0;
+}
+
+extern void CacheSim_access(T sim, uintptr_t address, int bytes,
+                            CacheSim_Stream stream)
+{
+    assert(sim != NULL && bytes > 0);
+    assert(stream >= 0 && stream < CACHESIM_NSTREAMS);
+    uintptr_t last = address + bytes - 1;
+
+    if (sim->hasTLB) {
+        int shift = sim->tlb.blockShift;
+        for (uintptr_t page = address >> shift; page <= last >> shift;
+             page++) {
+            lookup(sim, &sim->tlb, page, stream);
+        }
+    }
+    if (sim->nlevels == 0) {
+        return;
+    }
+
+    /* lines are counted in the line size of the first level */
+    int shift = sim->levels[0].blockShift;
+    for (uintptr_t line = address >> shift; line <= last >> shift; line++) {
+        uintptr_t lineAddress = line << shift;
+        for (int i = 0; i < sim->nlevels; i++) {
+            struct Level *level = &sim->levels[i];
+            if (lookup(sim, level, lineAddress >> level->blockShift,
+                       stream)) {
+                break;
+            }
+        }
+    }
+}
+
+/* @function: printLevel
+ * @purpose: write one level's counts for both streams
+ */
+static void printLevel(FILE *fp, struct Level *level, const char *units)
+{
+    static const char *streamNames[CACHESIM_NSTREAMS] = {
+        "source reads", "dest writes"
+    };
+    fprintf(fp, "%s (%llu%s, %u byte %s, %d-way):\n", level->name,
+            level->capacity, units, level->blockSize,
+            strcmp(units, " entries") == 0 ? "pages" : "lines", level->ways);
+    for (int s = 0; s < CACHESIM_NSTREAMS; s++) {
+        unsigned long long total = level->hits[s] + level->misses[s];
+        fprintf(fp, "    %-12s %12llu lookups, %12llu misses, %6.2f%% hits\n",
+                streamNames[s], total, level->misses[s],
+                total == 0 ? 0.0 : 100.0 * level->hits[s] / total);
+    }
+}
+
+extern void CacheSim_print(T sim, FILE *fp)
+{
+    assert(sim != NULL && fp != NULL);
+    for (int i = 0; i < sim->nlevels; i++) {
+        printLevel(fp, &sim->levels[i], " bytes");
+    }
+    if (sim->hasTLB) {
+        printLevel(fp, &sim->tlb, " entries");
+    }
+}
+
+#undef T
@@ -0,0 +1,69 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** cachesim.h
+ ** 18 October 2026
+ **
+ ** Purpose: public interface for cachesim.c, a trace-driven simulator of
+ **          a set-associative cache hierarchy and data TLB. Accesses are
+ **          tagged as source reads or destination writes and the hits and
+ **          misses of every level are kept separately for the two.
+ **/
+
+#ifndef CACHESIM_INCLUDED
+#define CACHESIM_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* the machine simulated when none is given */
+#define CACHESIM_DEFAULT_MACHINE "L1=32K/64/8,L2=1M/64/16,L3=32M/64/16," \
+                                 "TLB=64/4/4K"
+
+typedef enum CacheSim_Stream {
+    CACHESIM_SOURCE = 0,    /* reads of the image being transformed */
+    CACHESIM_DEST,          /* writes of the result */
+    CACHESIM_NSTREAMS
+} CacheSim_Stream;
+
+#define T CacheSim_T
+typedef struct T *T;
+
+/* @function: CacheSim_new
+ * @purpose: make a simulator for a machine described as a comma separated
+ *           list of levels, nearest first. A cache level is
+ *           name=size/line/ways and the TLB is TLB=entries/ways/pagesize;
+ *           sizes may end in K, M or G, and lines and pages must be powers
+ *           of two. "default" means CACHESIM_DEFAULT_MACHINE.
+ *
+ * @returns: type T, or NULL if the description is malformed
+ */
+extern T CacheSim_new(const char *machine);
+
+/* @function: CacheSim_free
+ * @purpose: deallocate a simulator
+ */
+extern void CacheSim_free(T *sim);
+
+/* @function: CacheSim_access
+ * @purpose: simulate an access to bytes bytes at address. Every line the
+ *           access touches goes down the hierarchy until a level hits,
+ *           and is brought into every level that missed (LRU
+ *           replacement, write-allocate, no write-back traffic); every
+ *           page it touches is looked up in the TLB.
+ *
+ * @parameters: 1) T sim
+ *              2) uintptr_t address, int bytes, what is accessed
+ *              3) CacheSim_Stream stream, which counts it goes into
+ * @returns: none
+ */
+extern void CacheSim_access(T sim, uintptr_t address, int bytes,
+                            CacheSim_Stream stream);
+
+/* @function: CacheSim_print
+ * @purpose: write the accesses and hit rate of every level, source reads
+ *           and destination writes on separate lines
+ */
+extern void CacheSim_print(T sim, FILE *fp);
+
+#undef T
+#endif /* CACHESIM_INCLUDED */
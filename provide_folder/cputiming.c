@@ -28,11 +28,30 @@
  *
  *****************************************************************/
 
+#ifdef __linux__
+#define _GNU_SOURCE             /* sched_setaffinity */
+#endif
+
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
 #include "assert.h"
 #include "cputiming_impl.h"
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_TSC 1
+#endif
+
+#define TSC_CALIBRATION_NS 20000000     /* 20ms against the wall clock */
+#define FLUSH_DEFAULT_LLC (16 << 20)    /* if the LLC size is unknown */
+
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
  *              Forward declaration of functions/
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
@@ -43,37 +62,408 @@ static int timespec_subtract (struct timespec *result, struct timespec *x,
 
 static double timespec_to_double(struct timespec *x);
 
+static double read_counter(int fd);
+
+static clockid_t clock_id(CPUTime_Clock clock);
+
+static unsigned long long read_tsc(void);
+
+static int compare_doubles(const void *a, const void *b);
+
+static volatile unsigned char flush_sink;     /* see CPUTime_FlushCaches */
+
+static const char *clock_names[] = {
+        "process", "wall", "thread", "tsc"
+};
+
+static const char *counter_names[CPUTIME_NCOUNTERS] = {
+        "cycles",
+        "instructions",
+        "L1D misses",
+        "LLC misses",
+        "dTLB misses",
+        "branch misses"
+};
+
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
  *              Functions implementing the CPUTime interface
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 
 CPUTime_T CPUTime_New(){
+        return CPUTime_NewWithClock(CPUTIME_PROCESS);
+}
+
+CPUTime_T CPUTime_NewWithClock(CPUTime_Clock clock){
+        assert(clock >= CPUTIME_PROCESS && clock <= CPUTIME_TSC);
         CPUTime_T startTimep = malloc(sizeof(*startTimep));
         assert (startTimep != NULL);
+        startTimep->clock = clock;
+        startTimep->lastticks = 0;
+        if (clock == CPUTIME_TSC)
+                (void)CPUTime_TSCFrequency();   /* calibrate up front */
+        for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+                startTimep->counterfd[i] = -1;
+                startTimep->count[i] = -1;
+        }
         return startTimep;
 }
 
 void CPUTime_Free(CPUTime_T *startTimepp){
         assert(startTimepp != NULL);
         assert(*startTimepp != NULL);
+        for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+                if ((*startTimepp)->counterfd[i] >= 0)
+                        close((*startTimepp)->counterfd[i]);
+        }
         free(*startTimepp);
         *startTimepp = NULL;
         return;
 }
 
 void CPUTime_Start(CPUTime_T startTimep) {
-        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &(startTimep->time));
+        for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+                if (startTimep->counterfd[i] >= 0)
+                        startTimep->startcount[i] =
+                                read_counter(startTimep->counterfd[i]);
+        }
+        if (startTimep->clock == CPUTIME_TSC)
+                startTimep->ticks = read_tsc();
+        else
+                clock_gettime(clock_id(startTimep->clock),
+                              &(startTimep->time));
         return;
 }
 
 double CPUTime_Stop(CPUTime_T startTimep) {
         struct timespec stop, time_used;
-        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &stop);
+        unsigned long long stopticks = 0;
+        if (startTimep->clock == CPUTIME_TSC)
+                stopticks = read_tsc();
+        else
+                clock_gettime(clock_id(startTimep->clock), &stop);
+        for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+                if (startTimep->counterfd[i] >= 0)
+                        startTimep->count[i] =
+                                read_counter(startTimep->counterfd[i])
+                                - startTimep->startcount[i];
+        }
+        if (startTimep->clock == CPUTIME_TSC) {
+                startTimep->lastticks = stopticks - startTimep->ticks;
+                return startTimep->lastticks * 1e9 / CPUTime_TSCFrequency();
+        }
         assert(timespec_subtract(&time_used, &stop, &(startTimep->time)) == 0);
         return timespec_to_double(&time_used);
 }
 
+CPUTime_Clock CPUTime_GetClock(CPUTime_T timer) {
+        assert(timer != NULL);
+        return timer->clock;
+}
+
+const char *CPUTime_ClockName(CPUTime_Clock clock) {
+        assert(clock >= CPUTIME_PROCESS && clock <= CPUTIME_TSC);
+        return clock_names[clock];
+}
+
+double CPUTime_Ticks(CPUTime_T timer) {
+        assert(timer != NULL);
+        return timer->lastticks;
+}
+
+/*
+ *  The frequency is measured once per process by counting ticks
+ *  across a short busy wait on the monotonic clock.  On machines
+ *  with an invariant TSC (every x86 of the last decade) it does not
+ *  change with frequency scaling, so one calibration is enough.
+ */
+double CPUTime_TSCFrequency(void) {
+        static double frequency = 0;
+        if (frequency > 0)
+                return frequency;
+#ifdef HAVE_TSC
+        struct timespec start, now, elapsed;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        unsigned long long startticks = read_tsc();
+        do {
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                timespec_subtract(&elapsed, &now, &start);
+        } while (timespec_to_double(&elapsed) < TSC_CALIBRATION_NS);
+        unsigned long long ticks = read_tsc() - startticks;
+        frequency = ticks * 1e9 / timespec_to_double(&elapsed);
+#else
+        frequency = 1e9;        /* read_tsc counts nanoseconds */
+#endif
+        return frequency;
+}
+
+/*
+ *  Counters are opened one by one rather than as a group, so that
+ *  one event the PMU does not have does not take the others down
+ *  with it.  They count user-mode events only, which is what
+ *  perf_event_paranoid level 2 (the usual default) allows.
+ */
+int CPUTime_EnableCounters(CPUTime_T timer) {
+        assert(timer != NULL);
+        int available = 0;
+#ifdef __linux__
+        static const struct { unsigned type; unsigned long long config; }
+        events[CPUTIME_NCOUNTERS] = {
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+                { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+                        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+                { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL
+                        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+                { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB
+                        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        };
+
+        for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+                if (timer->counterfd[i] >= 0) {
+                        available++;
+                        continue;
+                }
+                struct perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = events[i].type;
+                attr.config = events[i].config;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.inherit = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+                                   | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                int fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+                timer->counterfd[i] = fd;
+                if (fd >= 0)
+                        available++;
+        }
+#endif
+        return available;
+}
+
+double CPUTime_Count(CPUTime_T timer, CPUTime_Counter which) {
+        assert(timer != NULL);
+        assert(which >= 0 && which < CPUTIME_NCOUNTERS);
+        return timer->counterfd[which] >= 0 ? timer->count[which] : -1;
+}
+
+const char *CPUTime_CounterName(CPUTime_Counter which) {
+        assert(which >= 0 && which < CPUTIME_NCOUNTERS);
+        return counter_names[which];
+}
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+ *              Functions implementing the CPUStats interface
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+CPUStats_T CPUStats_New(const char *name, CPUTime_Clock clock) {
+        assert(name != NULL);
+        CPUStats_T stats = malloc(sizeof(*stats));
+        assert(stats != NULL);
+        stats->name = malloc(strlen(name) + 1);
+        assert(stats->name != NULL);
+        strcpy(stats->name, name);
+        stats->timer = CPUTime_NewWithClock(clock);
+        stats->capacity = 16;
+        stats->samples = malloc(stats->capacity * sizeof(double));
+        assert(stats->samples != NULL);
+        stats->count = 0;
+        stats->total = 0;
+        return stats;
+}
+
+void CPUStats_Free(CPUStats_T *stats) {
+        assert(stats != NULL && *stats != NULL);
+        CPUTime_Free(&(*stats)->timer);
+        free((*stats)->samples);
+        free((*stats)->name);
+        free(*stats);
+        *stats = NULL;
+}
+
+void CPUStats_Start(CPUStats_T stats) {
+        assert(stats != NULL);
+        CPUTime_Start(stats->timer);
+}
+
+double CPUStats_Stop(CPUStats_T stats) {
+        assert(stats != NULL);
+        double ns = CPUTime_Stop(stats->timer);
+        CPUStats_Add(stats, ns);
+        return ns;
+}
+
+void CPUStats_Add(CPUStats_T stats, double nanoseconds) {
+        assert(stats != NULL);
+        if (stats->count == stats->capacity) {
+                stats->capacity *= 2;
+                stats->samples = realloc(stats->samples,
+                                         stats->capacity * sizeof(double));
+                assert(stats->samples != NULL);
+        }
+        stats->samples[stats->count++] = nanoseconds;
+        stats->total += nanoseconds;
+}
+
+const char *CPUStats_Name(CPUStats_T stats) {
+        assert(stats != NULL);
+        return stats->name;
+}
+
+int CPUStats_Count(CPUStats_T stats) {
+        assert(stats != NULL);
+        return stats->count;
+}
+
+double CPUStats_Total(CPUStats_T stats) {
+        assert(stats != NULL);
+        return stats->total;
+}
+
+double CPUStats_Min(CPUStats_T stats) {
+        return CPUStats_Percentile(stats, 0);
+}
+
+double CPUStats_Max(CPUStats_T stats) {
+        return CPUStats_Percentile(stats, 100);
+}
+
+double CPUStats_Median(CPUStats_T stats) {
+        return CPUStats_Percentile(stats, 50);
+}
+
+/*
+ *  Sorts a copy, so the samples stay in the order they were taken.
+ *  Uses linear interpolation between the two nearest ranks.
+ */
+double CPUStats_Percentile(CPUStats_T stats, double p) {
+        assert(stats != NULL);
+        assert(p >= 0 && p <= 100);
+        if (stats->count == 0)
+                return 0;
+
+        double *sorted = malloc(stats->count * sizeof(double));
+        assert(sorted != NULL);
+        memcpy(sorted, stats->samples, stats->count * sizeof(double));
+        qsort(sorted, stats->count, sizeof(double), compare_doubles);
+
+        double rank = p / 100 * (stats->count - 1);
+        int below = (int)rank;
+        double result = sorted[below];
+        if (below + 1 < stats->count)
+                result += (rank - below) * (sorted[below + 1] - sorted[below]);
+        free(sorted);
+        return result;
+}
+
+void CPUStats_Print(FILE *fp, CPUStats_T stats) {
+        assert(fp != NULL && stats != NULL);
+        fprintf(fp, "%s (%s clock): %d samples, total %.0f ns, min %.0f, "
+                    "median %.0f, p90 %.0f, p99 %.0f, max %.0f\n",
+                stats->name, CPUTime_ClockName(stats->timer->clock),
+                stats->count, stats->total, CPUStats_Min(stats),
+                CPUStats_Median(stats), CPUStats_Percentile(stats, 90),
+                CPUStats_Percentile(stats, 99), CPUStats_Max(stats));
+}
+
+int CPUStats_RejectOutliers(CPUStats_T stats) {
+        assert(stats != NULL);
+        if (stats->count < 4)
+                return 0;
+
+        double q1 = CPUStats_Percentile(stats, 25);
+        double q3 = CPUStats_Percentile(stats, 75);
+        double low = q1 - 1.5 * (q3 - q1);
+        double high = q3 + 1.5 * (q3 - q1);
+
+        int kept = 0;
+        stats->total = 0;
+        for (int i = 0; i < stats->count; i++) {
+                double ns = stats->samples[i];
+                if (ns < low || ns > high)
+                        continue;
+                stats->samples[kept++] = ns;
+                stats->total += ns;
+        }
+        int dropped = stats->count - kept;
+        stats->count = kept;
+        return dropped;
+}
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+ *     Benchmark controls
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+int CPUTime_PinCPUs(const char *cpus) {
+        assert(cpus != NULL);
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        const char *p = cpus;
+        while (*p != '\0') {
+                char *end;
+                long first = strtol(p, &end, 10);
+                long last = first;
+                if (end == p || first < 0)
+                        return -1;
+                if (*end == '-') {
+                        p = end + 1;
+                        last = strtol(p, &end, 10);
+                        if (end == p || last < first)
+                                return -1;
+                }
+                if (last >= CPU_SETSIZE || (*end != ',' && *end != '\0'))
+                        return -1;
+                for (long cpu = first; cpu <= last; cpu++)
+                        CPU_SET(cpu, &set);
+                p = (*end == ',') ? end + 1 : end;
+        }
+        if (CPU_COUNT(&set) == 0)
+                return -1;
+        return sched_setaffinity(0, sizeof(set), &set) == 0 ? 0 : -1;
+#else
+        return -1;
+#endif
+}
+
+/*
+ *  The buffer is allocated on first use and kept, so repeated
+ *  flushes cost only the sweep itself.  Writing every cache line
+ *  pushes out whatever was cached, dirty lines included; the sum
+ *  read back keeps the compiler from dropping the sweep.
+ */
+void CPUTime_FlushCaches(void) {
+        static unsigned char *buffer = NULL;
+        static size_t size = 0;
+
+        if (buffer == NULL) {
+                long llc = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+                llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+                if (llc <= 0)
+                        llc = FLUSH_DEFAULT_LLC;
+                size = 2 * (size_t)llc;
+                buffer = malloc(size);
+                assert(buffer != NULL);
+        }
+
+        static unsigned char pass = 0;
+        pass++;
+        for (size_t i = 0; i < size; i += 64)
+                buffer[i] = pass;
+        unsigned char sum = 0;
+        for (size_t i = 0; i < size; i += 64)
+                sum += buffer[i];
+        flush_sink = sum;
+}
+
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
  *     Utility functions called internally
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
@@ -88,32 +478,35 @@ double CPUTime_Stop(CPUTime_T startTimep) {
  *  http://www.gnu.org/software/libc/manual/html_node/Elapsed-Time.html
  */
 static int
-timespec_subtract (result, x, y)
-struct timespec *result, *x, *y;
+timespec_subtract (result, x, yp)
+struct timespec *result, *x, *yp;
 {
         int nsec;
-        /* Perform the carry for the later subtraction by updating y. */
-        if (x->tv_nsec < y->tv_nsec) {
-                nsec = (y->tv_nsec - x->tv_nsec) / 1000000000 + 1;
-                y->tv_nsec -= 1000000000 * nsec;
-                y->tv_sec += nsec;
+        /* Perform the carry for the later subtraction by updating a
+           copy of y, so the caller's start time is left alone and a
+           timer can be stopped more than once. */
+        struct timespec y = *yp;
+        if (x->tv_nsec < y.tv_nsec) {
+                nsec = (y.tv_nsec - x->tv_nsec) / 1000000000 + 1;
+                y.tv_nsec -= 1000000000 * nsec;
+                y.tv_sec += nsec;
         }
-        if (x->tv_nsec - y->tv_nsec > 1000000000) {
-                nsec = (x->tv_nsec - y->tv_nsec) / 1000000000;
-                y->tv_nsec += 1000000000 * nsec;
-                y->tv_sec -= nsec;
+        if (x->tv_nsec - y.tv_nsec > 1000000000) {
+                nsec = (x->tv_nsec - y.tv_nsec) / 1000000000;
+                y.tv_nsec += 1000000000 * nsec;
+                y.tv_sec -= nsec;
         }
 
         /* Compute the time remaining to wait.
            tv_nsec is certainly positive. */
-        result->tv_sec = x->tv_sec - y->tv_sec;
-        result->tv_nsec = x->tv_nsec - y->tv_nsec;
+        result->tv_sec = x->tv_sec - y.tv_sec;
+        result->tv_nsec = x->tv_nsec - y.tv_nsec;
 
         /* Assert added by Noah */
         assert(result->tv_nsec < 1000000000);
 
         /* Return 1 if result is negative. */
-        return x->tv_sec < y->tv_sec;
+        return x->tv_sec < y.tv_sec;
 }
 
 
@@ -135,3 +528,59 @@ timespec_to_double(struct timespec *ts) {
                         ts->tv_nsec;
 
 }
+
+/*
+ *                 read_counter
+ *
+ *     Read a running perf counter, scaled up by enabled/running time
+ *     in case the kernel multiplexed it with other events.  Since
+ *     counters run from the moment they are opened, a region's
+ *     count is the difference of two reads.
+ */
+
+static double
+read_counter(int fd) {
+        unsigned long long values[3];   /* value, enabled, running */
+        if (read(fd, values, sizeof(values)) != (ssize_t)sizeof(values))
+                return 0;
+        if (values[2] == 0)
+                return 0;
+        return (double)values[0] * ((double)values[1] / values[2]);
+}
+
+static clockid_t
+clock_id(CPUTime_Clock clock) {
+        switch (clock) {
+        case CPUTIME_WALL:
+                return CLOCK_MONOTONIC;
+        case CPUTIME_THREAD:
+                return CLOCK_THREAD_CPUTIME_ID;
+        default:
+                return CLOCK_PROCESS_CPUTIME_ID;
+        }
+}
+
+/*
+ *                 read_tsc
+ *
+ *     The time stamp counter, or monotonic nanoseconds where there
+ *     is none.
+ */
+
+static unsigned long long
+read_tsc(void) {
+#ifdef HAVE_TSC
+        return __builtin_ia32_rdtsc();
+#else
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (unsigned long long)now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
+
+static int
+compare_doubles(const void *a, const void *b) {
+        double x = *(const double *)a;
+        double y = *(const double *)b;
+        return (x > y) - (x < y);
+}
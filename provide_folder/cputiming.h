@@ -28,12 +28,72 @@
  *
  *****************************************************************/
 
+#ifndef CPUTIMING_INCLUDED
+#define CPUTIMING_INCLUDED
+
+#include <stdio.h>
+
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
  *                   Type definitions
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 typedef struct CPU_Time *CPUTime_T;
 
+/*
+ *       The clock a timer reads.  CPUTime_New uses
+ *       CPUTIME_PROCESS, the CPU time of all threads in the
+ *       process, which is what this interface has always measured.
+ *
+ *       CPUTIME_WALL    monotonic elapsed (wall clock) time
+ *       CPUTIME_THREAD  CPU time of the calling thread only; such a
+ *                       timer must be started and stopped on the
+ *                       same thread
+ *       CPUTIME_TSC     the processor's time stamp counter, for
+ *                       regions too short for the other clocks.
+ *                       Results are still in nanoseconds, converted
+ *                       with a frequency calibrated once against
+ *                       CPUTIME_WALL (see CPUTime_TSCFrequency).
+ *                       Where there is no TSC this is CPUTIME_WALL.
+ */
+typedef enum CPUTime_Clock {
+        CPUTIME_PROCESS = 0,
+        CPUTIME_WALL,
+        CPUTIME_THREAD,
+        CPUTIME_TSC
+} CPUTime_Clock;
+
+/*
+ *       CPUStats_T is an accumulating timer: it can be started and
+ *       stopped any number of times, keeps every sample, and
+ *       summarizes them.
+ *
+ *       CPUStats_T stats = CPUStats_New("transform", CPUTIME_WALL);
+ *       for (...) {
+ *               CPUStats_Start(stats);
+ *                 ... Do work to be timed here
+ *               CPUStats_Stop(stats);
+ *       }
+ *       double p90 = CPUStats_Percentile(stats, 90);
+ *       CPUStats_Print(stdout, stats);
+ *       CPUStats_Free(&stats);
+ */
+typedef struct CPU_Stats *CPUStats_T;
+
+/*
+ *       Hardware performance counters that a timer can also
+ *       report for the region between CPUTime_Start and
+ *       CPUTime_Stop (see CPUTime_EnableCounters below).
+ */
+typedef enum CPUTime_Counter {
+        CPUTIME_CYCLES = 0,
+        CPUTIME_INSTRUCTIONS,
+        CPUTIME_L1D_MISSES,         /* L1 data cache read misses  */
+        CPUTIME_LLC_MISSES,         /* last level cache read misses */
+        CPUTIME_DTLB_MISSES,        /* data TLB read misses */
+        CPUTIME_BRANCH_MISSES,
+        CPUTIME_NCOUNTERS
+} CPUTime_Counter;
+
 /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
  *              Functions implementing the CPUTime interface
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
@@ -48,3 +108,110 @@ void CPUTime_Start(CPUTime_T StartTimep) ;
 
 double CPUTime_Stop(CPUTime_T startTimep) ;
 
+CPUTime_T CPUTime_NewWithClock(CPUTime_Clock clock);
+
+CPUTime_Clock CPUTime_GetClock(CPUTime_T timer);
+
+const char *CPUTime_ClockName(CPUTime_Clock clock);
+
+/*
+ *       Raw time stamp counter ticks of the last timed region of a
+ *       CPUTIME_TSC timer (0 for other clocks), and the calibrated
+ *       number of ticks per second.
+ */
+double CPUTime_Ticks(CPUTime_T timer);
+
+double CPUTime_TSCFrequency(void);
+
+/*
+ *       Counter support (Linux perf_event_open).  After
+ *
+ *           CPUTime_EnableCounters(timer);
+ *
+ *       every CPUTime_Start/CPUTime_Stop pair also counts the
+ *       events above in this process and in threads it creates
+ *       while the counters are enabled, and
+ *
+ *           double misses = CPUTime_Count(timer, CPUTIME_L1D_MISSES);
+ *
+ *       returns the count for the last timed region.  Counters the
+ *       machine or kernel will not provide (no PMU in a VM,
+ *       perf_event_paranoid, non-Linux systems) are simply left
+ *       out: CPUTime_Count returns -1 for them and timing works
+ *       as before.  Counts are scaled up if the kernel had to
+ *       multiplex the counters.
+ *
+ *       CPUTime_EnableCounters returns how many counters are
+ *       actually available (0 to CPUTIME_NCOUNTERS).
+ */
+
+int CPUTime_EnableCounters(CPUTime_T timer);
+
+double CPUTime_Count(CPUTime_T timer, CPUTime_Counter which);
+
+const char *CPUTime_CounterName(CPUTime_Counter which);
+
+/*
+ *       Benchmark controls.  CPUTime_PinCPUs keeps the process, and
+ *       threads it creates afterwards, on a list of CPUs such as "2"
+ *       or "0,2-3", so that repeated runs see the same cores and
+ *       caches.  It returns 0, or -1 if the list is malformed or the
+ *       system refuses (always, on systems other than Linux).
+ *
+ *       CPUTime_FlushCaches writes and then reads a buffer twice
+ *       the size of the last level cache, so that the next timed
+ *       region starts with cold caches.  The buffer is kept for
+ *       later flushes, so it shows up in the peak RSS.
+ */
+
+int CPUTime_PinCPUs(const char *cpus);
+
+void CPUTime_FlushCaches(void);
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+ *              Functions implementing the CPUStats interface
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+/*
+ *       All results are in nanoseconds.  Percentile takes p from 0
+ *       to 100 and interpolates between samples; Percentile 50 is
+ *       the median.  Summaries of a timer with no samples are 0.
+ *       CPUStats_Print writes one line: the name, the clock, the
+ *       number of samples, total, min, median, 90th and 99th
+ *       percentiles, and max.
+ *
+ *       CPUStats_RejectOutliers drops the samples outside Tukey's
+ *       fences (more than 1.5 interquartile ranges beyond the first
+ *       or third quartile) and returns how many it dropped; every
+ *       summary after that, total included, uses what is left.
+ */
+
+CPUStats_T CPUStats_New(const char *name, CPUTime_Clock clock);
+
+void CPUStats_Free(CPUStats_T *stats);
+
+void CPUStats_Start(CPUStats_T stats);
+
+double CPUStats_Stop(CPUStats_T stats);
+
+void CPUStats_Add(CPUStats_T stats, double nanoseconds);
+
+const char *CPUStats_Name(CPUStats_T stats);
+
+int CPUStats_Count(CPUStats_T stats);
+
+double CPUStats_Total(CPUStats_T stats);
+
+double CPUStats_Min(CPUStats_T stats);
+
+double CPUStats_Max(CPUStats_T stats);
+
+double CPUStats_Median(CPUStats_T stats);
+
+double CPUStats_Percentile(CPUStats_T stats, double p);
+
+void CPUStats_Print(FILE *fp, CPUStats_T stats);
+
+int CPUStats_RejectOutliers(CPUStats_T stats);
+
+#endif /* CPUTIMING_INCLUDED */
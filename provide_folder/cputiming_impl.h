@@ -32,5 +32,20 @@
 #include "cputiming.h"
 
 struct CPU_Time {
+        CPUTime_Clock clock;
         struct timespec time;
+        unsigned long long ticks;                /* CPUTIME_TSC start */
+        double lastticks;                        /* last timed region */
+        int    counterfd[CPUTIME_NCOUNTERS];     /* -1 if not counting */
+        double startcount[CPUTIME_NCOUNTERS];
+        double count[CPUTIME_NCOUNTERS];         /* last timed region */
+};
+
+struct CPU_Stats {
+        char     *name;
+        CPUTime_T timer;
+        double   *samples;                       /* in the order taken */
+        int       count;
+        int       capacity;
+        double    total;
 };
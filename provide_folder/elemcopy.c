@@ -0,0 +1,118 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** elemcopy.c
+ ** 19 October 2026
+ **
+ ** Purpose: copiers for array elements of each common size (a Pnm_rgb
+ **          is 12 bytes, a compact pixel 6, a gray sample 1 or 2). The
+ **          size of each copy is a constant the compiler turns into a few
+ **          wide loads and stores; elements of other sizes are moved with
+ **          memcpy of a size it cannot see.
+ **/
+
+#include <string.h>
+
+#include "assert.h"
+#include "elemcopy.h"
+
+#define T ElemCopy_T
+
+/* @function: DEFINE_COPIER
+ * @purpose: define the copy, copy_span and swap of elements of SIZE
+ *           bytes, and the copier NAME made of them. memcpy of a constant
+ *           size is a few loads and stores, with no call, and unlike a
+ *           struct assignment it may move elements of any type.
+ */
+#define DEFINE_COPIER(NAME, SIZE)                                       \
+static void NAME##_copy(void *dst, const void *src, int size)          \
+{                                                                       \
+    (void) size;                                                        \
+    memcpy(dst, src, SIZE);                                             \
+}                                                                       \
+                                                                        \
+static void NAME##_copy_span(void *dst, const void *src, int n,        \
+                             long step, int size)                       \
+{                                                                       \
+    (void) size;                                                        \
+    char *out = dst;                                                    \
+    const char *in = src;                                               \
+    if (step == SIZE) {                                                 \
+        memcpy(out, in, (size_t)n * SIZE);                              \
+        return;                                                         \
+    }                                                                   \
+    for (int k = 0; k < n; k++, out += SIZE, in += step) {              \
+        memcpy(out, in, SIZE);                                          \
+    }                                                                   \
+}                                                                       \
+                                                                        \
+static void NAME##_swap(void *a, void *b, int size)                    \
+{                                                                       \
+    (void) size;                                                        \
+    unsigned char temp[SIZE];                                           \
+    memcpy(temp, a, SIZE);                                              \
+    memcpy(a, b, SIZE);                                                 \
+    memcpy(b, temp, SIZE);                                              \
+}                                                                       \
+                                                                        \
+static const struct T NAME = {                                          \
+    SIZE, NAME##_copy, NAME##_copy_span, NAME##_swap                    \
+}
+
+DEFINE_COPIER(copier1, 1);
+DEFINE_COPIER(copier2, 2);
+DEFINE_COPIER(copier3, 3);
+DEFINE_COPIER(copier4, 4);
+DEFINE_COPIER(copier6, 6);
+DEFINE_COPIER(copier8, 8);
+DEFINE_COPIER(copier12, 12);
+DEFINE_COPIER(copier16, 16);
+
+/* any other size */
+static void anyCopy(void *dst, const void *src, int size)
+{
+    memcpy(dst, src, size);
+}
+
+static void anyCopySpan(void *dst, const void *src, int n, long step,
+                        int size)
+{
+    char *out = dst;
+    const char *in = src;
+    if (step == size) {
+        memcpy(out, in, (size_t)n * size);
+        return;
+    }
+    for (int k = 0; k < n; k++, out += size, in += step) {
+        memcpy(out, in, size);
+    }
+}
+
+static void anySwap(void *a, void *b, int size)
+{
+    unsigned char *x = a, *y = b;
+    for (int k = 0; k < size; k++) {
+        unsigned char temp = x[k];
+        x[k] = y[k];
+        y[k] = temp;
+    }
+}
+
+static const struct T anySize = { 0, anyCopy, anyCopySpan, anySwap };
+
+extern T ElemCopy_select(int size)
+{
+    assert(size > 0);
+    switch (size) {
+        case 1:  return &copier1;
+        case 2:  return &copier2;
+        case 3:  return &copier3;
+        case 4:  return &copier4;
+        case 6:  return &copier6;
+        case 8:  return &copier8;
+        case 12: return &copier12;
+        case 16: return &copier16;
+        default: return &anySize;
+    }
+}
+
+#undef T
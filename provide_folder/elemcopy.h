@@ -0,0 +1,42 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** elemcopy.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for elemcopy.c, copies and swaps of array
+ **          elements specialized for their size. UArray2 and UArray2b
+ **          pick the copier for their element size when they are made,
+ **          so a copy of a known size is chosen once per array rather
+ **          than memcpy being called with an unknown size per element.
+ **/
+
+#ifndef ELEMCOPY_INCLUDED
+#define ELEMCOPY_INCLUDED
+
+#define T ElemCopy_T
+typedef const struct T *T;
+
+struct T {
+    int size;               /* the size it is for, 0 for any size */
+
+    /* one element from src to dst */
+    void (*copy)(void *dst, const void *src, int size);
+    /* n elements to dst, one after another, from src, src + step,
+     * src + 2 * step ... (step in bytes, and may be negative) */
+    void (*copy_span)(void *dst, const void *src, int n, long step,
+                      int size);
+    /* the elements at a and b */
+    void (*swap)(void *a, void *b, int size);
+};
+
+/* @function: ElemCopy_select
+ * @purpose: return the copier for elements of size bytes: one made for
+ *           that size if it is 1, 2, 3, 4, 6, 8, 12 or 16, and one that
+ *           takes any size otherwise. Each function is passed the size.
+ *
+ * @precondition: size is > 0
+ */
+extern T ElemCopy_select(int size);
+
+#undef T
+#endif /* ELEMCOPY_INCLUDED */
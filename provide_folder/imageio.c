@@ -0,0 +1,637 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** imageio.c
+ ** 18 October 2026
+ **
+ ** Purpose: buffered byte I/O for image files, with a plain
+ **          read(2)/write(2) backend and an io_uring backend.
+ **
+ **          The io_uring backend splits the file into NSLOTS large
+ **          buffers. While reading, every free buffer has a read of the
+ **          next part of the file in flight, so the disk is working ahead
+ **          of the client; while writing, full buffers are handed to the
+ **          kernel and the client keeps filling the next one. The
+ **          buffers are registered with the ring when the memlock limit
+ **          allows it, which saves the kernel from mapping them on every
+ **          request. The ring is driven with raw system calls so no
+ **          extra library is needed.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "assert.h"
+#include "imageio.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#ifdef __NR_io_uring_setup
+#include <linux/io_uring.h>
+#define HAVE_IO_URING 1
+#endif
+#endif
+
+#define T ImageIO_T
+
+#define PLAIN_BYTES (64 * 1024)     /* buffer for the plain backend */
+#define NSLOTS 4                    /* io_uring requests in flight */
+#define SLOT_BYTES (1024 * 1024)    /* bytes per io_uring request */
+
+/********** struct definitions **********/
+
+enum { SLOT_FREE, SLOT_BUSY, SLOT_DONE };
+
+struct Slot {
+    unsigned char *data;
+    struct iovec iov;       /* used when the buffers are not registered */
+    size_t length;          /* bytes requested (or buffered, writing) */
+    size_t used;            /* bytes handed to the client (reading) */
+    off_t offset;           /* where in the file the bytes belong */
+    long result;            /* bytes done by the kernel, or -errno */
+    int state;
+};
+
+#ifdef HAVE_IO_URING
+struct Ring {
+    int fd;
+    int fixed;              /* buffers registered with the ring */
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sqMap, *cqMap;
+    size_t sqMapBytes, cqMapBytes, sqesBytes;
+};
+#endif
+
+struct T {
+    int fd;
+    int writing;
+    int failed;
+    ImageIO_Backend backend;
+
+    /* plain backend */
+    unsigned char *buffer;
+    size_t length;          /* valid bytes (reading) or buffered bytes */
+    size_t used;            /* bytes handed to the client (reading) */
+
+    /* io_uring backend */
+#ifdef HAVE_IO_URING
+    struct Ring ring;
+#endif
+    struct Slot slots[NSLOTS];
+    int current;            /* slot the client is reading or filling */
+    off_t nextOffset;       /* file offset of the next request */
+    off_t fileSize;         /* reading: bytes in the file */
+};
+
+/*************** plain backend ***************/
+
+/* @function: writeAll
+ * @purpose: write n bytes at the current position, riding out short
+ *           writes and interrupts
+ * @returns: 0 on success, -1 on error
+ */
+static int writeAll(int fd, const unsigned char *p, size_t n)
+{
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0 && errno == EINTR) {
+            continue;
+        }
+        if (w <= 0) {
+            return -1;
+        }
+        p += w;
+        n -= w;
+    }
+    return 0;
+}
+
+static size_t plainRead(T io, unsigned char *dst, size_t n)
+{
+    size_t done = 0;
+    while (done < n && !io->failed) {
+        if (io->used == io->length) {
+            /* big requests bypass the buffer */
+            if (n - done >= PLAIN_BYTES) {
+                ssize_t r = read(io->fd, dst + done, n - done);
+                if (r < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (r <= 0) {
+                    io->failed = r < 0;
+                    break;
+                }
+                done += r;
+                continue;
+            }
+            ssize_t r = read(io->fd, io->buffer, PLAIN_BYTES);
+            if (r < 0 && errno == EINTR) {
+                continue;
+            }
+            if (r <= 0) {
+                io->failed = r < 0;
+                break;
+            }
+            io->length = r;
+            io->used = 0;
+        }
+
+        size_t chunk = io->length - io->used;
+        if (chunk > n - done) {
+            chunk = n - done;
+        }
+        memcpy(dst + done, io->buffer + io->used, chunk);
+        io->used += chunk;
+        done += chunk;
+    }
+    return done;
+}
+
+static int plainWrite(T io, const unsigned char *src, size_t n)
+{
+    if (io->length + n > PLAIN_BYTES) {
+        if (writeAll(io->fd, io->buffer, io->length) != 0) {
+            io->failed = 1;
+        }
+        io->length = 0;
+        if (n >= PLAIN_BYTES) {
+            if (writeAll(io->fd, src, n) != 0) {
+                io->failed = 1;
+            }
+            return io->failed ? -1 : 0;
+        }
+    }
+    memcpy(io->buffer + io->length, src, n);
+    io->length += n;
+    return io->failed ? -1 : 0;
+}
+
+/*************** io_uring backend ***************/
+
+#ifdef HAVE_IO_URING
+
+/* @function: ringSetup
+ * @purpose: create a ring with room for NSLOTS requests, map its queues,
+ *           and try to register the slot buffers with it
+ * @returns: 0 on success, -1 if io_uring cannot be used
+ */
+static int ringSetup(T io)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int fd = syscall(__NR_io_uring_setup, NSLOTS, &params);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct Ring *ring = &io->ring;
+    ring->fd = fd;
+    ring->sqMapBytes = params.sq_off.array
+                       + params.sq_entries * sizeof(unsigned);
+    ring->cqMapBytes = params.cq_off.cqes
+                       + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cqMapBytes > ring->sqMapBytes) {
+            ring->sqMapBytes = ring->cqMapBytes;
+        }
+        ring->cqMapBytes = ring->sqMapBytes;
+    }
+
+    ring->sqMap = mmap(NULL, ring->sqMapBytes, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sqMap == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cqMap = ring->sqMap;
+    } else {
+        ring->cqMap = mmap(NULL, ring->cqMapBytes, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, fd,
+                           IORING_OFF_CQ_RING);
+        if (ring->cqMap == MAP_FAILED) {
+            munmap(ring->sqMap, ring->sqMapBytes);
+            close(fd);
+            return -1;
+        }
+    }
+
+    ring->sqesBytes = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqesBytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        if (ring->cqMap != ring->sqMap) {
+            munmap(ring->cqMap, ring->cqMapBytes);
+        }
+        munmap(ring->sqMap, ring->sqMapBytes);
+        close(fd);
+        return -1;
+    }
+
+    char *sq = ring->sqMap;
+    char *cq = ring->cqMap;
+    ring->sqHead  = (unsigned *)(sq + params.sq_off.head);
+    ring->sqTail  = (unsigned *)(sq + params.sq_off.tail);
+    ring->sqMask  = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned *)(sq + params.sq_off.array);
+    ring->cqHead  = (unsigned *)(cq + params.cq_off.head);
+    ring->cqTail  = (unsigned *)(cq + params.cq_off.tail);
+    ring->cqMask  = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes    = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    /* registering pins the buffers, which RLIMIT_MEMLOCK may forbid;
+     * unregistered vectored requests work on every io_uring kernel
+     */
+    struct iovec iovs[NSLOTS];
+    for (int i = 0; i < NSLOTS; i++) {
+        iovs[i].iov_base = io->slots[i].data;
+        iovs[i].iov_len = SLOT_BYTES;
+    }
+    ring->fixed = syscall(__NR_io_uring_register, fd,
+                          IORING_REGISTER_BUFFERS, iovs, NSLOTS) == 0;
+    return 0;
+}
+
+static void ringTeardown(T io)
+{
+    struct Ring *ring = &io->ring;
+    munmap(ring->sqes, ring->sqesBytes);
+    if (ring->cqMap != ring->sqMap) {
+        munmap(ring->cqMap, ring->cqMapBytes);
+    }
+    munmap(ring->sqMap, ring->sqMapBytes);
+    close(ring->fd);
+}
+
+/* @function: ringSubmit
+ * @purpose: queue a read or write of slot i and tell the kernel about it
+ */
+static void ringSubmit(T io, int i)
+{
+    struct Ring *ring = &io->ring;
+    struct Slot *slot = &io->slots[i];
+
+    unsigned tail = *ring->sqTail;
+    unsigned index = tail & *ring->sqMask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+
+    if (ring->fixed) {
+        sqe->opcode = io->writing ? IORING_OP_WRITE_FIXED
+                                  : IORING_OP_READ_FIXED;
+        sqe->addr = (unsigned long)slot->data;
+        sqe->len = slot->length;
+        sqe->buf_index = i;
+    } else {
+        sqe->opcode = io->writing ? IORING_OP_WRITEV : IORING_OP_READV;
+        slot->iov.iov_base = slot->data;
+        slot->iov.iov_len = slot->length;
+        sqe->addr = (unsigned long)&slot->iov;
+        sqe->len = 1;
+    }
+    sqe->fd = io->fd;
+    sqe->off = slot->offset;
+    sqe->user_data = i;
+
+    ring->sqArray[index] = index;
+    __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+    slot->state = SLOT_BUSY;
+
+    while (syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0) < 0) {
+        if (errno != EINTR && errno != EAGAIN) {
+            slot->state = SLOT_DONE;
+            slot->result = -errno;
+            return;
+        }
+    }
+}
+
+/* @function: ringWait
+ * @purpose: collect completions until slot i is done, then finish any
+ *           short transfer synchronously so the slot is all there
+ */
+static void ringWait(T io, int i)
+{
+    struct Ring *ring = &io->ring;
+    struct Slot *slot = &io->slots[i];
+
+    while (slot->state == SLOT_BUSY) {
+        unsigned head = *ring->cqHead;
+        unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            if (syscall(__NR_io_uring_enter, ring->fd, 0, 1,
+                        IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+                errno != EINTR) {
+                slot->state = SLOT_DONE;
+                slot->result = -errno;
+            }
+            continue;
+        }
+        while (head != tail) {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cqMask];
+            struct Slot *done = &io->slots[cqe->user_data];
+            done->result = cqe->res;
+            done->state = SLOT_DONE;
+            head++;
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    if (slot->result < 0) {
+        io->failed = 1;
+        return;
+    }
+    size_t got = slot->result;
+    while (got < slot->length) {
+        ssize_t n = io->writing
+            ? pwrite(io->fd, slot->data + got, slot->length - got,
+                     slot->offset + got)
+            : pread(io->fd, slot->data + got, slot->length - got,
+                    slot->offset + got);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        got += n;
+    }
+    if (got < slot->length) {
+        if (io->writing) {
+            io->failed = 1;
+        }
+        slot->length = got;     /* the file shrank while being read */
+    }
+}
+
+/* @function: ringStartRead
+ * @purpose: put slot i to work on the next part of the file, if any
+ */
+static void ringStartRead(T io, int i)
+{
+    struct Slot *slot = &io->slots[i];
+    slot->used = 0;
+    if (io->nextOffset >= io->fileSize) {
+        slot->state = SLOT_FREE;
+        slot->length = 0;
+        return;
+    }
+    slot->offset = io->nextOffset;
+    slot->length = SLOT_BYTES;
+    if (io->fileSize - io->nextOffset < SLOT_BYTES) {
+        slot->length = io->fileSize - io->nextOffset;
+    }
+    io->nextOffset += slot->length;
+    ringSubmit(io, i);
+}
+
+static size_t ringRead(T io, unsigned char *dst, size_t n)
+{
+    size_t done = 0;
+    while (done < n && !io->failed) {
+        struct Slot *slot = &io->slots[io->current];
+        if (slot->state == SLOT_FREE) {
+            break;                          /* end of file */
+        }
+        if (slot->state == SLOT_BUSY) {
+            ringWait(io, io->current);
+            continue;
+        }
+
+        size_t chunk = slot->length - slot->used;
+        if (chunk > n - done) {
+            chunk = n - done;
+        }
+        memcpy(dst + done, slot->data + slot->used, chunk);
+        slot->used += chunk;
+        done += chunk;
+
+        if (slot->used == slot->length) {
+            if (slot->length < SLOT_BYTES &&
+                slot->offset + (off_t)slot->length < io->fileSize) {
+                io->nextOffset = io->fileSize;  /* truncated: stop */
+            }
+            ringStartRead(io, io->current);
+            io->current = (io->current + 1) % NSLOTS;
+        }
+    }
+    return done;
+}
+
+/* @function: ringFlushSlot
+ * @purpose: hand the current slot's buffered bytes to the kernel and
+ *           move on to the next slot. Only a slot being filled is
+ *           handed over: one still busy or done with an earlier write
+ *           (the current slot once the output ends on a slot boundary)
+ *           holds bytes already written, and its offset is still needed
+ *           to finish a short write.
+ */
+static void ringFlushSlot(T io)
+{
+    struct Slot *slot = &io->slots[io->current];
+    if (slot->state != SLOT_FREE || slot->length == 0) {
+        return;
+    }
+    slot->offset = io->nextOffset;
+    io->nextOffset += slot->length;
+    ringSubmit(io, io->current);
+    io->current = (io->current + 1) % NSLOTS;
+}
+
+static int ringWrite(T io, const unsigned char *src, size_t n)
+{
+    while (n > 0 && !io->failed) {
+        struct Slot *slot = &io->slots[io->current];
+        if (slot->state == SLOT_BUSY) {
+            ringWait(io, io->current);
+        }
+        if (slot->state == SLOT_DONE) {
+            slot->state = SLOT_FREE;
+            slot->length = 0;
+        }
+
+        size_t chunk = SLOT_BYTES - slot->length;
+        if (chunk > n) {
+            chunk = n;
+        }
+        memcpy(slot->data + slot->length, src, chunk);
+        slot->length += chunk;
+        src += chunk;
+        n -= chunk;
+        if (slot->length == SLOT_BYTES) {
+            ringFlushSlot(io);
+        }
+    }
+    return io->failed ? -1 : 0;
+}
+
+/* @function: ringUsable
+ * @purpose: io_uring is only worth it (and only keeps the bytes in
+ *           order) for regular files written at explicit offsets
+ */
+static int ringUsable(int fd, int forWriting)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return 0;
+    }
+    if (forWriting && (fcntl(fd, F_GETFL) & O_APPEND)) {
+        return 0;
+    }
+    return lseek(fd, 0, SEEK_CUR) >= 0;
+}
+
+#endif /* HAVE_IO_URING */
+
+/*************** interface ***************/
+
+/* @function: ImageIO_new
+ * @purpose: start buffered reading from or writing to fd, using io_uring
+ *           when it is wanted and usable and plain calls otherwise
+ *
+ * @parameters: 1) int fd, the file descriptor (it is not closed)
+ *              2) int forWriting, nonzero to write, zero to read
+ *              3) ImageIO_Backend wanted, the backend to try first
+ * @returns: type T
+ */
+extern T ImageIO_new(int fd, int forWriting, ImageIO_Backend wanted)
+{
+    assert(fd >= 0);
+
+    T io = calloc(1, sizeof(*io));
+    assert(io != NULL);
+    io->fd = fd;
+    io->writing = forWriting;
+    io->backend = IMAGEIO_PLAIN;
+
+#ifdef HAVE_IO_URING
+    if (wanted == IMAGEIO_URING && ringUsable(fd, forWriting)) {
+        int ok = 1;
+        for (int i = 0; i < NSLOTS && ok; i++) {
+            void *data = NULL;
+            ok = posix_memalign(&data, 4096, SLOT_BYTES) == 0;
+            io->slots[i].data = data;
+        }
+        if (ok && ringSetup(io) == 0) {
+            io->backend = IMAGEIO_URING;
+            io->nextOffset = lseek(fd, 0, SEEK_CUR);
+            if (!forWriting) {
+                struct stat st;
+                fstat(fd, &st);
+                io->fileSize = st.st_size;
+                for (int i = 0; i < NSLOTS; i++) {
+                    ringStartRead(io, i);
+                }
+            }
+            return io;
+        }
+        for (int i = 0; i < NSLOTS; i++) {
+            free(io->slots[i].data);
+            io->slots[i].data = NULL;
+        }
+    }
+#else
+    (void) wanted;
+#endif
+
+    io->buffer = malloc(PLAIN_BYTES);
+    assert(io->buffer != NULL);
+    return io;
+}
+
+/* @function: ImageIO_free
+ * @purpose: flush any buffered output, wait for requests still in
+ *           flight, and deallocate the I/O state
+ *
+ * @parameters: T *io, the state to free
+ * @returns: 0 on success, -1 if some write failed
+ */
+extern int ImageIO_free(T *io)
+{
+    assert(io != NULL && *io != NULL);
+    T p = *io;
+
+    if (p->backend == IMAGEIO_PLAIN) {
+        if (p->writing && p->length > 0 &&
+            writeAll(p->fd, p->buffer, p->length) != 0) {
+            p->failed = 1;
+        }
+        free(p->buffer);
+    }
+#ifdef HAVE_IO_URING
+    else {
+        if (p->writing) {
+            ringFlushSlot(p);
+        }
+        for (int i = 0; i < NSLOTS; i++) {
+            if (p->slots[i].state == SLOT_BUSY) {
+                ringWait(p, i);
+            }
+        }
+        if (p->writing) {
+            /* leave the file position where plain writes would have */
+            lseek(p->fd, p->nextOffset, SEEK_SET);
+        }
+        ringTeardown(p);
+        for (int i = 0; i < NSLOTS; i++) {
+            free(p->slots[i].data);
+        }
+    }
+#endif
+
+    int result = p->failed ? -1 : 0;
+    free(p);
+    *io = NULL;
+    return result;
+}
+
+extern ImageIO_Backend ImageIO_backend(T io)
+{
+    assert(io != NULL);
+    return io->backend;
+}
+
+/* @function: ImageIO_read
+ * @purpose: copy the next n bytes of input into buf
+ * @returns: the number of bytes copied, less than n only at the end of
+ *           the input or on an error
+ */
+extern size_t ImageIO_read(T io, void *buf, size_t n)
+{
+    assert(io != NULL && !io->writing);
+    assert(buf != NULL || n == 0);
+#ifdef HAVE_IO_URING
+    if (io->backend == IMAGEIO_URING) {
+        return ringRead(io, buf, n);
+    }
+#endif
+    return plainRead(io, buf, n);
+}
+
+/* @function: ImageIO_write
+ * @purpose: append n bytes from buf to the output
+ * @returns: 0 on success, -1 if a write has failed
+ */
+extern int ImageIO_write(T io, const void *buf, size_t n)
+{
+    assert(io != NULL && io->writing);
+    assert(buf != NULL || n == 0);
+#ifdef HAVE_IO_URING
+    if (io->backend == IMAGEIO_URING) {
+        return ringWrite(io, buf, n);
+    }
+#endif
+    return plainWrite(io, buf, n);
+}
+
+#undef T
@@ -0,0 +1,77 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** imageio.h
+ ** 18 October 2026
+ **
+ ** Purpose: public interface for imageio.c, the buffered byte I/O used to
+ **          read and write image files. Two backends are provided: plain
+ **          read(2)/write(2), and on Linux an io_uring backend that keeps
+ **          several large reads or writes in flight into registered
+ **          buffers. If io_uring is not available (old kernel, seccomp,
+ **          not a regular file) the plain backend is used instead.
+ **/
+
+#ifndef IMAGEIO_INCLUDED
+#define IMAGEIO_INCLUDED
+
+#include <stddef.h>
+
+typedef enum ImageIO_Backend {
+    IMAGEIO_PLAIN = 0,
+    IMAGEIO_URING
+} ImageIO_Backend;
+
+#define T ImageIO_T
+typedef struct T *T;
+
+/* @function: ImageIO_new
+ * @purpose: start buffered reading from or writing to fd
+ *
+ * @precondition: fd is open, and nothing has been read from it through
+ *                stdio (or written to it and not flushed)
+ * @postcondition: new type T has been created and returned; the backend
+ *                 in use may be plain even if io_uring was asked for
+ *
+ * @parameters: 1) int fd, the file descriptor (it is not closed)
+ *              2) int forWriting, nonzero to write, zero to read
+ *              3) ImageIO_Backend wanted, the backend to try first
+ * @returns: type T
+ */
+extern T ImageIO_new(int fd, int forWriting, ImageIO_Backend wanted);
+
+/* @function: ImageIO_free
+ * @purpose: flush any buffered output and deallocate the I/O state
+ *
+ * @parameters: T *io, the state to free
+ * @returns: 0 on success, -1 if some write failed
+ */
+extern int ImageIO_free(T *io);
+
+/* @function: ImageIO_backend
+ * @purpose: return the backend actually in use
+ */
+extern ImageIO_Backend ImageIO_backend(T io);
+
+/* @function: ImageIO_read
+ * @purpose: copy the next n bytes of input into buf
+ *
+ * @parameters: 1) T io, opened for reading
+ *              2) void *buf, where the bytes go
+ *              3) size_t n, how many bytes are wanted
+ * @returns: the number of bytes copied, which is less than n only at the
+ *           end of the input or on an error
+ */
+extern size_t ImageIO_read(T io, void *buf, size_t n);
+
+/* @function: ImageIO_write
+ * @purpose: append n bytes from buf to the output
+ *
+ * @parameters: 1) T io, opened for writing
+ *              2) const void *buf, the bytes
+ *              3) size_t n, how many bytes
+ * @returns: 0 on success, -1 if a write has failed
+ */
+extern int ImageIO_write(T io, const void *buf, size_t n);
+
+#undef T
+#endif /* IMAGEIO_INCLUDED */
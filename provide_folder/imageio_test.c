@@ -0,0 +1,66 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "assert.h"
+#include "imageio.h"
+
+#define MIB (1024 * 1024)
+#define PIECE 65536
+
+static unsigned char pattern(size_t at)
+{
+        return (unsigned char)(at * 7 + at / 251);
+}
+
+/* write size bytes through backend in pieces, then read them back: the
+ * file must hold exactly those bytes, whatever multiple of the io_uring
+ * slot size it is */
+static void test_size(size_t size, ImageIO_Backend backend)
+{
+        static unsigned char piece[PIECE];
+        FILE *fp = tmpfile();
+        assert(fp != NULL);
+        int fd = fileno(fp);
+
+        ImageIO_T io = ImageIO_new(fd, 1, backend);
+        for (size_t at = 0; at < size; at += PIECE) {
+                size_t n = size - at < PIECE ? size - at : PIECE;
+                for (size_t k = 0; k < n; k++) {
+                        piece[k] = pattern(at + k);
+                }
+                assert(ImageIO_write(io, piece, n) == 0);
+        }
+        assert(ImageIO_free(&io) == 0);
+        assert(lseek(fd, 0, SEEK_CUR) == (off_t)size);
+        assert(lseek(fd, 0, SEEK_END) == (off_t)size);
+
+        lseek(fd, 0, SEEK_SET);
+        io = ImageIO_new(fd, 0, backend);
+        size_t total = 0, got;
+        while ((got = ImageIO_read(io, piece, PIECE)) > 0) {
+                for (size_t k = 0; k < got; k++) {
+                        assert(piece[k] == pattern(total + k));
+                }
+                total += got;
+        }
+        assert(total == size);
+        assert(ImageIO_free(&io) == 0);
+        fclose(fp);
+}
+
+int main(int argc, char *argv[])
+{
+        (void)argc;
+        (void)argv;
+        size_t sizes[] = { 0, 1, MIB - 1, MIB, 4 * MIB, 5 * MIB,
+                           5 * MIB + 3 };
+        for (int trial = 0; trial < 5; trial++) {
+                for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]);
+                     s++) {
+                        test_size(sizes[s], IMAGEIO_PLAIN);
+                        test_size(sizes[s], IMAGEIO_URING);
+                }
+        }
+        printf("Passed.\n");
+        return 0;
+}
@@ -0,0 +1,208 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** perfbaseline.c
+ ** 18 October 2026
+ **
+ ** Purpose: per-machine benchmark baselines. The file is CSV with a
+ **          header line: the benchmark key, its ns per pixel, then one
+ **          column per hardware counter (per pixel, empty if the machine
+ **          could not count it). A baseline holds a few dozen entries,
+ **          so lookups are a linear search.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "assert.h"
+#include "mem.h"
+#include "cputiming.h"
+#include "perfbaseline.h"
+
+#define T PerfBaseline_T
+#define KEYLEN 128
+#define LINELEN 1024
+
+struct Entry {
+    char key[KEYLEN];
+    double nsPerPixel;
+    double counters[CPUTIME_NCOUNTERS];
+};
+
+struct T {
+    struct Entry *entries;
+    int count, capacity;
+};
+
+extern T PerfBaseline_new(void)
+{
+    T baseline;
+    NEW(baseline);
+    baseline->count = 0;
+    baseline->capacity = 16;
+    baseline->entries = ALLOC(baseline->capacity * sizeof(struct Entry));
+    return baseline;
+}
+
+extern void PerfBaseline_free(T *baseline)
+{
+    assert(baseline != NULL && *baseline != NULL);
+    FREE((*baseline)->entries);
+    FREE(*baseline);
+}
+
+/* @function: find
+ * @purpose: return the entry for key, or NULL
+ */
+static struct Entry *find(T baseline, const char *key)
+{
+    for (int i = 0; i < baseline->count; i++) {
+        if (strcmp(baseline->entries[i].key, key) == 0) {
+            return &baseline->entries[i];
+        }
+    }
+    return NULL;
+}
+
+extern void PerfBaseline_put(T baseline, const char *key, double nsPerPixel,
+                             const double *counters)
+{
+    assert(baseline != NULL && key != NULL && counters != NULL);
+    assert(strlen(key) < KEYLEN && strchr(key, ',') == NULL);
+
+    struct Entry *entry = find(baseline, key);
+    if (entry == NULL) {
+        if (baseline->count == baseline->capacity) {
+            baseline->capacity *= 2;
+            RESIZE(baseline->entries,
+                   baseline->capacity * sizeof(struct Entry));
+        }
+        entry = &baseline->entries[baseline->count++];
+        strcpy(entry->key, key);
+    }
+    entry->nsPerPixel = nsPerPixel;
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        entry->counters[i] = counters[i];
+    }
+}
+
+/* @function: nextField
+ * @purpose: split the next comma separated field off *line
+ *
+ * @returns: the field's value, or -1 if it is empty
+ */
+static double nextField(char **line)
+{
+    char *field = *line;
+    char *comma = strchr(field, ',');
+    if (comma != NULL) {
+        *comma = '\0';
+        *line = comma + 1;
+    } else {
+        *line = field + strlen(field);
+    }
+    char *end;
+    double value = strtod(field, &end);
+    return end == field ? -1 : value;
+}
+
+extern T PerfBaseline_read(const char *path)
+{
+    assert(path != NULL);
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    T baseline = PerfBaseline_new();
+    char line[LINELEN];
+    int header = 1;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (header || line[0] == '\0') {
+            header = 0;
+            continue;
+        }
+        char *rest = strchr(line, ',');
+        if (rest == NULL) {
+            continue;
+        }
+        *rest++ = '\0';
+        double nsPerPixel = nextField(&rest);
+        double counters[CPUTIME_NCOUNTERS];
+        for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+            counters[i] = nextField(&rest);
+        }
+        PerfBaseline_put(baseline, line, nsPerPixel, counters);
+    }
+    fclose(fp);
+    return baseline;
+}
+
+extern int PerfBaseline_write(T baseline, const char *path)
+{
+    assert(baseline != NULL && path != NULL);
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        return -1;
+    }
+
+    fprintf(fp, "key,ns_per_pixel");
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        fprintf(fp, ",%s", CPUTime_CounterName(i));
+    }
+    fprintf(fp, "\n");
+    for (int e = 0; e < baseline->count; e++) {
+        struct Entry *entry = &baseline->entries[e];
+        fprintf(fp, "%s,%.4f", entry->key, entry->nsPerPixel);
+        for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+            fputc(',', fp);
+            if (entry->counters[i] >= 0) {
+                fprintf(fp, "%.4f", entry->counters[i]);
+            }
+        }
+        fprintf(fp, "\n");
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+/* @function: worse
+ * @purpose: return 1 and log it if now is more than tolerance percent
+ *           above then
+ */
+static int worse(const char *key, const char *what, double now, double then,
+                 double tolerance, FILE *log)
+{
+    if (then <= 0 || now <= then * (1 + tolerance / 100)) {
+        return 0;
+    }
+    fprintf(log, "REGRESSION %s: %s per pixel %.3f, baseline %.3f "
+                 "(+%.1f%%, tolerance %.1f%%)\n",
+            key, what, now, then, (now / then - 1) * 100, tolerance);
+    return 1;
+}
+
+extern int PerfBaseline_check(T baseline, const char *key, double nsPerPixel,
+                              const double *counters, double timeTolerance,
+                              double counterTolerance, FILE *log)
+{
+    assert(baseline != NULL && key != NULL && counters != NULL);
+    assert(log != NULL);
+
+    struct Entry *entry = find(baseline, key);
+    if (entry == NULL) {
+        fprintf(log, "no baseline for %s\n", key);
+        return -1;
+    }
+
+    int regressed = worse(key, "ns", nsPerPixel, entry->nsPerPixel,
+                          timeTolerance, log);
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        if (counters[i] >= 0 && entry->counters[i] >= 0) {
+            regressed |= worse(key, CPUTime_CounterName(i), counters[i],
+                               entry->counters[i], counterTolerance, log);
+        }
+    }
+    return regressed;
+}
+
+#undef T
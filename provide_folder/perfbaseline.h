@@ -0,0 +1,76 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** perfbaseline.h
+ ** 18 October 2026
+ **
+ ** Purpose: public interface for perfbaseline.c, a per-machine file of
+ **          benchmark results that later runs are checked against
+ **/
+
+#ifndef PERFBASELINE_INCLUDED
+#define PERFBASELINE_INCLUDED
+
+#include <stdio.h>
+#include "cputiming.h"
+
+#define T PerfBaseline_T
+typedef struct T *T;
+
+/* @function: PerfBaseline_new
+ * @purpose: make an empty baseline, to be filled in and written
+ */
+extern T PerfBaseline_new(void);
+
+/* @function: PerfBaseline_read
+ * @purpose: read a baseline written by PerfBaseline_write
+ *
+ * @returns: type T, or NULL if path cannot be opened
+ */
+extern T PerfBaseline_read(const char *path);
+
+/* @function: PerfBaseline_write
+ * @purpose: write a baseline as CSV, one benchmark per line
+ *
+ * @returns: 0, or -1 if path cannot be written
+ */
+extern int PerfBaseline_write(T baseline, const char *path);
+
+/* @function: PerfBaseline_free
+ * @purpose: deallocate a baseline
+ */
+extern void PerfBaseline_free(T *baseline);
+
+/* @function: PerfBaseline_put
+ * @purpose: record the result of one benchmark, replacing any earlier
+ *           result with the same key
+ *
+ * @parameters: 1) T baseline
+ *              2) const char *key, names the benchmark (no commas)
+ *              3) double nsPerPixel, its median time per pixel
+ *              4) const double *counters, CPUTIME_NCOUNTERS counts per
+ *                 pixel, -1 for any the machine could not count
+ * @returns: none
+ */
+extern void PerfBaseline_put(T baseline, const char *key, double nsPerPixel,
+                             const double *counters);
+
+/* @function: PerfBaseline_check
+ * @purpose: compare the result of one benchmark with the baseline and
+ *           describe any regression on log. Time may be worse by
+ *           timeTolerance percent and each counter by counterTolerance
+ *           percent; counters missing from either side are not checked.
+ *
+ * @parameters: 1) T baseline
+ *              2) const char *key, double nsPerPixel, const double
+ *                 *counters, as PerfBaseline_put
+ *              3) double timeTolerance, counterTolerance, in percent
+ *              4) FILE *log, where findings are written
+ * @returns: 0 if within tolerance, 1 if it regressed, -1 if the baseline
+ *           has no result for key
+ */
+extern int PerfBaseline_check(T baseline, const char *key, double nsPerPixel,
+                              const double *counters, double timeTolerance,
+                              double counterTolerance, FILE *log);
+
+#undef T
+#endif /* PERFBASELINE_INCLUDED */
@@ -0,0 +1,325 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** pipeline.c
+ ** 18 October 2026
+ **
+ ** Purpose: pipelined read/transform/write of one image. The three
+ **          stages share the source and destination arrays and hand
+ **          work to each other through row counters protected by one
+ **          mutex.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "assert.h"
+#include "a2methods.h"
+#include "pnm.h"
+#include "imageio.h"
+#include "ppmbands.h"
+#include "pipeline.h"
+
+/********** struct definitions **********/
+
+/* destination of source pixel (col, row) is
+ * (col0 + col * colStep[0] + row * rowStep[0],
+ *  row0 + col * colStep[1] + row * rowStep[1])
+ */
+struct Placement {
+    int col0, row0;
+    int colStep[2];
+    int rowStep[2];
+};
+
+struct Pipeline {
+    A2Methods_T methods;
+    A2Methods_UArray2 source;
+    A2Methods_UArray2 dest;
+    PPMBands_T bands;
+    ImageIO_T out;
+    int bandRows;
+    unsigned denominator;
+    CPUStats_T *stageStats;     /* NULL if not timing */
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int rowsRead;           /* source rows decoded by the reader */
+    int readDone;           /* reader has stopped */
+    int rowsReady;          /* destination rows that are final */
+    int transformDone;      /* no more destination rows will be ready */
+};
+
+/* @function: transformPoint
+ * @purpose: find where source pixel (col, row) lands after rotating
+ *           clockwise and then flipping, using the same conventions as
+ *           the apply functions in ppmtrans.c
+ *
+ * @parameters: 1) int rotation, flip, the transform
+ *              2) int width, height, the size of the source image
+ *              3) int col, row, the source pixel
+ *              4) int *newCol, *newRow, where the result is stored
+ * @returns: none
+ */
+static void transformPoint(int rotation, const char *flip, int width,
+                           int height, int col, int row,
+                           int *newCol, int *newRow)
+{
+    int c = col;
+    int r = row;
+    switch (rotation) {
+        case 90:
+            c = height - row - 1;
+            r = col;
+            break;
+        case 180:
+            c = width - col - 1;
+            r = height - row - 1;
+            break;
+        case 270:
+            c = row;
+            r = width - col - 1;
+            break;
+        default:
+            break;
+    }
+
+    int rotatedWidth = (rotation == 90 || rotation == 270) ? height : width;
+    int rotatedHeight = (rotation == 90 || rotation == 270) ? width : height;
+    if (strcmp(flip, "horizontal") == 0) {
+        r = rotatedHeight - r - 1;
+    } else if (strcmp(flip, "vertical") == 0) {
+        c = rotatedWidth - c - 1;
+    }
+
+    *newCol = c;
+    *newRow = r;
+}
+
+/* @function: makePlacement
+ * @purpose: every rotation and flip is an affine map, so three points
+ *           are enough to pin it down; the pixel loop then only adds
+ */
+static struct Placement makePlacement(int rotation, const char *flip,
+                                      int width, int height)
+{
+    struct Placement p;
+    int c, r;
+    transformPoint(rotation, flip, width, height, 0, 0, &p.col0, &p.row0);
+    transformPoint(rotation, flip, width, height, 1, 0, &c, &r);
+    p.colStep[0] = c - p.col0;
+    p.colStep[1] = r - p.row0;
+    transformPoint(rotation, flip, width, height, 0, 1, &c, &r);
+    p.rowStep[0] = c - p.col0;
+    p.rowStep[1] = r - p.row0;
+    return p;
+}
+
+/* @function: streamsRows
+ * @purpose: return 1 if source row k becomes destination row k, in which
+ *           case destination rows are final as soon as the matching
+ *           source rows have been moved
+ */
+static int streamsRows(struct Placement *p)
+{
+    return p->row0 == 0 && p->colStep[1] == 0 && p->rowStep[1] == 1;
+}
+
+/* @function: moveRows
+ * @purpose: copy source rows [first, last) to their places in dest
+ */
+static void moveRows(struct Pipeline *pl, struct Placement *p,
+                     int first, int last)
+{
+    A2Methods_T methods = pl->methods;
+    int width = methods->width(pl->source);
+
+    for (int row = first; row < last; row++) {
+        int c = p->col0 + row * p->rowStep[0];
+        int r = p->row0 + row * p->rowStep[1];
+        for (int col = 0; col < width; col++) {
+            *(Pnm_rgb)methods->at(pl->dest, c, r) =
+                *(Pnm_rgb)methods->at(pl->source, col, row);
+            c += p->colStep[0];
+            r += p->colStep[1];
+        }
+    }
+}
+
+/* @function: startStage, stopStage
+ * @purpose: time one band of work in a stage, if timing was asked for
+ */
+static void startStage(struct Pipeline *pl, int stage)
+{
+    if (pl->stageStats != NULL) {
+        CPUStats_Start(pl->stageStats[stage]);
+    }
+}
+
+static void stopStage(struct Pipeline *pl, int stage)
+{
+    if (pl->stageStats != NULL) {
+        CPUStats_Stop(pl->stageStats[stage]);
+    }
+}
+
+/* @function: readerThread
+ * @purpose: decode the source a band at a time, publishing each band
+ */
+static void *readerThread(void *vpl)
+{
+    struct Pipeline *pl = vpl;
+    int height = PPMBands_height(pl->bands);
+    int total = 0;
+
+    while (total < height) {
+        startStage(pl, PIPELINE_READ);
+        int n = PPMBands_read(pl->bands, pl->methods, pl->source,
+                              pl->bandRows);
+        stopStage(pl, PIPELINE_READ);
+        if (n == 0) {
+            break;
+        }
+        total += n;
+        pthread_mutex_lock(&pl->lock);
+        pl->rowsRead = total;
+        pthread_cond_broadcast(&pl->changed);
+        pthread_mutex_unlock(&pl->lock);
+    }
+
+    pthread_mutex_lock(&pl->lock);
+    pl->readDone = 1;
+    pthread_cond_broadcast(&pl->changed);
+    pthread_mutex_unlock(&pl->lock);
+    return NULL;
+}
+
+/* @function: writerThread
+ * @purpose: write destination rows as soon as they are final
+ */
+static void *writerThread(void *vpl)
+{
+    struct Pipeline *pl = vpl;
+    int height = pl->methods->height(pl->dest);
+    int written = 0;
+
+    PPMBands_writeheader(pl->out, pl->methods->width(pl->dest), height,
+                         pl->denominator);
+    while (written < height) {
+        pthread_mutex_lock(&pl->lock);
+        while (pl->rowsReady == written && !pl->transformDone) {
+            pthread_cond_wait(&pl->changed, &pl->lock);
+        }
+        int ready = pl->rowsReady;
+        pthread_mutex_unlock(&pl->lock);
+
+        if (ready == written) {     /* transform gave up */
+            break;
+        }
+        startStage(pl, PIPELINE_WRITE);
+        PPMBands_writerows(pl->out, pl->methods, pl->dest, pl->denominator,
+                           written, ready - written);
+        stopStage(pl, PIPELINE_WRITE);
+        written = ready;
+    }
+    return NULL;
+}
+
+extern int Pipeline_run(FILE *in, FILE *out, int rotation, const char *flip,
+                        A2Methods_T methods, int bandRows,
+                        ImageIO_Backend backend, CPUStats_T *stageStats,
+                        Pipeline_Info *info)
+{
+    assert(in != NULL && out != NULL);
+    assert(flip != NULL);
+    assert(methods != NULL);
+    assert(bandRows > 0);
+
+    /* from here on both files are used through their descriptors */
+    fflush(out);
+    ImageIO_T input = ImageIO_new(fileno(in), 0, backend);
+
+    struct Pipeline pl;
+    pl.bands = PPMBands_open(input);
+    if (pl.bands == NULL) {
+        ImageIO_free(&input);
+        return -1;
+    }
+
+    int width = PPMBands_width(pl.bands);
+    int height = PPMBands_height(pl.bands);
+    struct Placement place = makePlacement(rotation, flip, width, height);
+    int turned = (rotation == 90 || rotation == 270);
+
+    pl.methods = methods;
+    pl.source = methods->new(width, height, sizeof(struct Pnm_rgb));
+    pl.dest = methods->new(turned ? height : width, turned ? width : height,
+                           sizeof(struct Pnm_rgb));
+    if (info != NULL) {
+        info->width = width;
+        info->height = height;
+        info->blocksize = methods->blocksize(pl.source);
+    }
+    pl.out = ImageIO_new(fileno(out), 1, backend);
+    pl.bandRows = bandRows;
+    pl.stageStats = stageStats;
+    pl.denominator = PPMBands_denominator(pl.bands);
+    pthread_mutex_init(&pl.lock, NULL);
+    pthread_cond_init(&pl.changed, NULL);
+    pl.rowsRead = 0;
+    pl.readDone = 0;
+    pl.rowsReady = 0;
+    pl.transformDone = 0;
+
+    pthread_t reader, writer;
+    pthread_create(&reader, NULL, readerThread, &pl);
+    pthread_create(&writer, NULL, writerThread, &pl);
+
+    /* the calling thread is the transform stage */
+    int moved = 0;
+    int streaming = streamsRows(&place);
+    for (;;) {
+        pthread_mutex_lock(&pl.lock);
+        while (pl.rowsRead == moved && !pl.readDone) {
+            pthread_cond_wait(&pl.changed, &pl.lock);
+        }
+        int available = pl.rowsRead;
+        pthread_mutex_unlock(&pl.lock);
+
+        if (available == moved) {
+            break;
+        }
+        startStage(&pl, PIPELINE_TRANSFORM);
+        moveRows(&pl, &place, moved, available);
+        stopStage(&pl, PIPELINE_TRANSFORM);
+        moved = available;
+
+        if (streaming || moved == height) {
+            pthread_mutex_lock(&pl.lock);
+            pl.rowsReady = streaming ? moved
+                                     : methods->height(pl.dest);
+            pthread_cond_broadcast(&pl.changed);
+            pthread_mutex_unlock(&pl.lock);
+        }
+    }
+
+    pthread_mutex_lock(&pl.lock);
+    pl.transformDone = 1;
+    pthread_cond_broadcast(&pl.changed);
+    pthread_mutex_unlock(&pl.lock);
+
+    pthread_join(reader, NULL);
+    pthread_join(writer, NULL);
+
+    pthread_cond_destroy(&pl.changed);
+    pthread_mutex_destroy(&pl.lock);
+    methods->free(&pl.source);
+    methods->free(&pl.dest);
+    PPMBands_free(&pl.bands);
+    ImageIO_free(&input);
+
+    if (ImageIO_free(&pl.out) != 0) {
+        return -3;
+    }
+    return moved == height ? 0 : -2;
+}
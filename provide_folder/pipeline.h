@@ -0,0 +1,65 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** pipeline.h
+ ** 18 October 2026
+ **
+ ** Purpose: public interface for pipeline.c, which overlaps reading,
+ **          transforming and writing a single image
+ **/
+
+#ifndef PIPELINE_INCLUDED
+#define PIPELINE_INCLUDED
+
+#include <stdio.h>
+#include "a2methods.h"
+#include "imageio.h"
+#include "cputiming.h"
+
+/* the stages, for per-stage timing */
+enum { PIPELINE_READ = 0, PIPELINE_TRANSFORM, PIPELINE_WRITE,
+       PIPELINE_NSTAGES };
+
+/* what a run found out about the image, for reports */
+typedef struct Pipeline_Info {
+    int width, height;      /* of the source image */
+    int blocksize;          /* of the arrays it was stored in */
+} Pipeline_Info;
+
+/* @function: Pipeline_run
+ * @purpose: read a raw ppm from in, rotate and/or flip it, and write the
+ *           result to out, with the three steps running at the same time.
+ *           A reader thread decodes the input a band of rows at a time,
+ *           the calling thread moves each band into the output as soon as
+ *           it has arrived, and a writer thread writes output rows as
+ *           soon as they are final. Rotation 0 and the vertical flip
+ *           stream straight through; for the other transforms the output
+ *           can only be written once the last band is in, but the
+ *           transform is still overlapped with the reading.
+ *
+ * @precondition: 1) rotation is 0, 90, 180 or 270
+ *                2) flip is "horizontal", "vertical" or anything else
+ *                   for no flip
+ *                3) bandRows > 0
+ *
+ * @parameters: 1) FILE *in, where the image is read from
+ *              2) FILE *out, where the transformed image is written
+ *              3) int rotation, degrees clockwise
+ *              4) const char *flip, the flip applied after the rotation
+ *              5) A2Methods_T methods, the storage for both images
+ *              6) int bandRows, rows read and handed on at a time
+ *              7) ImageIO_Backend backend, how to read in and write out
+ *              8) CPUStats_T *stageStats, NULL or PIPELINE_NSTAGES
+ *                 accumulating timers; each stage times every band it
+ *                 handles with its own timer, on its own thread, so a
+ *                 CPUTIME_THREAD clock gives per-stage CPU time
+ *              9) Pipeline_Info *info, NULL or where to describe the
+ *                 image once its header is read
+ * @returns: 0 on success, -1 if in is not a raw ppm, -2 if it is cut
+ *           short, and -3 if writing failed
+ */
+extern int Pipeline_run(FILE *in, FILE *out, int rotation, const char *flip,
+                        A2Methods_T methods, int bandRows,
+                        ImageIO_Backend backend, CPUStats_T *stageStats,
+                        Pipeline_Info *info);
+
+#endif /* PIPELINE_INCLUDED */
@@ -0,0 +1,303 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** planar.c
+ ** 19 October 2026
+ **
+ ** Purpose: color images as three planes of samples. The planes share
+ **          one methods suite, size and block size, so a run of elements
+ **          in the red plane is a run at the same place in the green and
+ **          blue ones: reading and writing walk the red plane's runs in
+ **          row-major order and split or join all three planes at once.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "pnm.h"
+#include "ppmregion.h"
+#include "a2view.h"
+#include "planar.h"
+
+#define T Planar_T
+
+struct T {
+    unsigned width, height, denominator;
+    int size;                   /* bytes a sample */
+    A2Methods_T methods;
+    A2Methods_UArray2 planes[3];
+};
+
+/* @function: newPlanar
+ * @purpose: make an image of three uninitialized planes of methods, each
+ *           blocksize (or the suite's own if 0)
+ */
+static T newPlanar(A2Methods_T methods, unsigned width, unsigned height,
+                   unsigned denominator, int blocksize)
+{
+    T planar;
+    NEW(planar);
+    planar->width = width;
+    planar->height = height;
+    planar->denominator = denominator;
+    planar->size = denominator > 255 ? 2 : 1;
+    planar->methods = methods;
+    for (int c = 0; c < 3; c++) {
+        planar->planes[c] = blocksize > 0
+            ? methods->new_with_blocksize(width, height, planar->size,
+                                          blocksize)
+            : methods->new(width, height, planar->size);
+    }
+    return planar;
+}
+
+/*................... READING AND WRITING ...................*/
+
+/* what splitRun reads from: the mapped file, or an image already read */
+struct Split {
+    T planar;
+    PPMRegion_T region;
+    int row;                    /* the row of the file at samples */
+    const unsigned char *samples;
+    Pnm_ppm ppm;                /* row-major struct Pnm_rgb, if no region */
+};
+
+/* @function: splitRun
+ * @purpose: span function that fills a run of the red plane, and the runs
+ *           in the same place in the other two, from the source
+ */
+static void splitRun(int i, int j, int n, A2Methods_UArray2 array,
+                     A2Methods_Object *ptr, void *cl)
+{
+    (void) array;
+    struct Split *split = cl;
+    T planar = split->planar;
+    A2Methods_T methods = planar->methods;
+    void *red = ptr;
+    void *green = methods->at(planar->planes[PLANAR_GREEN], i, j);
+    void *blue = methods->at(planar->planes[PLANAR_BLUE], i, j);
+
+    if (split->region == NULL) {
+        Pnm_rgb in = split->ppm->methods->at(split->ppm->pixels, i, j);
+        for (int k = 0; k < n; k++) {
+            if (planar->size == 1) {
+                ((uint8_t *)red)[k] = in[k].red;
+                ((uint8_t *)green)[k] = in[k].green;
+                ((uint8_t *)blue)[k] = in[k].blue;
+            } else {
+                ((uint16_t *)red)[k] = in[k].red;
+                ((uint16_t *)green)[k] = in[k].green;
+                ((uint16_t *)blue)[k] = in[k].blue;
+            }
+        }
+        return;
+    }
+
+    if (split->row != j) {
+        split->row = j;
+        split->samples = PPMRegion_row(split->region, j);
+    }
+    if (planar->size == 1) {
+        const uint8_t *in = split->samples + (size_t)i * 3;
+        uint8_t *r = red, *g = green, *b = blue;
+        for (int k = 0; k < n; k++) {
+            r[k] = in[3 * k];
+            g[k] = in[3 * k + 1];
+            b[k] = in[3 * k + 2];
+        }
+    } else {
+        const uint8_t *in = split->samples + (size_t)i * 6;
+        uint16_t *r = red, *g = green, *b = blue;
+        for (int k = 0; k < n; k++) {
+            r[k] = (uint16_t)(in[6 * k] << 8 | in[6 * k + 1]);
+            g[k] = (uint16_t)(in[6 * k + 2] << 8 | in[6 * k + 3]);
+            b[k] = (uint16_t)(in[6 * k + 4] << 8 | in[6 * k + 5]);
+        }
+    }
+}
+
+extern T Planar_read(FILE *fp, A2Methods_T methods)
+{
+    assert(fp != NULL && methods != NULL);
+    assert(methods->span_map_row_major != NULL);
+    struct Split split = { NULL, PPMRegion_open(fileno(fp)), -1, NULL,
+                           NULL };
+    if (split.region != NULL) {
+        split.planar = newPlanar(methods, PPMRegion_width(split.region),
+                                 PPMRegion_height(split.region),
+                                 PPMRegion_denominator(split.region), 0);
+    } else {
+        split.ppm = Pnm_ppmread(fp, uarray2_methods_plain);
+        split.planar = newPlanar(methods, split.ppm->width,
+                                 split.ppm->height, split.ppm->denominator,
+                                 0);
+    }
+
+    methods->span_map_row_major(split.planar->planes[PLANAR_RED], splitRun,
+                                &split);
+    if (split.region != NULL) {
+        PPMRegion_free(&split.region);
+    } else {
+        Pnm_ppmfree(&split.ppm);
+    }
+    return split.planar;
+}
+
+/* what joinRun shares */
+struct Join {
+    T planar;
+    FILE *fp;
+    unsigned char *buffer;      /* one row of pixels */
+};
+
+/* @function: joinRun
+ * @purpose: span function that writes the pixels of a run of the red
+ *           plane, and the runs in the same place in the other two
+ */
+static void joinRun(int i, int j, int n, A2Methods_UArray2 array,
+                    A2Methods_Object *ptr, void *cl)
+{
+    (void) array;
+    struct Join *join = cl;
+    T planar = join->planar;
+    A2Methods_T methods = planar->methods;
+    const void *red = ptr;
+    const void *green = methods->at(planar->planes[PLANAR_GREEN], i, j);
+    const void *blue = methods->at(planar->planes[PLANAR_BLUE], i, j);
+    unsigned char *out = join->buffer;
+
+    if (planar->size == 1) {
+        const uint8_t *r = red, *g = green, *b = blue;
+        for (int k = 0; k < n; k++) {
+            out[3 * k] = r[k];
+            out[3 * k + 1] = g[k];
+            out[3 * k + 2] = b[k];
+        }
+    } else {
+        const uint16_t *r = red, *g = green, *b = blue;
+        for (int k = 0; k < n; k++) {
+            out[6 * k] = r[k] >> 8;
+            out[6 * k + 1] = r[k] & 0xff;
+            out[6 * k + 2] = g[k] >> 8;
+            out[6 * k + 3] = g[k] & 0xff;
+            out[6 * k + 4] = b[k] >> 8;
+            out[6 * k + 5] = b[k] & 0xff;
+        }
+    }
+    fwrite(out, 3 * planar->size, n, join->fp);
+}
+
+extern void Planar_write(FILE *fp, T planar)
+{
+    assert(fp != NULL && planar != NULL);
+    fprintf(fp, "P6\n%u %u\n%u\n", planar->width, planar->height,
+            planar->denominator);
+    struct Join join = { planar, fp,
+                         ALLOC((size_t)planar->width * 6 + 1) };
+    planar->methods->span_map_row_major(planar->planes[PLANAR_RED],
+                                        joinRun, &join);
+    FREE(join.buffer);
+}
+
+/*................... TRANSFORMING ...................*/
+
+/* one plane to transform */
+struct PlaneJob {
+    A2Methods_T methods;
+    A2Methods_UArray2 source, result;
+    int rotation;
+    const char *flip;
+};
+
+static void *transformPlane(void *arg)
+{
+    struct PlaneJob *job = arg;
+    A2Methods_UArray2 view = A2View_new(job->methods, job->source,
+                                        job->rotation, job->flip);
+    A2View_fill(view, job->methods, job->result);
+    a2view_methods->free(&view);
+    return NULL;
+}
+
+extern T Planar_transform(T planar, int rotation, const char *flip,
+                          int nthreads)
+{
+    assert(planar != NULL && flip != NULL && nthreads > 0);
+    assert(rotation == 0 || rotation == 90 || rotation == 180 ||
+           rotation == 270);
+    A2Methods_T methods = planar->methods;
+    int quarter = (rotation == 90 || rotation == 270);
+    T result = newPlanar(methods,
+                         quarter ? planar->height : planar->width,
+                         quarter ? planar->width : planar->height,
+                         planar->denominator,
+                         methods->blocksize(planar->planes[PLANAR_RED]));
+
+    struct PlaneJob jobs[3];
+    for (int c = 0; c < 3; c++) {
+        struct PlaneJob job = { methods, planar->planes[c],
+                                result->planes[c], rotation, flip };
+        jobs[c] = job;
+    }
+    if (nthreads == 1) {
+        for (int c = 0; c < 3; c++) {
+            transformPlane(&jobs[c]);
+        }
+        return result;
+    }
+    pthread_t threads[3];
+    for (int c = 0; c < 3; c++) {
+        pthread_create(&threads[c], NULL, transformPlane, &jobs[c]);
+    }
+    for (int c = 0; c < 3; c++) {
+        pthread_join(threads[c], NULL);
+    }
+    return result;
+}
+
+extern A2Methods_UArray2 Planar_plane(T planar, Planar_Channel channel)
+{
+    assert(planar != NULL);
+    assert(channel >= PLANAR_RED && channel <= PLANAR_BLUE);
+    return planar->planes[channel];
+}
+
+extern unsigned Planar_width(T planar)
+{
+    assert(planar != NULL);
+    return planar->width;
+}
+
+extern unsigned Planar_height(T planar)
+{
+    assert(planar != NULL);
+    return planar->height;
+}
+
+extern unsigned Planar_denominator(T planar)
+{
+    assert(planar != NULL);
+    return planar->denominator;
+}
+
+extern double Planar_bytes(T planar)
+{
+    assert(planar != NULL);
+    return 3.0 * planar->width * planar->height * planar->size;
+}
+
+extern void Planar_free(T *planar)
+{
+    assert(planar != NULL && *planar != NULL);
+    for (int c = 0; c < 3; c++) {
+        (*planar)->methods->free(&(*planar)->planes[c]);
+    }
+    FREE(*planar);
+}
+
+#undef T
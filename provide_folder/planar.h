@@ -0,0 +1,88 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** planar.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for planar.c, color images stored as three
+ **          planes (red, green and blue) rather than one array of
+ **          struct Pnm_rgb. Each plane is an array of methods whose
+ **          elements are single samples, 1 byte or 2 by the denominator,
+ **          so a transform of a plane moves small scalars only, and work
+ **          on one channel touches only its plane. Pixels are split into
+ **          planes as the image is read and put back together as it is
+ **          written.
+ **/
+
+#ifndef PLANAR_INCLUDED
+#define PLANAR_INCLUDED
+
+#include <stdio.h>
+
+#include "a2methods.h"
+
+#define T Planar_T
+typedef struct T *T;
+
+typedef enum {
+    PLANAR_RED,
+    PLANAR_GREEN,
+    PLANAR_BLUE
+} Planar_Channel;
+
+/* @function: Planar_read
+ * @purpose: read a ppm into three planes of methods. A raw ppm in a file
+ *           is split straight from the mapped file; anything else is
+ *           read with Pnm_ppmread and then split.
+ *
+ * @precondition: nothing but its magic number has been looked at in fp
+ * @returns: new type T
+ * @raises: Pnm_Badformat if fp does not hold a ppm
+ */
+extern T Planar_read(FILE *fp, A2Methods_T methods);
+
+/* @function: Planar_write
+ * @purpose: write planar to fp as a raw ppm, a run of pixels at a time
+ */
+extern void Planar_write(FILE *fp, T planar);
+
+/* @function: Planar_transform
+ * @purpose: make a new image of planar rotated by rotation degrees
+ *           clockwise and then flipped, each plane copied through a view
+ *           of it; with nthreads above 1 the planes are transformed at
+ *           the same time, one thread each
+ *
+ * @precondition: rotation is 0, 90, 180 or 270
+ *
+ * @parameters: 1) T planar, the image, which is unchanged
+ *              2) int rotation, the degrees to rotate
+ *              3) const char *flip, "horizontal", "vertical" or anything
+ *                 else for no flip
+ *              4) int nthreads, the most threads to use
+ * @returns: new type T, with planar's methods and block size
+ */
+extern T Planar_transform(T planar, int rotation, const char *flip,
+                          int nthreads);
+
+/* @function: Planar_plane
+ * @purpose: return one plane of planar, for work on one channel; it is
+ *           an array of planar's methods and belongs to planar
+ */
+extern A2Methods_UArray2 Planar_plane(T planar, Planar_Channel channel);
+
+/* @function: Planar_width, Planar_height, Planar_denominator,
+ *            Planar_bytes
+ * @purpose: return the size of planar in pixels, its denominator, and
+ *           the bytes its samples take
+ */
+extern unsigned Planar_width(T planar);
+extern unsigned Planar_height(T planar);
+extern unsigned Planar_denominator(T planar);
+extern double Planar_bytes(T planar);
+
+/* @function: Planar_free
+ * @purpose: deallocate planar and its planes and set it to NULL
+ */
+extern void Planar_free(T *planar);
+
+#undef T
+#endif /* PLANAR_INCLUDED */
@@ -0,0 +1,382 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** pnmgray.c
+ ** 19 October 2026
+ **
+ ** Purpose: reads, writes and transforms raw gray (P5) and bilevel (P4)
+ **          images. Gray samples go into an array a run at a time, as in
+ **          ppm16.c. A bitmap stays packed: its rows are the bytes of the
+ **          file, the first pixel of each byte in its high bit and the
+ **          unused bits at the end of a row clear. A quarter turn moves
+ **          8x8 blocks of pixels at a time, each 8 bytes transposed as one
+ **          64-bit word; a mirror reverses the bits of each byte and
+ **          shifts the row back into place.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+
+#include "assert.h"
+#include "except.h"
+#include "mem.h"
+#include "a2methods.h"
+#include "pnm.h"
+#include "pnmgray.h"
+
+#define T PNMGray_Bitmap
+
+struct T {
+    unsigned width, height;
+    unsigned stride;            /* bytes a row */
+    unsigned char *bits;        /* height rows of stride bytes */
+};
+
+/* @function: headerNumber
+ * @purpose: read one unsigned decimal number of a header, skipping
+ *           whitespace and comments in front of it, and the single
+ *           whitespace character after it
+ *
+ * @returns: 1 if a number was read, 0 otherwise
+ */
+static int headerNumber(FILE *fp, unsigned *n)
+{
+    int c = getc(fp);
+    while (isspace(c) || c == '#') {
+        if (c == '#') {
+            while (c != '\n' && c != EOF) {
+                c = getc(fp);
+            }
+        }
+        c = getc(fp);
+    }
+    if (!isdigit(c)) {
+        return 0;
+    }
+    *n = 0;
+    while (isdigit(c) && *n <= 100000000) {
+        *n = *n * 10 + (c - '0');
+        c = getc(fp);
+    }
+    return isspace(c);
+}
+
+extern PNMGray_Kind PNMGray_kind(FILE *fp)
+{
+    assert(fp != NULL);
+    int magic = getc(fp);
+    int number = getc(fp);
+    /* both go back; stdio keeps them in the buffer they were read from */
+    ungetc(number, fp);
+    ungetc(magic, fp);
+    if (magic != 'P') {
+        return PNMGRAY_COLOR;
+    }
+    return number == '5' ? PNMGRAY_GRAY
+         : number == '4' ? PNMGRAY_BILEVEL : PNMGRAY_COLOR;
+}
+
+/*................... GRAYMAPS ...................*/
+
+/* what the span functions share */
+struct Rows {
+    FILE *fp;
+    int size;                   /* bytes a sample */
+    unsigned char *buffer;      /* one row of two-byte samples */
+    int ok;
+};
+
+/* @function: readRun, writeRun
+ * @purpose: span functions that fill a run from the file, or write a run
+ *           to it. One-byte samples are the same in the file and the
+ *           array; two-byte samples are big-endian in the file.
+ */
+static void readRun(int i, int j, int n, A2Methods_UArray2 array,
+                    A2Methods_Object *ptr, void *cl)
+{
+    (void) i; (void) j; (void) array;
+    struct Rows *rows = cl;
+    if (rows->size == 1) {
+        if (fread(ptr, 1, n, rows->fp) != (size_t)n) {
+            rows->ok = 0;
+        }
+        return;
+    }
+    if (fread(rows->buffer, 2, n, rows->fp) != (size_t)n) {
+        rows->ok = 0;
+        return;
+    }
+    uint16_t *out = ptr;
+    for (int k = 0; k < n; k++) {
+        out[k] = (uint16_t)(rows->buffer[2 * k] << 8 |
+                            rows->buffer[2 * k + 1]);
+    }
+}
+
+static void writeRun(int i, int j, int n, A2Methods_UArray2 array,
+                     A2Methods_Object *ptr, void *cl)
+{
+    (void) i; (void) j; (void) array;
+    struct Rows *rows = cl;
+    if (rows->size == 1) {
+        if (fwrite(ptr, 1, n, rows->fp) != (size_t)n) {
+            rows->ok = 0;
+        }
+        return;
+    }
+    const uint16_t *in = ptr;
+    for (int k = 0; k < n; k++) {
+        rows->buffer[2 * k] = in[k] >> 8;
+        rows->buffer[2 * k + 1] = in[k] & 0xff;
+    }
+    if (fwrite(rows->buffer, 2, n, rows->fp) != (size_t)n) {
+        rows->ok = 0;
+    }
+}
+
+extern Pnm_ppm PNMGray_read(FILE *fp, A2Methods_T methods)
+{
+    assert(fp != NULL && methods != NULL);
+    assert(methods->span_map_row_major != NULL);
+    unsigned width, height, denominator;
+    if (getc(fp) != 'P' || getc(fp) != '5' ||
+        !headerNumber(fp, &width) || !headerNumber(fp, &height) ||
+        !headerNumber(fp, &denominator) || denominator == 0 ||
+        denominator > 65535) {
+        RAISE(Pnm_Badformat);
+    }
+
+    Pnm_ppm ppm;
+    NEW(ppm);
+    ppm->width = width;
+    ppm->height = height;
+    ppm->denominator = denominator;
+    ppm->methods = methods;
+    int size = denominator > 255 ? 2 : 1;
+    ppm->pixels = methods->new(width, height, size);
+
+    struct Rows rows = { fp, size, ALLOC((size_t)width * 2 + 1), 1 };
+    methods->span_map_row_major(ppm->pixels, readRun, &rows);
+    FREE(rows.buffer);
+    if (!rows.ok) {
+        Pnm_ppmfree(&ppm);
+        RAISE(Pnm_Badformat);
+    }
+    return ppm;
+}
+
+extern void PNMGray_write(FILE *fp, Pnm_ppm ppm)
+{
+    assert(fp != NULL && ppm != NULL);
+    int size = ppm->methods->size(ppm->pixels);
+    assert(size == 1 || size == 2);
+    fprintf(fp, "P5\n%u %u\n%u\n", ppm->width, ppm->height,
+            ppm->denominator);
+    struct Rows rows = { fp, size, ALLOC((size_t)ppm->width * 2 + 1), 1 };
+    ppm->methods->span_map_row_major(ppm->pixels, writeRun, &rows);
+    FREE(rows.buffer);
+}
+
+/*................... BITMAPS ...................*/
+
+static T newBitmap(unsigned width, unsigned height)
+{
+    T bitmap;
+    NEW(bitmap);
+    bitmap->width = width;
+    bitmap->height = height;
+    bitmap->stride = (width + 7) / 8;
+    bitmap->bits = CALLOC((size_t)bitmap->stride * height + 1, 1);
+    return bitmap;
+}
+
+extern T PNMGray_readBitmap(FILE *fp)
+{
+    assert(fp != NULL);
+    unsigned width, height;
+    if (getc(fp) != 'P' || getc(fp) != '4' ||
+        !headerNumber(fp, &width) || !headerNumber(fp, &height)) {
+        RAISE(Pnm_Badformat);
+    }
+    T bitmap = newBitmap(width, height);
+    size_t bytes = (size_t)bitmap->stride * height;
+    if (fread(bitmap->bits, 1, bytes, fp) != bytes) {
+        PNMGray_freeBitmap(&bitmap);
+        RAISE(Pnm_Badformat);
+    }
+
+    /* the file may leave anything in the bits past the end of a row */
+    if (width % 8 != 0) {
+        unsigned char mask = 0xff << (8 - width % 8);
+        for (unsigned r = 0; r < height; r++) {
+            bitmap->bits[(size_t)r * bitmap->stride + bitmap->stride - 1]
+                    &= mask;
+        }
+    }
+    return bitmap;
+}
+
+extern void PNMGray_writeBitmap(FILE *fp, T bitmap)
+{
+    assert(fp != NULL && bitmap != NULL);
+    fprintf(fp, "P4\n%u %u\n", bitmap->width, bitmap->height);
+    fwrite(bitmap->bits, 1, (size_t)bitmap->stride * bitmap->height, fp);
+}
+
+/* @function: reverseBits
+ * @purpose: return byte with its bits in the opposite order
+ */
+static inline unsigned reverseBits(unsigned byte)
+{
+    byte = (byte & 0xf0) >> 4 | (byte & 0x0f) << 4;
+    byte = (byte & 0xcc) >> 2 | (byte & 0x33) << 2;
+    return (byte & 0xaa) >> 1 | (byte & 0x55) << 1;
+}
+
+/* @function: transpose8
+ * @purpose: transpose the 8x8 block of pixels in x, whose high byte is
+ *           its first row, each row with its first pixel in the high bit.
+ *           Three rounds swap 1x1, 2x2 and then 4x4 sub-blocks.
+ */
+static inline uint64_t transpose8(uint64_t x)
+{
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aaULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000cccc0000ccccULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ULL;
+    return x ^ t ^ (t << 28);
+}
+
+/* @function: mirrorRow
+ * @purpose: write the width pixels of in to out in the opposite order.
+ *           Reversing the bytes and the bits in each puts the unused bits
+ *           of the row at its start, so the row is shifted left by them.
+ */
+static void mirrorRow(unsigned char *out, const unsigned char *in,
+                      unsigned width, unsigned stride)
+{
+    unsigned unused = stride * 8 - width;
+    for (unsigned k = 0; k < stride; k++) {
+        unsigned high = reverseBits(in[stride - 1 - k]);
+        unsigned low = k + 1 < stride ? reverseBits(in[stride - 2 - k])
+                                      : 0;
+        out[k] = (unsigned char)(high << unused | low >> (8 - unused));
+    }
+}
+
+/* @function: copyRows
+ * @purpose: out[r][c] = in[r'][c'], where r' is r or its mirror and c' is
+ *           c or its mirror: the rotations by 0 and 180 and their flips
+ */
+static void copyRows(T in, T out, int reverseRows, int reverseCols)
+{
+    for (unsigned r = 0; r < out->height; r++) {
+        unsigned from = reverseRows ? in->height - 1 - r : r;
+        const unsigned char *row = in->bits + (size_t)from * in->stride;
+        unsigned char *to = out->bits + (size_t)r * out->stride;
+        if (reverseCols) {
+            mirrorRow(to, row, in->width, in->stride);
+        } else {
+            memcpy(to, row, in->stride);
+        }
+    }
+}
+
+/* @function: transposeRows
+ * @purpose: out[r][c] = in[c'][r'], where c' is c or its mirror and r' is
+ *           r or its mirror: the rotations by 90 and 270 and their flips.
+ *           Each 8 rows of in are taken 8 columns at a time; the block is
+ *           transposed in a word and its rows are one byte of 8 rows of
+ *           out. Rows past the end of in are read as clear.
+ */
+static void transposeRows(T in, T out, int reverseRows, int reverseCols)
+{
+    for (unsigned by = 0; by < out->stride; by++) {
+        const unsigned char *rows[8];
+        for (unsigned i = 0; i < 8; i++) {
+            unsigned c = by * 8 + i;
+            unsigned from = reverseRows ? in->height - 1 - c : c;
+            rows[i] = c < in->height
+                    ? in->bits + (size_t)from * in->stride : NULL;
+        }
+        for (unsigned bx = 0; bx < in->stride; bx++) {
+            uint64_t x = 0;
+            for (unsigned i = 0; i < 8; i++) {
+                x = x << 8 | (rows[i] != NULL ? rows[i][bx] : 0);
+            }
+            x = transpose8(x);
+            for (unsigned j = 0; j < 8 && bx * 8 + j < in->width; j++) {
+                unsigned c = bx * 8 + j;
+                unsigned r = reverseCols ? in->width - 1 - c : c;
+                out->bits[(size_t)r * out->stride + by] =
+                        (unsigned char)(x >> (56 - 8 * j));
+            }
+        }
+    }
+}
+
+extern T PNMGray_transformBitmap(T bitmap, int rotation, const char *flip)
+{
+    assert(bitmap != NULL);
+    assert(rotation == 0 || rotation == 90 || rotation == 180 ||
+           rotation == 270);
+    int quarter = (rotation == 90 || rotation == 270);
+
+    /* which of the source's rows and columns are read backwards; a flip
+     * of a quarter turn reverses the other one */
+    int reverseRows = (rotation == 90 || rotation == 180);
+    int reverseCols = (rotation == 180 || rotation == 270);
+    if (strcmp(flip, "horizontal") == 0) {
+        if (quarter) {
+            reverseCols = !reverseCols;
+        } else {
+            reverseRows = !reverseRows;
+        }
+    } else if (strcmp(flip, "vertical") == 0) {
+        if (quarter) {
+            reverseRows = !reverseRows;
+        } else {
+            reverseCols = !reverseCols;
+        }
+    }
+
+    if (quarter) {
+        T out = newBitmap(bitmap->height, bitmap->width);
+        transposeRows(bitmap, out, reverseRows, reverseCols);
+        return out;
+    }
+    T out = newBitmap(bitmap->width, bitmap->height);
+    copyRows(bitmap, out, reverseRows, reverseCols);
+    return out;
+}
+
+extern unsigned PNMGray_bitmapWidth(T bitmap)
+{
+    assert(bitmap != NULL);
+    return bitmap->width;
+}
+
+extern unsigned PNMGray_bitmapHeight(T bitmap)
+{
+    assert(bitmap != NULL);
+    return bitmap->height;
+}
+
+extern double PNMGray_bitmapBytes(T bitmap)
+{
+    assert(bitmap != NULL);
+    return (double)bitmap->stride * bitmap->height;
+}
+
+extern void PNMGray_freeBitmap(T *bitmap)
+{
+    assert(bitmap != NULL && *bitmap != NULL);
+    FREE((*bitmap)->bits);
+    FREE(*bitmap);
+}
+
+#undef T
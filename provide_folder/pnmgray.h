@@ -0,0 +1,97 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** pnmgray.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for pnmgray.c, raw gray (P5) and bilevel
+ **          (P4) images. A graymap is a Pnm_ppm whose elements are one
+ **          sample, 1 byte or 2 (host order) by its denominator, so it is
+ **          transformed like any array of small elements. A bitmap is kept
+ **          packed, 8 pixels a byte as in the file, and is transformed
+ **          here a byte at a time: 8x8 bit transposes for quarter turns
+ **          and bit reversal for mirrors.
+ **/
+
+#ifndef PNMGRAY_INCLUDED
+#define PNMGRAY_INCLUDED
+
+#include <stdio.h>
+
+#include "a2methods.h"
+#include "pnm.h"
+
+#define T PNMGray_Bitmap
+typedef struct T *T;
+
+/* what an image file holds, from its magic number */
+typedef enum {
+    PNMGRAY_COLOR,          /* anything else, for Pnm_ppmread */
+    PNMGRAY_GRAY,           /* raw pgm */
+    PNMGRAY_BILEVEL         /* raw pbm */
+} PNMGray_Kind;
+
+/* @function: PNMGray_kind
+ * @purpose: look at the magic number of the image in fp and put it back,
+ *           so the image can still be read by whichever reader it needs
+ *
+ * @precondition: nothing has been read from fp
+ */
+extern PNMGray_Kind PNMGray_kind(FILE *fp);
+
+/* @function: PNMGray_read
+ * @purpose: read a raw pgm into an array of methods whose elements are
+ *           unsigned char, or uint16_t if the denominator is above 255
+ *
+ * @returns: the image; free it with Pnm_ppmfree
+ * @raises: Pnm_Badformat if fp does not hold a raw pgm
+ */
+extern Pnm_ppm PNMGray_read(FILE *fp, A2Methods_T methods);
+
+/* @function: PNMGray_write
+ * @purpose: write an image read by PNMGray_read (or a transform or view
+ *           of it) to fp as a raw pgm
+ */
+extern void PNMGray_write(FILE *fp, Pnm_ppm ppm);
+
+/* @function: PNMGray_readBitmap
+ * @purpose: read a raw pbm, packed as it is in the file
+ *
+ * @returns: new type T
+ * @raises: Pnm_Badformat if fp does not hold a raw pbm
+ */
+extern T PNMGray_readBitmap(FILE *fp);
+
+/* @function: PNMGray_writeBitmap
+ * @purpose: write bitmap to fp as a raw pbm
+ */
+extern void PNMGray_writeBitmap(FILE *fp, T bitmap);
+
+/* @function: PNMGray_transformBitmap
+ * @purpose: make a new bitmap of bitmap rotated by rotation degrees
+ *           clockwise and then flipped, without unpacking it
+ *
+ * @precondition: rotation is 0, 90, 180 or 270
+ *
+ * @parameters: 1) T bitmap, the bitmap to transform, which is unchanged
+ *              2) int rotation, the degrees to rotate
+ *              3) const char *flip, "horizontal", "vertical" or anything
+ *                 else for no flip
+ * @returns: new type T
+ */
+extern T PNMGray_transformBitmap(T bitmap, int rotation, const char *flip);
+
+/* @function: PNMGray_bitmapWidth, PNMGray_bitmapHeight,
+ *            PNMGray_bitmapBytes
+ * @purpose: return the size of bitmap in pixels, and the bytes it takes
+ */
+extern unsigned PNMGray_bitmapWidth(T bitmap);
+extern unsigned PNMGray_bitmapHeight(T bitmap);
+extern double PNMGray_bitmapBytes(T bitmap);
+
+/* @function: PNMGray_freeBitmap
+ * @purpose: deallocate bitmap and set it to NULL
+ */
+extern void PNMGray_freeBitmap(T *bitmap);
+
+#undef T
+#endif /* PNMGRAY_INCLUDED */
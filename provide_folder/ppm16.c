@@ -0,0 +1,149 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** ppm16.c
+ ** 19 October 2026
+ **
+ ** Purpose: reads and writes raw ppm images with two-byte samples into
+ **          and out of struct Pnm_rgb16 arrays. A run of n pixels is 3n
+ **          big-endian samples in the file and 3n uint16_t in the array,
+ **          so converting between them is one byte swap per sample.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <stdint.h>
+
+#include "assert.h"
+#include "except.h"
+#include "mem.h"
+#include "a2methods.h"
+#include "pnm.h"
+#include "ppm16.h"
+
+/* @function: headerNumber
+ * @purpose: read one unsigned decimal number of a ppm header, skipping
+ *           whitespace and comments in front of it, and the single
+ *           whitespace character after it
+ *
+ * @returns: 1 if a number was read, 0 otherwise
+ */
+static int headerNumber(FILE *fp, unsigned *n)
+{
+    int c = getc(fp);
+    while (isspace(c) || c == '#') {
+        if (c == '#') {
+            while (c != '\n' && c != EOF) {
+                c = getc(fp);
+            }
+        }
+        c = getc(fp);
+    }
+    if (!isdigit(c)) {
+        return 0;
+    }
+    *n = 0;
+    while (isdigit(c) && *n <= 100000000) {
+        *n = *n * 10 + (c - '0');
+        c = getc(fp);
+    }
+    return isspace(c);
+}
+
+/* @function: swapSamples
+ * @purpose: turn n big-endian samples into host order, or back
+ */
+static inline void swapSamples(uint16_t *out, const unsigned char *in,
+                               size_t n)
+{
+    for (size_t k = 0; k < n; k++) {
+        out[k] = (uint16_t)(in[2 * k] << 8 | in[2 * k + 1]);
+    }
+}
+
+static inline void unswapSamples(unsigned char *out, const uint16_t *in,
+                                 size_t n)
+{
+    for (size_t k = 0; k < n; k++) {
+        out[2 * k] = in[k] >> 8;
+        out[2 * k + 1] = in[k] & 0xff;
+    }
+}
+
+/* what the span functions share */
+struct Rows {
+    FILE *fp;
+    unsigned char *buffer;      /* one row of samples */
+    int ok;
+};
+
+/* @function: readRun, writeRun
+ * @purpose: span functions that fill a run from the file, or write a run
+ *           to it. A run that is not one piece of memory (a view that
+ *           turns its array) comes one pixel at a time.
+ */
+static void readRun(int i, int j, int n, A2Methods_UArray2 array,
+                    A2Methods_Object *ptr, void *cl)
+{
+    (void) i; (void) j; (void) array;
+    struct Rows *rows = cl;
+    size_t samples = (size_t)n * 3;
+    if (fread(rows->buffer, 2, samples, rows->fp) != samples) {
+        rows->ok = 0;
+        return;
+    }
+    swapSamples(ptr, rows->buffer, samples);
+}
+
+static void writeRun(int i, int j, int n, A2Methods_UArray2 array,
+                     A2Methods_Object *ptr, void *cl)
+{
+    (void) i; (void) j; (void) array;
+    struct Rows *rows = cl;
+    size_t samples = (size_t)n * 3;
+    unswapSamples(rows->buffer, ptr, samples);
+    if (fwrite(rows->buffer, 2, samples, rows->fp) != samples) {
+        rows->ok = 0;
+    }
+}
+
+extern Pnm_ppm PPM16_read(FILE *fp, A2Methods_T methods)
+{
+    assert(fp != NULL && methods != NULL);
+    assert(methods->span_map_row_major != NULL);
+    unsigned width, height, denominator;
+    if (getc(fp) != 'P' || getc(fp) != '6' ||
+        !headerNumber(fp, &width) || !headerNumber(fp, &height) ||
+        !headerNumber(fp, &denominator) || denominator < 256 ||
+        denominator > 65535) {
+        RAISE(Pnm_Badformat);
+    }
+
+    Pnm_ppm ppm;
+    NEW(ppm);
+    ppm->width = width;
+    ppm->height = height;
+    ppm->denominator = denominator;
+    ppm->methods = methods;
+    ppm->pixels = methods->new(width, height, sizeof(struct Pnm_rgb16));
+
+    struct Rows rows = { fp, ALLOC((size_t)width * 6 + 1), 1 };
+    methods->span_map_row_major(ppm->pixels, readRun, &rows);
+    FREE(rows.buffer);
+    if (!rows.ok) {
+        Pnm_ppmfree(&ppm);
+        RAISE(Pnm_Badformat);
+    }
+    return ppm;
+}
+
+extern void PPM16_write(FILE *fp, Pnm_ppm ppm)
+{
+    assert(fp != NULL && ppm != NULL);
+    assert(ppm->methods->size(ppm->pixels) == sizeof(struct Pnm_rgb16));
+    fprintf(fp, "P6\n%u %u\n%u\n", ppm->width, ppm->height,
+            ppm->denominator);
+    struct Rows rows = { fp, ALLOC((size_t)ppm->width * 6 + 1), 1 };
+    ppm->methods->span_map_row_major(ppm->pixels, writeRun, &rows);
+    FREE(rows.buffer);
+}
@@ -0,0 +1,46 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** ppm16.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for ppm16.c, compact storage for images
+ **          whose samples are two bytes (denominator above 255). Each
+ **          pixel is three 16-bit channels, 6 bytes rather than the 12 of
+ **          struct Pnm_rgb. Such an image is a Pnm_ppm like any other,
+ **          but its elements are struct Pnm_rgb16, so it is read and
+ **          written here and not by Pnm_ppmread and Pnm_ppmwrite.
+ **/
+
+#ifndef PPM16_INCLUDED
+#define PPM16_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "a2methods.h"
+#include "pnm.h"
+
+struct Pnm_rgb16 {
+    uint16_t red, green, blue;
+};
+typedef struct Pnm_rgb16 *Pnm_rgb16;
+
+/* @function: PPM16_read
+ * @purpose: read a raw (P6) ppm with a denominator above 255 into an
+ *           array of methods with struct Pnm_rgb16 elements. The samples
+ *           are read a run of the array at a time and byte-swapped in a
+ *           loop the compiler vectorizes.
+ *
+ * @precondition: nothing has been read from fp
+ * @returns: the image; free it with Pnm_ppmfree
+ * @raises: Pnm_Badformat if fp does not hold such an image
+ */
+extern Pnm_ppm PPM16_read(FILE *fp, A2Methods_T methods);
+
+/* @function: PPM16_write
+ * @purpose: write an image read by PPM16_read (or a transform of it,
+ *           including a view of it) to fp as a raw ppm
+ */
+extern void PPM16_write(FILE *fp, Pnm_ppm ppm);
+
+#endif /* PPM16_INCLUDED */
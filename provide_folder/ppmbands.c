@@ -0,0 +1,274 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** ppmbands.c
+ ** 18 October 2026
+ **
+ ** Purpose: reads and writes raw (P6) ppm images a band of rows at a
+ **          time. Samples are one byte when the denominator (maxval) is
+ **          below 256 and two big-endian bytes otherwise.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "assert.h"
+#include "a2methods.h"
+#include "pnm.h"
+#include "imageio.h"
+#include "ppmbands.h"
+
+#define T PPMBands_T
+
+/********** struct definitions **********/
+
+struct T
+{
+    ImageIO_T in;
+    unsigned width;
+    unsigned height;
+    unsigned denominator;
+    int bytesPerSample;
+    int rowsRead;
+    unsigned char *row;     /* one row of raw samples */
+};
+
+/* @function: nextByte
+ * @purpose: return the next byte of the header, or EOF. Header bytes are
+ *           few, and ImageIO is buffered, so reading them one at a time
+ *           is cheap.
+ */
+static int nextByte(ImageIO_T in)
+{
+    unsigned char c;
+    return ImageIO_read(in, &c, 1) == 1 ? c : EOF;
+}
+
+/* @function: readHeaderNumber
+ * @purpose: read one unsigned decimal number from a ppm header, skipping
+ *           whitespace and comments in front of it
+ *
+ * @parameters: 1) ImageIO_T in, the file being read
+ *              2) unsigned *n, where the number is stored
+ * @returns: 1 if a number was read, 0 otherwise
+ */
+static int readHeaderNumber(ImageIO_T in, unsigned *n)
+{
+    int c = nextByte(in);
+    while (isspace(c) || c == '#') {
+        if (c == '#') {
+            while (c != '\n' && c != EOF) {
+                c = nextByte(in);
+            }
+        }
+        c = nextByte(in);
+    }
+    if (!isdigit(c)) {
+        return 0;
+    }
+
+    *n = 0;
+    while (isdigit(c)) {
+        *n = *n * 10 + (c - '0');
+        c = nextByte(in);
+    }
+    /* exactly one whitespace character ends each field; after the
+     * maxval it is the last byte before the raster
+     */
+    return isspace(c);
+}
+
+/* @function: bytesPerSample
+ * @purpose: return how many bytes a raw ppm uses for each sample
+ */
+static int bytesPerSample(unsigned denominator)
+{
+    return denominator < 256 ? 1 : 2;
+}
+
+/* @function: PPMBands_open
+ * @purpose: read the header of a raw ppm from in
+ *
+ * @parameters: ImageIO_T in, the file the image is read from
+ * @returns: new type T, or NULL if in does not start with a P6 header
+ */
+extern T PPMBands_open(ImageIO_T in)
+{
+    assert(in != NULL);
+
+    if (nextByte(in) != 'P' || nextByte(in) != '6') {
+        return NULL;
+    }
+
+    T bands = malloc(sizeof(*bands));
+    assert(bands != NULL);
+
+    if (!readHeaderNumber(in, &bands->width) ||
+        !readHeaderNumber(in, &bands->height) ||
+        !readHeaderNumber(in, &bands->denominator) ||
+        bands->denominator == 0 || bands->denominator > 65535) {
+        free(bands);
+        return NULL;
+    }
+
+    bands->in = in;
+    bands->bytesPerSample = bytesPerSample(bands->denominator);
+    bands->rowsRead = 0;
+    bands->row = malloc((size_t)bands->width * 3 * bands->bytesPerSample
+                        + 1);
+    assert(bands->row != NULL);
+    return bands;
+}
+
+/* @function: PPMBands_free
+ * @purpose: deallocate the reader (in is not freed)
+ *
+ * @parameters: T *bands, the reader to free
+ * @returns: none
+ */
+extern void PPMBands_free(T *bands)
+{
+    assert(bands != NULL && *bands != NULL);
+    free((*bands)->row);
+    free(*bands);
+    *bands = NULL;
+}
+
+/* @function: PPMBands_width, PPMBands_height, PPMBands_denominator
+ * @purpose: return the fields read from the header
+ */
+extern unsigned PPMBands_width(T bands)
+{
+    assert(bands != NULL);
+    return bands->width;
+}
+
+extern unsigned PPMBands_height(T bands)
+{
+    assert(bands != NULL);
+    return bands->height;
+}
+
+extern unsigned PPMBands_denominator(T bands)
+{
+    assert(bands != NULL);
+    return bands->denominator;
+}
+
+/* @function: PPMBands_read
+ * @purpose: decode the next nrows rows of the image into pixels
+ *
+ * @parameters: 1) T bands, the reader
+ *              2) A2Methods_T methods, the methods suite for pixels
+ *              3) A2Methods_UArray2 pixels, the destination image
+ *              4) int nrows, the largest number of rows to read
+ * @returns: the number of rows read, 0 at the end of the image
+ */
+extern int PPMBands_read(T bands, A2Methods_T methods,
+                         A2Methods_UArray2 pixels, int nrows)
+{
+    assert(bands != NULL);
+    assert(methods != NULL);
+    assert(pixels != NULL);
+    assert(nrows >= 0);
+
+    int left = (int)bands->height - bands->rowsRead;
+    if (nrows > left) {
+        nrows = left;
+    }
+
+    size_t rowBytes = (size_t)bands->width * 3 * bands->bytesPerSample;
+    int count;
+    for (count = 0; count < nrows; count++) {
+        if (ImageIO_read(bands->in, bands->row, rowBytes) != rowBytes) {
+            break;
+        }
+
+        int row = bands->rowsRead + count;
+        unsigned char *p = bands->row;
+        for (unsigned col = 0; col < bands->width; col++) {
+            Pnm_rgb pixel = methods->at(pixels, col, row);
+            if (bands->bytesPerSample == 1) {
+                pixel->red   = p[0];
+                pixel->green = p[1];
+                pixel->blue  = p[2];
+                p += 3;
+            } else {
+                pixel->red   = (p[0] << 8) | p[1];
+                pixel->green = (p[2] << 8) | p[3];
+                pixel->blue  = (p[4] << 8) | p[5];
+                p += 6;
+            }
+        }
+    }
+
+    bands->rowsRead += count;
+    return count;
+}
+
+/* @function: PPMBands_writeheader
+ * @purpose: write a raw ppm header to out
+ */
+extern void PPMBands_writeheader(ImageIO_T out, unsigned width,
+                                 unsigned height, unsigned denominator)
+{
+    assert(out != NULL);
+    char header[64];
+    int n = snprintf(header, sizeof(header), "P6\n%u %u\n%u\n", width,
+                     height, denominator);
+    ImageIO_write(out, header, n);
+}
+
+/* @function: PPMBands_writerows
+ * @purpose: encode rows [first, first + nrows) of pixels to out, one
+ *           row at a time
+ *
+ * @parameters: 1) ImageIO_T out, where to write
+ *              2) A2Methods_T methods, the methods suite for pixels
+ *              3) A2Methods_UArray2 pixels, image of struct Pnm_rgb
+ *              4) unsigned denominator, the maxval of the image
+ *              5) int first, the first row to write
+ *              6) int nrows, how many rows to write
+ * @returns: none
+ */
+extern void PPMBands_writerows(ImageIO_T out, A2Methods_T methods,
+                               A2Methods_UArray2 pixels,
+                               unsigned denominator, int first, int nrows)
+{
+    assert(out != NULL);
+    assert(methods != NULL);
+    assert(pixels != NULL);
+    assert(first >= 0 && nrows >= 0);
+    assert(first + nrows <= methods->height(pixels));
+
+    int width = methods->width(pixels);
+    int sampleBytes = bytesPerSample(denominator);
+    size_t rowBytes = (size_t)width * 3 * sampleBytes;
+    unsigned char *buffer = malloc(rowBytes + 1);
+    assert(buffer != NULL);
+
+    for (int row = first; row < first + nrows; row++) {
+        unsigned char *p = buffer;
+        for (int col = 0; col < width; col++) {
+            Pnm_rgb pixel = methods->at(pixels, col, row);
+            if (sampleBytes == 1) {
+                p[0] = pixel->red;
+                p[1] = pixel->green;
+                p[2] = pixel->blue;
+                p += 3;
+            } else {
+                p[0] = pixel->red >> 8;
+                p[1] = pixel->red;
+                p[2] = pixel->green >> 8;
+                p[3] = pixel->green;
+                p[4] = pixel->blue >> 8;
+                p[5] = pixel->blue;
+                p += 6;
+            }
+        }
+        ImageIO_write(out, buffer, rowBytes);
+    }
+
+    free(buffer);
+}
+
+#undef T
@@ -0,0 +1,94 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** ppmbands.h
+ ** 18 October 2026
+ **
+ ** Purpose: public interface for ppmbands.c. Reads and writes raw (P6)
+ **          ppm images a band of rows at a time, so that a client can
+ **          start working on the top of an image before the bottom of
+ **          it has been read.
+ **/
+
+#ifndef PPMBANDS_INCLUDED
+#define PPMBANDS_INCLUDED
+
+#include "a2methods.h"
+#include "imageio.h"
+
+#define T PPMBands_T
+typedef struct T *T;
+
+/* @function: PPMBands_open
+ * @purpose: read the header of a raw ppm from in and get ready to read
+ *           its pixels band by band
+ *
+ * @precondition: in is open for reading
+ * @postcondition: the header has been consumed from in
+ *
+ * @parameters: ImageIO_T in, the file the image is read from
+ * @returns: new type T, or NULL if in does not start with a P6 header
+ */
+extern T PPMBands_open(ImageIO_T in);
+
+/* @function: PPMBands_free
+ * @purpose: deallocate the reader (in is not freed)
+ *
+ * @parameters: T *bands, the reader to free
+ * @returns: none
+ */
+extern void PPMBands_free(T *bands);
+
+/* @function: PPMBands_width, PPMBands_height, PPMBands_denominator
+ * @purpose: return the fields read from the header
+ */
+extern unsigned PPMBands_width(T bands);
+extern unsigned PPMBands_height(T bands);
+extern unsigned PPMBands_denominator(T bands);
+
+/* @function: PPMBands_read
+ * @purpose: decode the next nrows rows of the image into pixels, which
+ *           holds struct Pnm_rgb elements and is as big as the image
+ *
+ * @precondition: pixels was made by methods and is width x height
+ * @postcondition: rows [first, first + count) of pixels are filled in,
+ *                 where first is the number of rows read before the call
+ *
+ * @parameters: 1) T bands, the reader
+ *              2) A2Methods_T methods, the methods suite for pixels
+ *              3) A2Methods_UArray2 pixels, the destination image
+ *              4) int nrows, the largest number of rows to read
+ * @returns: count, the number of rows read: 0 at the end of the image,
+ *           and fewer than asked for if the file is cut short
+ */
+extern int PPMBands_read(T bands, A2Methods_T methods,
+                         A2Methods_UArray2 pixels, int nrows);
+
+/* @function: PPMBands_writeheader
+ * @purpose: write a raw ppm header to out
+ *
+ * @parameters: 1) ImageIO_T out, where to write
+ *              2) unsigned width, height, denominator, the header fields
+ * @returns: none
+ */
+extern void PPMBands_writeheader(ImageIO_T out, unsigned width,
+                                 unsigned height, unsigned denominator);
+
+/* @function: PPMBands_writerows
+ * @purpose: encode rows [first, first + nrows) of pixels to out
+ *
+ * @precondition: the header has already been written
+ *
+ * @parameters: 1) ImageIO_T out, where to write
+ *              2) A2Methods_T methods, the methods suite for pixels
+ *              3) A2Methods_UArray2 pixels, image of struct Pnm_rgb
+ *              4) unsigned denominator, the maxval of the image
+ *              5) int first, the first row to write
+ *              6) int nrows, how many rows to write
+ * @returns: none
+ */
+extern void PPMBands_writerows(ImageIO_T out, A2Methods_T methods,
+                               A2Methods_UArray2 pixels,
+                               unsigned denominator, int first, int nrows);
+
+#undef T
+#endif /* PPMBANDS_INCLUDED */
@@ -0,0 +1,667 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** ppmbench.c
+ ** 18 October 2026
+ **
+ ** Purpose: benchmark the rotations and flips of ppmtrans on synthetic
+ **          images. Sweeps image sizes, layouts (with their map order),
+ **          blocksizes, transforms and thread counts, and for each
+ **          combination reports the median and spread of several timed
+ **          runs, and the rate achieved against a memcpy of the same
+ **          image, as CSV or JSON lines. With -record or -check it
+ **          also writes or checks a per-machine baseline of ns per pixel
+ **          and hardware counters per pixel. Runs can be pinned to
+ **          chosen CPUs, timed with warm caches, cold caches or both,
+ **          and have their outliers dropped before they are summarized.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assert.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+#include "pnm.h"
+#include "cputiming.h"
+#include "transform.h"
+#include "perfbaseline.h"
+
+#define MAXLIST 32
+
+/* image sizes: square, landscape and portrait, small to bigger than LLC */
+#define DEFAULT_SIZES "256x256,1024x1024,2856x1603,4096x512,512x4096"
+#define DEFAULT_BLOCKSIZES "0,16,64"        /* 0 is the library default */
+#define DEFAULT_THREADS "1,2,4"
+#define DEFAULT_LAYOUTS "row,col,block,tile,block-row,block-col,two-level"
+#define DEFAULT_REPS 5
+#define DEFAULT_WARMUP 1
+#define DEFAULT_TOLERANCE 10                /* percent */
+#define DEFAULT_COUNTER_TOLERANCE 5         /* percent */
+
+/* cache states to time, for Config.cacheModes */
+#define CACHE_WARM 1
+#define CACHE_COLD 2
+
+/* the order a layout's map visits the destination in */
+typedef enum { ORDER_ROW, ORDER_COL, ORDER_BLOCK, ORDER_TILE } Order;
+
+/* a storage layout and the order its map visits the destination in */
+struct Layout {
+    const char *name;       /* as given to -layouts */
+    const char *label;      /* as reported */
+    int blocked;            /* 1 if it uses the blocksize */
+    int tiled;              /* 1 if the blocksize is a plain tile size */
+    Order order;
+    int cacheSized;         /* 1 if two-level, sized from the caches */
+};
+
+static const struct Layout layouts[] = {
+    { "row",       "row-major",             0, 0, ORDER_ROW,   0 },
+    { "col",       "col-major",             0, 0, ORDER_COL,   0 },
+    { "block",     "block-major",           1, 0, ORDER_BLOCK, 0 },
+    { "tile",      "tile-major",            0, 1, ORDER_TILE,  0 },
+    { "block-row", "block-row-major",       1, 0, ORDER_ROW,   0 },
+    { "block-col", "block-col-major",       1, 0, ORDER_COL,   0 },
+    { "two-level", "two-level-block-major", 1, 0, ORDER_BLOCK, 1 },
+};
+#define NLAYOUTS ((int)(sizeof(layouts) / sizeof(layouts[0])))
+
+struct Transform {
+    int rotation;
+    char *flip;
+    const char *name;
+};
+
+static const struct Transform transforms[] = {
+    { 90,  " ",          "rotate 90" },
+    { 180, " ",          "rotate 180" },
+    { 270, " ",          "rotate 270" },
+    { 0,   "horizontal", "flip horizontal" },
+    { 0,   "vertical",   "flip vertical" },
+};
+#define NTRANSFORMS ((int)(sizeof(transforms) / sizeof(transforms[0])))
+
+/* what is being measured and how */
+struct Config {
+    int widths[MAXLIST], heights[MAXLIST], nsizes;
+    int blocksizes[MAXLIST], nblocksizes;
+    int threads[MAXLIST], nthreads;
+    int useLayout[NLAYOUTS];
+    int reps, warmup;
+    int cacheModes;         /* CACHE_WARM, CACHE_COLD or both */
+    int rejectOutliers;
+    int json;
+    FILE *out;
+
+    /* baseline, if -check or -record was given */
+    PerfBaseline_T baseline;
+    int recording;
+    double tolerance, counterTolerance;
+    int regressions, unknown;
+};
+
+/* the result of one benchmark */
+struct Result {
+    int width, height;
+    const char *layout;
+    int blocksize;
+    int threads;
+    const char *transform;
+    CPUStats_T stats;
+    double bytes;           /* read plus written per run */
+    double memcpyNs;        /* median memcpy of the same image */
+    double counters[CPUTIME_NCOUNTERS];    /* per run, -1 if unavailable */
+    int cold;               /* caches flushed before every run */
+    int rejected;           /* outliers dropped */
+};
+
+static void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s [-sizes WxH,...] "
+                    "[-layouts row,col,block,tile,block-row,block-col,"
+                    "two-level] "
+                    "[-blocksizes n,...] [-threads n,...] [-reps n] "
+                    "[-warmup n] [-pin cpus] [-cache warm|cold|both] "
+                    "[-outliers reject|keep] [-loops specialized|generic] "
+                    "[-format csv|json] [-o file] "
+                    "[-record file | -check file [-tolerance pct] "
+                    "[-counter-tolerance pct]]\n",
+                    progname);
+    exit(1);
+}
+
+/* @function: parseInts
+ * @purpose: read a comma separated list of non-negative numbers
+ *
+ * @returns: how many were read, or -1 if the list is malformed
+ */
+static int parseInts(const char *list, int *values, int max)
+{
+    int n = 0;
+    while (*list != '\0') {
+        char *end;
+        long v = strtol(list, &end, 10);
+        if (end == list || v < 0 || n == max ||
+            (*end != ',' && *end != '\0')) {
+            return -1;
+        }
+        values[n++] = v;
+        list = (*end == ',') ? end + 1 : end;
+    }
+    return n;
+}
+
+/* @function: parseSizes
+ * @purpose: read a comma separated list of WxH image sizes
+ *
+ * @returns: how many were read, or -1 if the list is malformed
+ */
+static int parseSizes(const char *list, int *widths, int *heights, int max)
+{
+    int n = 0;
+    while (*list != '\0') {
+        char *end;
+        long w = strtol(list, &end, 10);
+        if (end == list || *end != 'x' || n == max) {
+            return -1;
+        }
+        list = end + 1;
+        long h = strtol(list, &end, 10);
+        if (end == list || w <= 0 || h <= 0 ||
+            (*end != ',' && *end != '\0')) {
+            return -1;
+        }
+        widths[n] = w;
+        heights[n] = h;
+        n++;
+        list = (*end == ',') ? end + 1 : end;
+    }
+    return n;
+}
+
+/* @function: parseLayouts
+ * @purpose: mark the layouts named in a comma separated list
+ *
+ * @returns: 0, or -1 if a name is unknown
+ */
+static int parseLayouts(const char *list, int *useLayout)
+{
+    char copy[256];
+    snprintf(copy, sizeof(copy), "%s", list);
+    for (int i = 0; i < NLAYOUTS; i++) {
+        useLayout[i] = 0;
+    }
+    for (char *name = strtok(copy, ","); name != NULL;
+         name = strtok(NULL, ",")) {
+        int i;
+        for (i = 0; i < NLAYOUTS; i++) {
+            if (strcmp(name, layouts[i].name) == 0) {
+                useLayout[i] = 1;
+                break;
+            }
+        }
+        if (i == NLAYOUTS) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* @function: fillPixel
+ * @purpose: apply function giving every pixel of the synthetic image a
+ *           value that depends on where it is
+ */
+static void fillPixel(int col, int row, A2Methods_UArray2 array2,
+                      A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    (void) cl;
+    Pnm_rgb pixel = ptr;
+    pixel->red = col & 0xff;
+    pixel->green = row & 0xff;
+    pixel->blue = (col ^ row) & 0xff;
+}
+
+/* @function: memcpyMedian
+ * @purpose: time copying an image's worth of bytes, the rate a transform
+ *           would reach if moving pixels cost nothing but memory traffic
+ *
+ * @returns: the median time of config->reps copies, in nanoseconds
+ */
+static double memcpyMedian(struct Config *config, size_t bytes)
+{
+    char *source = malloc(bytes);
+    char *dest = malloc(bytes);
+    assert(source != NULL && dest != NULL);
+    memset(source, 1, bytes);
+    memset(dest, 0, bytes);
+
+    CPUStats_T stats = CPUStats_New("memcpy", CPUTIME_WALL);
+    volatile char sink = 0;
+    for (int i = 0; i < config->warmup + config->reps; i++) {
+        if (i >= config->warmup) {
+            CPUStats_Start(stats);
+        }
+        memcpy(dest, source, bytes);
+        if (i >= config->warmup) {
+            CPUStats_Stop(stats);
+        }
+        sink += dest[(i * 4099) % bytes];
+    }
+    (void) sink;
+
+    double median = CPUStats_Median(stats);
+    CPUStats_Free(&stats);
+    free(source);
+    free(dest);
+    return median;
+}
+
+/* @function: writeResult
+ * @purpose: write one result as a CSV row or a JSON line
+ */
+static void writeResult(struct Config *config, struct Result *r)
+{
+    double median = CPUStats_Median(r->stats);
+    double pixels = (double)r->width * r->height;
+    /* bytes per nanosecond is GB/s */
+    double gbps = median > 0 ? r->bytes / median : 0;
+    double memcpyGbps = r->memcpyNs > 0 ? r->bytes / r->memcpyNs : 0;
+    double fraction = memcpyGbps > 0 ? gbps / memcpyGbps : 0;
+
+    if (config->json) {
+        fprintf(config->out,
+                "{\"width\":%d,\"height\":%d,\"layout\":\"%s\","
+                "\"blocksize\":%d,\"threads\":%d,\"transform\":\"%s\","
+                "\"cache\":\"%s\",\"reps\":%d,\"rejected\":%d,"
+                "\"median_ns\":%.0f,\"p10_ns\":%.0f,"
+                "\"p90_ns\":%.0f,\"min_ns\":%.0f,\"max_ns\":%.0f,"
+                "\"ns_per_pixel\":%.3f,\"gbps\":%.3f,"
+                "\"memcpy_gbps\":%.3f,\"fraction_of_memcpy\":%.3f}\n",
+                r->width, r->height, r->layout, r->blocksize, r->threads,
+                r->transform, r->cold ? "cold" : "warm",
+                CPUStats_Count(r->stats), r->rejected, median,
+                CPUStats_Percentile(r->stats, 10),
+                CPUStats_Percentile(r->stats, 90),
+                CPUStats_Min(r->stats), CPUStats_Max(r->stats),
+                median / pixels, gbps, memcpyGbps, fraction);
+    } else {
+        fprintf(config->out,
+                "%d,%d,%s,%d,%d,%s,%s,%d,%d,%.0f,%.0f,%.0f,%.0f,%.0f,"
+                "%.3f,%.3f,%.3f,%.3f\n",
+                r->width, r->height, r->layout, r->blocksize, r->threads,
+                r->transform, r->cold ? "cold" : "warm",
+                CPUStats_Count(r->stats), r->rejected, median,
+                CPUStats_Percentile(r->stats, 10),
+                CPUStats_Percentile(r->stats, 90),
+                CPUStats_Min(r->stats), CPUStats_Max(r->stats),
+                median / pixels, gbps, memcpyGbps, fraction);
+    }
+    fflush(config->out);
+}
+
+/* @function: compareResult
+ * @purpose: add a result to the baseline being recorded, or check it
+ *           against the baseline read in, counting regressions
+ */
+static void compareResult(struct Config *config, struct Result *r)
+{
+    char key[128];
+    double pixels = (double)r->width * r->height;
+    double counters[CPUTIME_NCOUNTERS];
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        counters[i] = r->counters[i] < 0 ? -1 : r->counters[i] / pixels;
+    }
+    snprintf(key, sizeof(key), "%dx%d/%s/%d/%d/%s%s", r->width, r->height,
+             r->layout, r->blocksize, r->threads, r->transform,
+             r->cold ? "/cold" : "");
+    double nsPerPixel = CPUStats_Median(r->stats) / pixels;
+
+    if (config->recording) {
+        PerfBaseline_put(config->baseline, key, nsPerPixel, counters);
+        return;
+    }
+    int result = PerfBaseline_check(config->baseline, key, nsPerPixel,
+                                    counters, config->tolerance,
+                                    config->counterTolerance, stderr);
+    if (result > 0) {
+        config->regressions++;
+    } else if (result < 0) {
+        config->unknown++;
+    }
+}
+
+/* @function: timeRuns
+ * @purpose: run one transform config->warmup times untimed and then
+ *           config->reps times timed, flushing the caches before every
+ *           run if result->cold, and drop the outliers if asked to.
+ *           Counters are read around each timed run only, so a flush
+ *           is never counted.
+ *
+ * @parameters: 1) struct Config *config, the sweep
+ *              2) struct Result *result, filled in with the samples,
+ *                 the counters per run and the outliers dropped
+ *              3) const struct Transform *transform, what to time
+ *              4) Pnm_ppm image, the source
+ *              5) A2Methods_mapfun *map, the order to fill dest in
+ *              6) A2Methods_UArray2 dest, the destination
+ * @returns: none
+ */
+static void timeRuns(struct Config *config, struct Result *result,
+                     const struct Transform *transform, Pnm_ppm image,
+                     A2Methods_mapfun *map, A2Methods_UArray2 dest)
+{
+    CPUTime_T counterTimer = CPUTime_New();
+    CPUTime_EnableCounters(counterTimer);
+    for (int c = 0; c < CPUTIME_NCOUNTERS; c++) {
+        result->counters[c] = 0;
+    }
+
+    for (int i = 0; i < config->warmup + config->reps; i++) {
+        int timed = (i >= config->warmup);
+        if (result->cold) {
+            CPUTime_FlushCaches();
+        }
+        if (timed) {
+            CPUTime_Start(counterTimer);
+            CPUStats_Start(result->stats);
+        }
+        if (result->threads > 1) {
+            alterImageThreaded(transform->rotation, transform->flip, image,
+                               map, dest, result->threads);
+        } else {
+            alterImage(transform->rotation, transform->flip, image, map,
+                       dest);
+        }
+        if (timed) {
+            CPUStats_Stop(result->stats);
+            CPUTime_Stop(counterTimer);
+            for (int c = 0; c < CPUTIME_NCOUNTERS; c++) {
+                double count = CPUTime_Count(counterTimer, c);
+                if (count < 0 || result->counters[c] < 0) {
+                    result->counters[c] = -1;
+                } else {
+                    result->counters[c] += count;
+                }
+            }
+        }
+    }
+    CPUTime_Free(&counterTimer);
+
+    for (int c = 0; c < CPUTIME_NCOUNTERS; c++) {
+        if (result->counters[c] >= 0) {
+            result->counters[c] /= config->reps;
+        }
+    }
+    result->rejected = config->rejectOutliers
+                       ? CPUStats_RejectOutliers(result->stats) : 0;
+}
+
+/* @function: benchLayout
+ * @purpose: time every transform and thread count on one image size,
+ *           layout and blocksize
+ *
+ * @parameters: 1) struct Config *config, the sweep
+ *              2) int width, height, the image size
+ *              3) const struct Layout *layout, the storage and map order
+ *              4) int blocksize, for a blocked layout or the tile size for
+ *                 a tiled one (0 for the default); a two-level layout
+ *                 takes its sizes from the caches instead
+ *              5) double memcpyNs, the baseline for this size
+ * @returns: none
+ */
+static void benchLayout(struct Config *config, int width, int height,
+                        const struct Layout *layout, int blocksize,
+                        double memcpyNs)
+{
+    A2Methods_T methods = layout->blocked ? uarray2_methods_blocked
+                                          : uarray2_methods_plain;
+    A2Methods_mapfun *map = methods->map_row_major;
+    if (layout->order == ORDER_COL) {
+        map = methods->map_col_major;
+    } else if (layout->order == ORDER_BLOCK) {
+        map = methods->map_block_major;
+    } else if (layout->order == ORDER_TILE) {
+        map = a2plain_map_tile_major;
+        a2plain_set_tile_size(blocksize);
+    }
+    int size = sizeof(struct Pnm_rgb);
+    a2blocked_set_cache_sized(layout->cacheSized);
+    if (layout->cacheSized) {
+        blocksize = 0;
+    }
+
+    A2Methods_UArray2 source = blocksize > 0
+        ? methods->new_with_blocksize(width, height, size, blocksize)
+        : methods->new(width, height, size);
+    struct Pnm_ppm image = { width, height, 255, source, methods };
+    /* uarray2's maps insist on a closure */
+    methods->map_default(source, fillPixel, &image);
+
+    for (int t = 0; t < NTRANSFORMS; t++) {
+        int turned = (transforms[t].rotation == 90 ||
+                      transforms[t].rotation == 270);
+        int destWidth = turned ? height : width;
+        int destHeight = turned ? width : height;
+        A2Methods_UArray2 dest = blocksize > 0
+            ? methods->new_with_blocksize(destWidth, destHeight, size,
+                                          blocksize)
+            : methods->new(destWidth, destHeight, size);
+
+        for (int k = 0; k < config->nthreads; k++) {
+            for (int cold = 0; cold <= 1; cold++) {
+                if (!(config->cacheModes & (cold ? CACHE_COLD
+                                                 : CACHE_WARM))) {
+                    continue;
+                }
+                struct Result result = {
+                    width, height, layout->label,
+                    layout->tiled ? a2plain_tile_size(source)
+                                  : methods->blocksize(source),
+                    config->threads[k],
+                    transforms[t].name,
+                    CPUStats_New(transforms[t].name, CPUTIME_WALL),
+                    2.0 * width * height * size, memcpyNs, { 0 }, cold, 0
+                };
+                timeRuns(config, &result, &transforms[t], &image, map,
+                         dest);
+                writeResult(config, &result);
+                if (config->baseline != NULL) {
+                    compareResult(config, &result);
+                }
+                CPUStats_Free(&result.stats);
+            }
+        }
+        methods->free(&dest);
+    }
+    methods->free(&source);
+    a2blocked_set_cache_sized(0);
+}
+
+int main(int argc, char *argv[])
+{
+    struct Config config;
+    config.nsizes = parseSizes(DEFAULT_SIZES, config.widths, config.heights,
+                               MAXLIST);
+    config.nblocksizes = parseInts(DEFAULT_BLOCKSIZES, config.blocksizes,
+                                   MAXLIST);
+    config.nthreads = parseInts(DEFAULT_THREADS, config.threads, MAXLIST);
+    parseLayouts(DEFAULT_LAYOUTS, config.useLayout);
+    config.reps = DEFAULT_REPS;
+    config.warmup = DEFAULT_WARMUP;
+    config.cacheModes = CACHE_WARM;
+    config.rejectOutliers = 1;
+    config.json = 0;
+    config.out = stdout;
+    config.baseline = NULL;
+    config.recording = 0;
+    config.tolerance = DEFAULT_TOLERANCE;
+    config.counterTolerance = DEFAULT_COUNTER_TOLERANCE;
+    config.regressions = 0;
+    config.unknown = 0;
+    const char *baselinePath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+        }
+        char *option = argv[i];
+        char *value = argv[++i];
+        if (strcmp(option, "-sizes") == 0) {
+            config.nsizes = parseSizes(value, config.widths, config.heights,
+                                       MAXLIST);
+        } else if (strcmp(option, "-layouts") == 0) {
+            if (parseLayouts(value, config.useLayout) != 0) {
+                usage(argv[0]);
+            }
+        } else if (strcmp(option, "-blocksizes") == 0) {
+            config.nblocksizes = parseInts(value, config.blocksizes,
+                                           MAXLIST);
+        } else if (strcmp(option, "-threads") == 0) {
+            config.nthreads = parseInts(value, config.threads, MAXLIST);
+        } else if (strcmp(option, "-reps") == 0) {
+            config.reps = atoi(value);
+        } else if (strcmp(option, "-warmup") == 0) {
+            config.warmup = atoi(value);
+        } else if (strcmp(option, "-pin") == 0) {
+            if (CPUTime_PinCPUs(value) != 0) {
+                fprintf(stderr, "%s: cannot pin to CPUs '%s'\n", argv[0],
+                        value);
+                exit(1);
+            }
+        } else if (strcmp(option, "-cache") == 0) {
+            if (strcmp(value, "warm") == 0) {
+                config.cacheModes = CACHE_WARM;
+            } else if (strcmp(value, "cold") == 0) {
+                config.cacheModes = CACHE_COLD;
+            } else if (strcmp(value, "both") == 0) {
+                config.cacheModes = CACHE_WARM | CACHE_COLD;
+            } else {
+                usage(argv[0]);
+            }
+        } else if (strcmp(option, "-outliers") == 0) {
+            if (strcmp(value, "reject") == 0) {
+                config.rejectOutliers = 1;
+            } else if (strcmp(value, "keep") == 0) {
+                config.rejectOutliers = 0;
+            } else {
+                usage(argv[0]);
+            }
+        } else if (strcmp(option, "-loops") == 0) {
+            if (strcmp(value, "specialized") == 0) {
+                setGenericTransform(0);
+            } else if (strcmp(value, "generic") == 0) {
+                setGenericTransform(1);
+            } else {
+                usage(argv[0]);
+            }
+        } else if (strcmp(option, "-format") == 0) {
+            if (strcmp(value, "json") == 0) {
+                config.json = 1;
+            } else if (strcmp(value, "csv") == 0) {
+                config.json = 0;
+            } else {
+                usage(argv[0]);
+            }
+        } else if (strcmp(option, "-o") == 0) {
+            config.out = fopen(value, "w");
+            if (config.out == NULL) {
+                fprintf(stderr, "%s: cannot open '%s'\n", argv[0], value);
+                exit(1);
+            }
+        } else if (strcmp(option, "-record") == 0) {
+            baselinePath = value;
+            config.recording = 1;
+        } else if (strcmp(option, "-check") == 0) {
+            baselinePath = value;
+            config.recording = 0;
+        } else if (strcmp(option, "-tolerance") == 0) {
+            config.tolerance = atof(value);
+        } else if (strcmp(option, "-counter-tolerance") == 0) {
+            config.counterTolerance = atof(value);
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (config.nsizes <= 0 || config.nblocksizes <= 0 ||
+        config.nthreads <= 0 || config.reps <= 0 || config.warmup < 0) {
+        usage(argv[0]);
+    }
+    for (int k = 0; k < config.nthreads; k++) {
+        if (config.threads[k] <= 0) {
+            usage(argv[0]);
+        }
+    }
+
+    if (baselinePath != NULL) {
+        config.baseline = config.recording ? PerfBaseline_new()
+                                           : PerfBaseline_read(baselinePath);
+        if (config.baseline == NULL) {
+            fprintf(stderr, "%s: no baseline '%s' for this machine; "
+                            "record one first (make perf-record)\n",
+                    argv[0], baselinePath);
+            exit(2);
+        }
+    }
+
+    if (!config.json) {
+        fprintf(config.out, "width,height,layout,blocksize,threads,"
+                            "transform,cache,reps,rejected,median_ns,"
+                            "p10_ns,p90_ns,min_ns,max_ns,ns_per_pixel,"
+                            "gbps,memcpy_gbps,"
+                            "fraction_of_memcpy\n");
+    }
+
+    for (int s = 0; s < config.nsizes; s++) {
+        int width = config.widths[s];
+        int height = config.heights[s];
+        double memcpyNs = memcpyMedian(&config, (size_t)width * height *
+                                               sizeof(struct Pnm_rgb));
+        for (int l = 0; l < NLAYOUTS; l++) {
+            if (!config.useLayout[l]) {
+                continue;
+            }
+            if ((!layouts[l].blocked && !layouts[l].tiled) ||
+                layouts[l].cacheSized) {
+                benchLayout(&config, width, height, &layouts[l], 0,
+                            memcpyNs);
+                continue;
+            }
+            for (int b = 0; b < config.nblocksizes; b++) {
+                benchLayout(&config, width, height, &layouts[l],
+                            config.blocksizes[b], memcpyNs);
+            }
+        }
+    }
+
+    if (config.out != stdout) {
+        fclose(config.out);
+    }
+
+    if (config.baseline == NULL) {
+        return EXIT_SUCCESS;
+    }
+    int status = EXIT_SUCCESS;
+    if (config.recording) {
+        if (PerfBaseline_write(config.baseline, baselinePath) != 0) {
+            fprintf(stderr, "%s: cannot write '%s'\n", argv[0],
+                    baselinePath);
+            status = EXIT_FAILURE;
+        } else {
+            fprintf(stderr, "recorded baseline in %s\n", baselinePath);
+        }
+    } else if (config.regressions > 0) {
+        fprintf(stderr, "*** PERFORMANCE REGRESSION: %d benchmark(s) "
+                        "slower than %s ***\n",
+                config.regressions, baselinePath);
+        status = EXIT_FAILURE;
+    } else {
+        fprintf(stderr, "no regressions against %s (%d benchmark(s) "
+                        "without a baseline)\n",
+                baselinePath, config.unknown);
+    }
+    PerfBaseline_free(&config.baseline);
+    return status;
+}
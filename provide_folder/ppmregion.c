@@ -0,0 +1,229 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** ppmregion.c
+ ** 19 October 2026
+ **
+ ** Purpose: reads a rectangle of a raw (P6) ppm straight out of the
+ **          mapped file. The mapping is advised as random access, so the
+ **          kernel does not read ahead past the rows asked for, and the
+ **          pages of each row of the rectangle are asked for up front.
+ **          Samples are one byte when the denominator is below 256 and
+ **          two big-endian bytes otherwise, as in ppmbands.c.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "a2methods.h"
+#include "pnm.h"
+#include "ppmregion.h"
+
+#define T PPMRegion_T
+
+struct T {
+    unsigned char *map;
+    size_t size;
+    size_t raster;              /* offset of the first sample */
+    unsigned width, height, denominator;
+    int bytesPerSample;
+};
+
+/* @function: headerNumber
+ * @purpose: read one unsigned decimal number of the header starting at
+ *           *at, skipping whitespace and comments in front of it; *at is
+ *           left just past the single whitespace character that ends it
+ *
+ * @returns: 1 if a number was read, 0 otherwise
+ */
+static int headerNumber(const unsigned char *map, size_t size, size_t *at,
+                        unsigned *n)
+{
+    size_t i = *at;
+    while (i < size && (isspace(map[i]) || map[i] == '#')) {
+        if (map[i] == '#') {
+            while (i < size && map[i] != '\n') {
+                i++;
+            }
+        } else {
+            i++;
+        }
+    }
+    if (i >= size || !isdigit(map[i])) {
+        return 0;
+    }
+
+    *n = 0;
+    while (i < size && isdigit(map[i]) && *n <= 100000000) {
+        *n = *n * 10 + (map[i] - '0');
+        i++;
+    }
+    if (i >= size || !isspace(map[i])) {
+        return 0;
+    }
+    *at = i + 1;
+    return 1;
+}
+
+extern T PPMRegion_open(int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < 2) {
+        return NULL;
+    }
+    size_t size = st.st_size;
+    unsigned char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    madvise(map, size, MADV_RANDOM);
+
+    T region;
+    NEW(region);
+    region->map = map;
+    region->size = size;
+    region->raster = 2;
+    if (map[0] != 'P' || map[1] != '6' ||
+        !headerNumber(map, size, &region->raster, &region->width) ||
+        !headerNumber(map, size, &region->raster, &region->height) ||
+        !headerNumber(map, size, &region->raster, &region->denominator) ||
+        region->denominator == 0 || region->denominator > 65535) {
+        PPMRegion_free(&region);
+        return NULL;
+    }
+    region->bytesPerSample = region->denominator < 256 ? 1 : 2;
+
+    /* the whole raster must be there */
+    size_t rowBytes = (size_t)region->width * 3 * region->bytesPerSample;
+    if ((size - region->raster) / (rowBytes > 0 ? rowBytes : 1) <
+        region->height) {
+        PPMRegion_free(&region);
+        return NULL;
+    }
+    return region;
+}
+
+extern void PPMRegion_free(T *region)
+{
+    assert(region != NULL && *region != NULL);
+    munmap((*region)->map, (*region)->size);
+    FREE(*region);
+}
+
+extern unsigned PPMRegion_width(T region)
+{
+    assert(region != NULL);
+    return region->width;
+}
+
+extern unsigned PPMRegion_height(T region)
+{
+    assert(region != NULL);
+    return region->height;
+}
+
+extern unsigned PPMRegion_denominator(T region)
+{
+    assert(region != NULL);
+    return region->denominator;
+}
+
+/* @function: rowAt
+ * @purpose: the first sample of pixel (col, row) in the mapped file
+ */
+static const unsigned char *rowAt(T region, int col, int row)
+{
+    size_t pixelBytes = 3 * region->bytesPerSample;
+    return region->map + region->raster +
+           ((size_t)row * region->width + col) * pixelBytes;
+}
+
+/* @function: willNeed
+ * @purpose: ask for the pages of the bytes [first, first + n) of a map
+ *           to be read in, so the rows of a rectangle are read together
+ *           and not one fault at a time
+ */
+static void willNeed(const unsigned char *first, size_t n)
+{
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)first / page * page;
+    madvise((void *)start, (uintptr_t)first + n - start, MADV_WILLNEED);
+}
+
+extern Pnm_ppm PPMRegion_read(T region, A2Methods_T methods, int col,
+                              int row, int w, int h)
+{
+    assert(region != NULL && methods != NULL);
+    assert(col >= 0 && row >= 0 && w > 0 && h > 0);
+    assert((unsigned)(col + w) <= region->width);
+    assert((unsigned)(row + h) <= region->height);
+
+    size_t spanBytes = (size_t)w * 3 * region->bytesPerSample;
+    for (int r = 0; r < h; r++) {
+        willNeed(rowAt(region, col, row + r), spanBytes);
+    }
+
+    Pnm_ppm ppm;
+    NEW(ppm);
+    ppm->width = w;
+    ppm->height = h;
+    ppm->denominator = region->denominator;
+    ppm->methods = methods;
+    ppm->pixels = methods->new(w, h, sizeof(struct Pnm_rgb));
+
+    for (int r = 0; r < h; r++) {
+        const unsigned char *p = rowAt(region, col, row + r);
+        for (int c = 0; c < w; c++) {
+            Pnm_rgb pixel = methods->at(ppm->pixels, c, r);
+            if (region->bytesPerSample == 1) {
+                pixel->red   = p[0];
+                pixel->green = p[1];
+                pixel->blue  = p[2];
+                p += 3;
+            } else {
+                pixel->red   = (p[0] << 8) | p[1];
+                pixel->green = (p[2] << 8) | p[3];
+                pixel->blue  = (p[4] << 8) | p[5];
+                p += 6;
+            }
+        }
+    }
+    return ppm;
+}
+
+extern const unsigned char *PPMRegion_row(T region, int row)
+{
+    assert(region != NULL);
+    assert(row >= 0 && (unsigned)row < region->height);
+    const unsigned char *first = rowAt(region, 0, row);
+    willNeed(first, (size_t)region->width * 3 * region->bytesPerSample);
+    return first;
+}
+
+extern void PPMRegion_crop(Pnm_ppm ppm, int col, int row, int w, int h)
+{
+    assert(ppm != NULL);
+    assert(col >= 0 && row >= 0 && w > 0 && h > 0);
+    assert((unsigned)(col + w) <= ppm->width);
+    assert((unsigned)(row + h) <= ppm->height);
+
+    A2Methods_T methods = ppm->methods;
+    A2Methods_UArray2 pixels = ppm->pixels;
+    A2Methods_UArray2 cropped = methods->new(w, h, sizeof(struct Pnm_rgb));
+    for (int r = 0; r < h; r++) {
+        for (int c = 0; c < w; c++) {
+            *(Pnm_rgb)methods->at(cropped, c, r) =
+                    *(Pnm_rgb)methods->at(pixels, col + c, row + r);
+        }
+    }
+    methods->free(&pixels);
+    ppm->pixels = cropped;
+    ppm->width = w;
+    ppm->height = h;
+}
@@ -0,0 +1,80 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** ppmregion.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for ppmregion.c. Reads a rectangle of a raw
+ **          (P6) ppm file without reading the rest of it: the file is
+ **          mapped into memory and only the bytes of the rectangle's rows
+ **          are copied, so pages of the file outside them are never
+ **          touched. Images that cannot be mapped (pipes, P3) are read
+ **          whole and cut down with PPMRegion_crop.
+ **/
+
+#ifndef PPMREGION_INCLUDED
+#define PPMREGION_INCLUDED
+
+#include "a2methods.h"
+#include "pnm.h"
+
+#define T PPMRegion_T
+typedef struct T *T;
+
+/* @function: PPMRegion_open
+ * @purpose: map the raw ppm in fd and read its header
+ *
+ * @precondition: fd is open for reading, and nothing has been read from
+ *                it through stdio
+ * @postcondition: the file position of fd is unchanged
+ *
+ * @parameters: int fd, the file the image is read from (not closed)
+ * @returns: new type T, or NULL if fd is not a regular file holding a
+ *           whole P6 image
+ */
+extern T PPMRegion_open(int fd);
+
+/* @function: PPMRegion_free
+ * @purpose: unmap the file and deallocate the reader
+ */
+extern void PPMRegion_free(T *region);
+
+/* @function: PPMRegion_width, PPMRegion_height, PPMRegion_denominator
+ * @purpose: return the fields read from the header
+ */
+extern unsigned PPMRegion_width(T region);
+extern unsigned PPMRegion_height(T region);
+extern unsigned PPMRegion_denominator(T region);
+
+/* @function: PPMRegion_read
+ * @purpose: read the w x h rectangle at (col, row) of the image into a
+ *           new image of methods
+ *
+ * @precondition: the rectangle is not empty and is inside the image
+ *
+ * @parameters: 1) T region, the reader
+ *              2) A2Methods_T methods, the methods suite for the result
+ *              3) int col, int row, int w, int h, the rectangle
+ * @returns: the w x h image; free it with Pnm_ppmfree
+ */
+extern Pnm_ppm PPMRegion_read(T region, A2Methods_T methods, int col,
+                              int row, int w, int h);
+
+/* @function: PPMRegion_row
+ * @purpose: return the first sample of a row of the mapped image, its
+ *           samples as they are in the file (big-endian if the
+ *           denominator is above 255), having asked for its pages to be
+ *           read in
+ *
+ * @precondition: row is inside the image
+ */
+extern const unsigned char *PPMRegion_row(T region, int row);
+
+/* @function: PPMRegion_crop
+ * @purpose: replace ppm's image with its w x h rectangle at (col, row)
+ *
+ * @precondition: the rectangle is not empty and is inside the image
+ */
+extern void PPMRegion_crop(Pnm_ppm ppm, int col, int row, int w, int h);
+
+#undef T
+#endif /* PPMREGION_INCLUDED */
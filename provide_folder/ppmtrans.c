@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include "assert.h"
 #include "a2methods.h"
@@ -18,10 +19,28 @@
 #include "a2blocked.h"
 #include "pnm.h"
 #include "cputiming.h"
+#include "pipeline.h"
+#include "imageio.h"
+#include "timereport.h"
+#include "transform.h"
+#include "cachesim.h"
+#include "a2trace.h"
+#include "a2convert.h"
+#include "autoselect.h"
+#include "autotune.h"
+#include "anyangle.h"
+#include "resize.h"
+#include "ppmregion.h"
+#include "a2view.h"
+#include "ppm16.h"
+#include "pnmgray.h"
+#include "planar.h"
 
 #define TRUE 0
 #define FALSE 1
 
+#define DEFAULT_BAND_ROWS 64
+
 
 #define SET_METHODS(METHODS, MAP, WHAT) do {                    \
         methods = (METHODS);                                    \
@@ -38,254 +57,473 @@
 static void
 usage(const char *progname)
 {
-        fprintf(stderr, "Usage: %s [-rotate <angle>] "
-                        "[-{row,col,block}-major] [filename]\n",
+        fprintf(stderr, "Usage: %s [-rotate <degrees>] "
+                        "[-sample nearest|bilinear] "
+                        "[-scale <w>x<h> [-filter box|bilinear|lanczos]] "
+                        "[-crop <x>,<y>,<w>,<h>] [-view] [-planar] "
+                        "[-{row,col,block,tile}-major] [-two-level] "
+                        "[-tile <size>] "
+                        "[-convert] [-auto] [-untuned] [-threads <n>] "
+                        "[-pin <cpus>] [-cold] "
+                        "[-generic] "
+                        "[-simulate <machine> [-sim-layout <model>]] "
+                        "[-pipeline [-band <rows>] [-io-uring]] "
+                        "[-time <file> [-time-format text|json|csv]] "
+                        "[filename]\n",
                         progname);
         exit(1);
 }
 
-/* @function: apply90
- * @purpose: apply function to be passed in to map function to rotate
- *           image 90 degrees clockwise. The way our apply functions
- *           work, we iterate over the 2D array which will be the finished,
- *           rotated, image. The original image is passed in via the closure
- *           variable.
- *
- * @postcondition: the value at a given index will be set to value in
- *                 ppm 90 degrees COUNTERclockwise to current position in
- *                 array2
+/* @function: printCounters
+ * @purpose: helper function to write the hardware counters of the last
+ *           timed region to the time file, per pixel as well as in total,
+ *           naming any counter this machine could not provide
  *
- * @parameters: 1) int col, the col in the array2 we are at
- *              2) int row, the row in the array2 we are at
- *              3) A2Methods_UArray2 array2, the array2 we are iterating over
- *              4) A2MEthods_Object *ptr, the element at the given row and col
-                   in array2
- *              5) void *cl, the Pnm_ppm holding the original image we want to 
- *                 rotate
+ * @parameters: 1) FILE *output, the time file
+ *              2) CPUTime_T timer, the timer that was just stopped
+ *              3) double pixels, the number of pixels in the image, or
+ *                 0 if it is not known
  *
  * @returns: none
  */
-void apply90(int col, int row, A2Methods_UArray2 array2,
-            A2Methods_Object *ptr, void *cl)
+void printCounters(FILE *output, CPUTime_T timer, double pixels)
 {
-    (void) array2;
-    assert(ptr != NULL);
-    assert(cl != NULL);
-
-    Pnm_ppm *ppm = cl;
-    int oldRow = (*ppm)->height - col - 1;
-    int oldCol = row;
-
-    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
-                                                     oldCol, oldRow)); 
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        double count = CPUTime_Count(timer, i);
+        if (count < 0) {
+            fprintf(output, "%s: unavailable\n", CPUTime_CounterName(i));
+        } else if (pixels <= 0) {
+            fprintf(output, "%s: %.0f\n", CPUTime_CounterName(i), count);
+        } else {
+            fprintf(output, "%s: %.0f (%lf per pixel)\n",
+                    CPUTime_CounterName(i), count, count / pixels);
+        }
+    }
 }
 
-/* @function: apply180
- * @purpose: apply function to be passed in to map function to rotate
- *           image 180 degrees. 
+/* @function: describeTransform
+ * @purpose: helper function to name the transform for the time report,
+ *           e.g. "rotate 90", "rotate 0 flip vertical", "rotate 2.5"
  *
- * @postcondition: the value at a given index will be set to value in
- *                 ppm 180 degrees from current position in array2
+ * @parameters: 1) double degrees, char *flip, the transform
+ *              2) char *buf, size_t size, where the name is written
  *
- * @parameters: 1) int col, the col in the array2 we are at
- *              2) int row, the row in the array2 we are at
- *              3) A2Methods_UArray2 array2, the array2 we are iterating over
- *              4) A2MEthods_Object *ptr, the element at the given row and col
-                   in array2
- *              5) void *cl, the Pnm_ppm holding the original image we want to 
- *                 rotate
+ * @returns: buf
+ */
+char *describeTransform(double degrees, char *flip, char *buf, size_t size)
+{
+    if (strcmp(flip, "horizontal") == 0 || strcmp(flip, "vertical") == 0) {
+        snprintf(buf, size, "rotate %g flip %s", degrees, flip);
+    } else {
+        snprintf(buf, size, "rotate %g", degrees);
+    }
+    return buf;
+}
+
+/* @function: arrayBytes
+ * @purpose: helper function to find how many bytes an image array holds,
+ *           counting the padding of partial blocks in a blocked array
  *
- * @returns: none
+ * @parameters: 1) A2Methods_T methods, the methods suite of the array
+ *              2) A2Methods_UArray2 array, the array
+ *
+ * @returns: the size of the array's storage in bytes
  */
-void apply180(int col, int row, A2Methods_UArray2 array2,
-            A2Methods_Object *ptr, void *cl)
+double arrayBytes(A2Methods_T methods, A2Methods_UArray2 array)
 {
-    (void) array2;
-    assert(ptr != NULL);
-    assert(cl != NULL);
+    int bs = methods->blocksize(array);
+    double width = (methods->width(array) + bs - 1) / bs * bs;
+    double height = (methods->height(array) + bs - 1) / bs * bs;
+    return width * height * methods->size(array);
+}
 
-    Pnm_ppm *ppm = cl;
-    int oldRow = (*ppm)->height - row - 1;
-    int oldCol = (*ppm)->width - col - 1;
+/* @function: startPhase, stopPhase
+ * @purpose: helper functions to time a phase of main, if -time was given
+ */
+void startPhase(TimeReport_T report, TimeReport_Phase phase)
+{
+    if (report != NULL) {
+        TimeReport_start(report, phase);
+    }
+}
 
-    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
-                                                     oldCol, oldRow)); 
+void stopPhase(TimeReport_T report, TimeReport_Phase phase)
+{
+    if (report != NULL) {
+        TimeReport_stop(report, phase);
+    }
 }
 
-/* @function: apply270
- * @purpose: apply function to be passed in to map function to rotate
- *           image 270 degrees clockwise. 
- *
- * @postcondition: the value at a given index will be set to value in
- *                 ppm 270 degrees COUNTERclockwise from current position
- *                 in array2.
+/* @function: scaledSize
+ * @purpose: helper function to fill in the size -scale asks for. A 0
+ *           width or height keeps the aspect ratio of the from size.
  *
- * @parameters: 1) int col, the col in the array2 we are at
- *              2) int row, the row in the array2 we are at
- *              3) A2Methods_UArray2 array2, the array2 we are iterating over
- *              4) A2MEthods_Object *ptr, the element at the given row and col
-                   in array2
- *              5) void *cl, the Pnm_ppm holding the original image we want to 
- *                 rotate
+ * @parameters: 1) int width, int height, as given to -scale
+ *              2) int fromWidth, int fromHeight, the size being scaled
+ *              3) int *w, int *h, where the size is written
  *
  * @returns: none
  */
-void apply270(int col, int row, A2Methods_UArray2 array2,
-            A2Methods_Object *ptr, void *cl)
+void scaledSize(int width, int height, int fromWidth, int fromHeight,
+                int *w, int *h)
 {
-    (void) array2;
-    assert(ptr != NULL);
-    assert(cl != NULL);
-
-    Pnm_ppm *ppm = cl;
-    int oldRow = col;
-    int oldCol = (*ppm)->width - row - 1;
+    *w = width;
+    *h = height;
+    if (width == 0) {
+        *w = (int)((double)height * fromWidth / fromHeight + 0.5);
+    } else if (height == 0) {
+        *h = (int)((double)width * fromHeight / fromWidth + 0.5);
+    }
+    *w = *w > 0 ? *w : 1;
+    *h = *h > 0 ? *h : 1;
+}
 
-    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
-                                                     oldCol, oldRow)); 
+/* @function: scaleImage
+ * @purpose: helper function to replace ppm's image with a w x h copy
+ */
+void scaleImage(Pnm_ppm ppm, int w, int h, Resize_Filter filter,
+                int nthreads)
+{
+    A2Methods_UArray2 pixels = ppm->pixels;
+    ppm->pixels = Resize_scale(ppm, w, h, filter, nthreads);
+    ppm->methods->free(&pixels);
+    ppm->width = w;
+    ppm->height = h;
 }
 
-/* @function: applyFlipHorizontal
- * @purpose: apply function to be passed in to map function to flip
- *           image horizontally. 
- *
- * @postcondition: the value at a given index will be set to value in
- *                 ppm flipped across the horizontal axis
+/* @function: readRegion
+ * @purpose: helper function to read only what -crop needs: the rectangle
+ *           of the source the transform turns into the crop. A raw ppm
+ *           file is mapped and just that rectangle is read; anything else
+ *           is read whole and cut down. Exits if the crop is not inside
+ *           the transformed image.
  *
- * @parameters: 1) int col, the col in the array2 we are at
- *              2) int row, the row in the array2 we are at
- *              3) A2Methods_UArray2 array2, the array2 we are iterating over
- *              4) A2MEthods_Object *ptr, the element at the given row and col
- *                 in array2
- *              5) void *cl, the Pnm_ppm holding the original image we want to 
- *                 flip
+ * @parameters: 1) FILE *fp, the image, nothing read from it yet
+ *              2) A2Methods_T methods, the methods suite to read into
+ *              3) int rotation, double degrees, char *flip, int anyAngle,
+ *                 the transform, as main has them
+ *              4) AnyAngle_Region *region, with the crop in col, row, w
+ *                 and h; the rest is filled in
+ *              5) const char *progname, for the error message
  *
- * @returns: none
+ * @returns: the source rectangle, srcW x srcH at (srcCol, srcRow)
  */
-void applyFlipHorizontal(int col, int row, A2Methods_UArray2 array2,
-            A2Methods_Object *ptr, void *cl)
+Pnm_ppm readRegion(FILE *fp, A2Methods_T methods, int rotation,
+                   double degrees, char *flip, int anyAngle,
+                   AnyAngle_Region *region, const char *progname)
 {
-    (void) array2;
-    assert(ptr != NULL);
-    assert(cl != NULL);
+    Pnm_ppm ppm = NULL;
+    PPMRegion_T reader = PPMRegion_open(fileno(fp));
+    if (reader != NULL) {
+        region->width = PPMRegion_width(reader);
+        region->height = PPMRegion_height(reader);
+    } else {
+        ppm = Pnm_ppmread(fp, methods);
+        region->width = ppm->width;
+        region->height = ppm->height;
+    }
 
-    Pnm_ppm *ppm = cl;
-    int oldRow = (*ppm)->height - row - 1;
-    int oldCol = col;
+    int bad;
+    if (anyAngle == TRUE) {
+        bad = AnyAngle_region(degrees, flip, region);
+    } else {
+        region->srcCol = region->col;
+        region->srcRow = region->row;
+        region->srcW = region->w;
+        region->srcH = region->h;
+        bad = sourceRegion(rotation, flip, region->width, region->height,
+                           &region->srcCol, &region->srcRow,
+                           &region->srcW, &region->srcH);
+    }
+    if (bad != 0) {
+        fprintf(stderr, "%s: the crop is not inside the transformed "
+                        "image\n", progname);
+        exit(1);
+    }
 
-    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
-                                                     oldCol, oldRow)); 
+    if (reader != NULL) {
+        ppm = PPMRegion_read(reader, methods, region->srcCol,
+                             region->srcRow, region->srcW, region->srcH);
+        PPMRegion_free(&reader);
+    } else {
+        PPMRegion_crop(ppm, region->srcCol, region->srcRow, region->srcW,
+                       region->srcH);
+    }
+    return ppm;
 }
 
-/* @function: applyFlipVertical
- * @purpose: apply function to be passed in to map function to flip
- *           image vertically. 
- *
- * @postcondition: the value at a given index will be set to value in
- *                 ppm flipped across the vertical axis
- *
- * @parameters: 1) int col, the col in the array2 we are at
- *              2) int row, the row in the array2 we are at
- *              3) A2Methods_UArray2 array2, the array2 we are iterating over
- *              4) A2MEthods_Object *ptr, the element at the given row and col
- *                 in array2
- *              5) void *cl, the Pnm_ppm holding the original image we want to 
- *                 flip
- *
- * @returns: none
+/* @function: isCompact
+ * @purpose: helper function to look at the header of the image in fp,
+ *           without reading it, to see whether its samples are two bytes
+ *           and so it can be kept as struct Pnm_rgb16. Only a raw ppm in
+ *           a file can be looked at; anything else is not compact.
  */
-void applyFlipVertical(int col, int row, A2Methods_UArray2 array2,
-            A2Methods_Object *ptr, void *cl)
+int isCompact(FILE *fp)
 {
-    (void) array2;
-    assert(ptr != NULL);
-    assert(cl != NULL);
+    PPMRegion_T peek = PPMRegion_open(fileno(fp));
+    if (peek == NULL) {
+        return FALSE;
+    }
+    int compact = PPMRegion_denominator(peek) > 255 ? TRUE : FALSE;
+    PPMRegion_free(&peek);
+    return compact;
+}
 
-    Pnm_ppm *ppm = cl;
-    int oldRow = row;
-    int oldCol = (*ppm)->width - col - 1;
+/* @function: writeImage
+ * @purpose: helper function to write ppm to stdout, with the writer for
+ *           its kind of pixel: gray samples are 1 or 2 bytes, compact
+ *           color pixels 6 and struct Pnm_rgb 12
+ */
+void writeImage(Pnm_ppm ppm)
+{
+    int size = ppm->methods->size(ppm->pixels);
+    if (size == sizeof(struct Pnm_rgb16)) {
+        PPM16_write(stdout, ppm);
+    } else if (size < (int)sizeof(struct Pnm_rgb16)) {
+        PNMGray_write(stdout, ppm);
+    } else {
+        Pnm_ppmwrite(stdout, ppm);
+    }
+}
 
-    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
-                                                     oldCol, oldRow)); 
+/* @function: transformBitmap
+ * @purpose: helper function to read the bilevel image in fp, rotate and
+ *           flip it packed, and write it to stdout, timing each phase in
+ *           report if there is one. The report keeps transform, a buffer
+ *           of size bytes for the name of the transform.
+ */
+void transformBitmap(FILE *fp, int rotation, char *flip,
+                     TimeReport_T report, char *transform, size_t size)
+{
+    startPhase(report, PHASE_PARSE);
+    PNMGray_Bitmap bitmap = PNMGray_readBitmap(fp);
+    stopPhase(report, PHASE_PARSE);
+    if (report != NULL) {
+        TimeReport_image(report, PNMGray_bitmapWidth(bitmap),
+                         PNMGray_bitmapHeight(bitmap));
+        TimeReport_config(report, "bit-packed", 8, 1,
+                          describeTransform(rotation, flip, transform,
+                                            size));
+        TimeReport_allocated(report, 2 * PNMGray_bitmapBytes(bitmap));
+    }
+
+    startPhase(report, PHASE_TRANSFORM);
+    PNMGray_Bitmap transformed = PNMGray_transformBitmap(bitmap, rotation,
+                                                         flip);
+    stopPhase(report, PHASE_TRANSFORM);
+
+    startPhase(report, PHASE_WRITE);
+    PNMGray_writeBitmap(stdout, transformed);
+    stopPhase(report, PHASE_WRITE);
+    startPhase(report, PHASE_FREE);
+    PNMGray_freeBitmap(&bitmap);
+    PNMGray_freeBitmap(&transformed);
+    stopPhase(report, PHASE_FREE);
 }
 
-/* @function: newRotatedUArray2
- * @purpose: helper function to break up the code from main. Simply
- *           created new UArray2 in particular style
- *
- * @postcondition: new UArray2 is returned in proper format
- *
- * @parameters: 1) int rotation, the degrees we are rotating
- *              2) Pnm_ppm ppm, the image we are rotating
- *              3) A2Methods_T methods, the methods suite we are using
- *
- * @returns: A2Methods_UArray2, correctly formatted and initialized UArray2
+/* @function: transformPlanar
+ * @purpose: helper function to read the color image in fp into three
+ *           planes of methods, rotate and flip each plane, and write the
+ *           planes out as one image, timing each phase in report if there
+ *           is one. The report keeps layout, and transform, a buffer of
+ *           size bytes for the name of the transform.
  */
-A2Methods_UArray2 newRotatedUArray2(int rotation, Pnm_ppm ppm, 
-                                    A2Methods_T methods)
+void transformPlanar(FILE *fp, int rotation, char *flip, A2Methods_T methods,
+                     int nthreads, TimeReport_T report, char *layout,
+                     char *transform, size_t size)
 {
-    int newWidth = ppm->width;
-    int newHeight = ppm->height;
-    /* if rotating 90 or 270, height and width of
-     * image must be flipped 
-     */
-    if (rotation == 90 || rotation == 270) {
-        newHeight = ppm->width;
-        newWidth = ppm-> height;
+    startPhase(report, PHASE_PARSE);
+    Planar_T planar = Planar_read(fp, methods);
+    stopPhase(report, PHASE_PARSE);
+    if (report != NULL) {
+        TimeReport_image(report, Planar_width(planar),
+                         Planar_height(planar));
+        TimeReport_config(report, layout,
+                          methods->blocksize(Planar_plane(planar,
+                                                          PLANAR_RED)),
+                          nthreads > 1 ? 3 : 1,
+                          describeTransform(rotation, flip, transform,
+                                            size));
+        TimeReport_allocated(report, 2 * Planar_bytes(planar));
     }
-    return methods->new(newWidth, newHeight, sizeof(struct Pnm_rgb)); 
+
+    startPhase(report, PHASE_TRANSFORM);
+    Planar_T transformed = Planar_transform(planar, rotation, flip,
+                                            nthreads);
+    stopPhase(report, PHASE_TRANSFORM);
+
+    startPhase(report, PHASE_WRITE);
+    Planar_write(stdout, transformed);
+    stopPhase(report, PHASE_WRITE);
+    startPhase(report, PHASE_FREE);
+    Planar_free(&planar);
+    Planar_free(&transformed);
+    stopPhase(report, PHASE_FREE);
 }
 
-/* @function: alterImage
- * @purpose: helper function to break up the code from main. Handles
- *           calling proper rotation function given input.
- *
- * @postcondition: proper rotation function will be called
+/* @function: writeReport
+ * @purpose: helper function to finish the time file: the phase report is
+ *           appended to whatever has already been written to output
  *
- * @parameters: 1) int rotation, the rotation we are doing
- *              2) char *flip, the flip being called
- *              3) Pnm_ppm ppm, the image being rotated/flipped
- *              4) A2Methods_mapfun map, the map function that has been
- *                 determined by client
- *              5) A2Methods_UArray2 rotated, the uarray2 that will become
- *                 the fully rotated image.
+ * @parameters: 1) TimeReport_T *report, the report, which is freed
+ *              2) FILE *output, the time file, which is closed
+ *              3) TimeReport_Format format, how to write the report
  *
  * @returns: none
  */
-void alterImage(int rotation, char *flip, Pnm_ppm ppm, A2Methods_mapfun map, 
-                A2Methods_UArray2 rotated)
+void writeReport(TimeReport_T *report, FILE *output, TimeReport_Format format)
 {
-    switch (rotation) {
-            case 90:
-                map(rotated, apply90, &ppm);
-                break;
-            case 180:
-                map(rotated, apply180, &ppm);
-                break;
-            case 270:
-                map(rotated, apply270, &ppm);
-                break;
+    TimeReport_write(*report, output, format);
+    TimeReport_free(report);
+    fclose(output);
+}
+
+/* @function: runPipelined
+ * @purpose: helper function to break up the code from main. Runs the
+ *           whole read/transform/write in pipelined mode, timing it if
+ *           asked to, and reports bad input.
+ *
+ * @parameters: 1) FILE *fp, the image being read
+ *              2) int rotation, char *flip, the transform
+ *              3) A2Methods_T methods, the methods suite we are using
+ *              4) int bandRows, rows read and handed on at a time
+ *              5) ImageIO_Backend backend, how the files are read/written
+ *              6) char *time_file_name, where timing goes, or NULL
+ *              7) TimeReport_Format format, how the timing is written
+ *              8) char *layout, the name of the storage layout
+ *              9) int cold, TRUE if the caches were flushed first
+ *             10) char *progname, for error messages
+ *
+ * @returns: exit status for the program
+ */
+int runPipelined(FILE *fp, int rotation, char *flip, A2Methods_T methods,
+                 int bandRows, ImageIO_Backend backend,
+                 char *time_file_name, TimeReport_Format format,
+                 char *layout, int cold, char *progname)
+{
+        static const char *stageNames[PIPELINE_NSTAGES] = {
+            "read band", "transform band", "write band"
+        };
+        CPUTime_T timer = NULL;
+        CPUTime_T wallTimer = NULL;
+        CPUStats_T stageStats[PIPELINE_NSTAGES];
+        if (time_file_name != NULL) {
+            for (int i = 0; i < PIPELINE_NSTAGES; i++) {
+                stageStats[i] = CPUStats_New(stageNames[i], CPUTIME_THREAD);
+            }
+            timer = CPUTime_New();
+            wallTimer = CPUTime_NewWithClock(CPUTIME_WALL);
+            CPUTime_EnableCounters(timer);
+            CPUTime_Start(wallTimer);
+            CPUTime_Start(timer);
+        }
+
+        Pipeline_Info info = { 0, 0, 1 };
+        int result = Pipeline_run(fp, stdout, rotation, flip, methods,
+                                  bandRows, backend,
+                                  time_file_name != NULL ? stageStats
+                                                         : NULL,
+                                  &info);
+
+        if (time_file_name != NULL) {
+            static const TimeReport_Phase stagePhases[PIPELINE_NSTAGES] = {
+                PHASE_PARSE, PHASE_TRANSFORM, PHASE_WRITE
+            };
+            double timeTot = CPUTime_Stop(timer);
+            double wallTot = CPUTime_Stop(wallTimer);
+            FILE *output = fopen(time_file_name,
+                                 format == REPORT_TEXT ? "w" : "a");
+            if (output == NULL) {
+                fprintf(stderr, "%s: cannot open '%s'\n", progname,
+                        time_file_name);
+                exit(1);
+            }
+            if (format == REPORT_TEXT) {
+                fprintf(output, "Total time for pipelined %d degree \
+rotation (read, transform and write): %lf nanoseconds\n", rotation, timeTot);
+                fprintf(output, "Wall clock time: %lf nanoseconds\n",
+                        wallTot);
+                printCounters(output, timer, 0);
+            }
 
-            default:
-                break;
+            /* stages overlap, so only their CPU time is theirs alone */
+            char transform[64];
+            TimeReport_T report = TimeReport_new();
+            TimeReport_image(report, info.width, info.height);
+            TimeReport_config(report, layout, info.blocksize,
+                              PIPELINE_NSTAGES,
+                              describeTransform(rotation, flip, transform,
+                                                sizeof(transform)));
+            TimeReport_total(report, timeTot, wallTot);
+            TimeReport_cold(report, cold == TRUE);
+            TimeReport_counters(report, timer);
+            TimeReport_allocated(report, 2.0 * info.width * info.height *
+                                         sizeof(struct Pnm_rgb));
+            for (int i = 0; i < PIPELINE_NSTAGES; i++) {
+                if (format == REPORT_TEXT) {
+                    CPUStats_Print(output, stageStats[i]);
+                }
+                TimeReport_add(report, stagePhases[i],
+                               CPUStats_Total(stageStats[i]), -1);
+                CPUStats_Free(&stageStats[i]);
+            }
+            CPUTime_Free(&timer);
+            CPUTime_Free(&wallTimer);
+            writeReport(&report, output, format);
+        }
+        if (fp != stdin) {
+            fclose(fp);
         }
 
-        if (strcmp(flip, "horizontal") == 0) {
-            map(rotated, applyFlipHorizontal, &ppm);           
+        if (result == -1) {
+            fprintf(stderr, "%s: pipelined mode needs a raw (P6) ppm\n",
+                    progname);
+            return EXIT_FAILURE;
+        }
+        if (result == -2) {
+            fprintf(stderr, "%s: image is cut short\n", progname);
+            return EXIT_FAILURE;
         }
-        if (strcmp(flip, "vertical") == 0) {
-            map(rotated, applyFlipVertical, &ppm);           
+        if (result == -3) {
+            fprintf(stderr, "%s: error writing image\n", progname);
+            return EXIT_FAILURE;
         }
+        return EXIT_SUCCESS;
 }
 
 int main(int argc, char *argv[]) 
 {
         char *time_file_name = NULL;
         int   rotation       = 0;
+        double degrees       = 0;   /* any angle; rotation if exact */
+        int   anyAngle       = FALSE;
+        AnyAngle_Filter filter = ANYANGLE_BILINEAR;
+        int   scaling        = FALSE;
+        int   scaleWidth     = 0;   /* 0 keeps the aspect ratio */
+        int   scaleHeight    = 0;
+        Resize_Filter scaleFilter = RESIZE_BILINEAR;
+        int   cropping       = FALSE;
+        int   viewing        = FALSE;
+        int   planar         = FALSE;
+        AnyAngle_Region crop;       /* the crop, and what it reads */
         char *flip           = " ";
         int   i;
 
         int ppmOpen = FALSE;
+        int pipelined = FALSE;
+        int bandRows = DEFAULT_BAND_ROWS;
+        int nthreads = 1;
+        int cold = FALSE;
+        int convert = FALSE;
+        int autoSelect = FALSE;
+        int tuned = TRUE;
+        int tileGiven = FALSE;
+        char autoLayout[32];
+        ImageIO_Backend backend = IMAGEIO_PLAIN;
+        TimeReport_Format format = REPORT_TEXT;
+        char *layout = "row-major";
+        char *machine = NULL;
+        char *simLayout = "actual";
         FILE *fp = NULL;
         Pnm_ppm ppm;
 
@@ -301,28 +539,132 @@ int main(int argc, char *argv[])
                 if (strcmp(argv[i], "-row-major") == 0) {
                         SET_METHODS(uarray2_methods_plain, map_row_major, 
                     "row-major");
+                        layout = "row-major";
                 } else if (strcmp(argv[i], "-col-major") == 0) {
                         SET_METHODS(uarray2_methods_plain, map_col_major, 
                     "column-major");
+                        layout = "col-major";
                 } else if (strcmp(argv[i], "-block-major") == 0) {
                         SET_METHODS(uarray2_methods_blocked, map_block_major,
                                     "block-major");
+                        layout = "block-major";
+                } else if (strcmp(argv[i], "-tile-major") == 0) {
+                        /* plain storage, visited tile by tile */
+                        methods = uarray2_methods_plain;
+                        map = a2plain_map_tile_major;
+                        layout = "tile-major";
+                } else if (strcmp(argv[i], "-two-level") == 0) {
+                        /* blocks in superblocks, sized from the caches */
+                        SET_METHODS(uarray2_methods_blocked, map_block_major,
+                                    "block-major");
+                        a2blocked_set_cache_sized(1);
+                        layout = "two-level-block-major";
+                } else if (strcmp(argv[i], "-convert") == 0) {
+                        /* read and write row-major, transform blocked */
+                        convert = TRUE;
+                } else if (strcmp(argv[i], "-auto") == 0) {
+                        /* layout, map and threads picked per image */
+                        autoSelect = TRUE;
+                } else if (strcmp(argv[i], "-untuned") == 0) {
+                        tuned = FALSE;
+                } else if (strcmp(argv[i], "-tile") == 0) {
+                        if (!(i + 1 < argc)) {      /* no tile size */
+                                usage(argv[0]);
+                        }
+                        char *endptr;
+
+                        int tile = strtol(argv[++i], &endptr, 10);
+                        if (*endptr != '\0' || tile <= 0) {
+                                fprintf(stderr, 
+                    "Tile size must be a positive number\n");
+                                usage(argv[0]);
+                        }
+                        a2plain_set_tile_size(tile);
+                        tileGiven = TRUE;
                 } else if ((strcmp(argv[i], "-rotate") == 0)) {
                         if (!(i + 1 < argc)) {      /* no rotate value */
                                 usage(argv[0]);
                         }
                         char *endptr;
 
-                        rotation = strtol(argv[++i], &endptr, 10);
-                        if (!(rotation == 0 || rotation == 90 ||
-                            rotation == 180 || rotation == 270)) {
+                        degrees = strtod(argv[++i], &endptr);
+                        if (!(*endptr == '\0') || !isfinite(degrees)) {
+                                usage(argv[0]);     /* Not a number */
+                        }
+                        /* multiples of 90 are exact, the rest sampled */
+                        degrees = fmod(degrees, 360);
+                        if (degrees < 0) {
+                                degrees += 360;
+                        }
+                        anyAngle = fmod(degrees, 90) != 0 ? TRUE : FALSE;
+                        rotation = anyAngle == TRUE ? 0 : (int)degrees;
+                } else if (strcmp(argv[i], "-sample") == 0) {
+                        if (!(i + 1 < argc)) {      /* no filter */
+                                usage(argv[0]);
+                        }
+                        i++;
+                        if (strcmp(argv[i], "nearest") == 0) {
+                                filter = ANYANGLE_NEAREST;
+                        } else if (strcmp(argv[i], "bilinear") == 0) {
+                                filter = ANYANGLE_BILINEAR;
+                        } else {
                                 fprintf(stderr, 
-                    "Rotation must be 0, 90 180 or 270\n");
+                    "Sampling must be nearest or bilinear\n");
                                 usage(argv[0]);
                         }
-                        if (!(*endptr == '\0')) {    /* Not a number */
+                } else if (strcmp(argv[i], "-scale") == 0) {
+                        if (!(i + 1 < argc)) {      /* no size */
                                 usage(argv[0]);
                         }
+                        char x, end;
+
+                        if (sscanf(argv[++i], "%d%c%d%c", &scaleWidth, &x,
+                                   &scaleHeight, &end) != 3 || x != 'x' ||
+                            scaleWidth < 0 || scaleHeight < 0 ||
+                            scaleWidth + scaleHeight == 0) {
+                                fprintf(stderr, 
+                    "Scale must be <width>x<height>, with 0 for either "
+                    "to keep the aspect ratio\n");
+                                usage(argv[0]);
+                        }
+                        scaling = TRUE;
+                } else if (strcmp(argv[i], "-filter") == 0) {
+                        if (!(i + 1 < argc)) {      /* no filter */
+                                usage(argv[0]);
+                        }
+                        i++;
+                        if (strcmp(argv[i], "box") == 0) {
+                                scaleFilter = RESIZE_BOX;
+                        } else if (strcmp(argv[i], "bilinear") == 0) {
+                                scaleFilter = RESIZE_BILINEAR;
+                        } else if (strcmp(argv[i], "lanczos") == 0) {
+                                scaleFilter = RESIZE_LANCZOS;
+                        } else {
+                                fprintf(stderr, 
+                    "Filter must be box, bilinear or lanczos\n");
+                                usage(argv[0]);
+                        }
+                } else if (strcmp(argv[i], "-view") == 0) {
+                        /* write through a view, copying nothing */
+                        viewing = TRUE;
+                } else if (strcmp(argv[i], "-planar") == 0) {
+                        /* a plane of samples per channel */
+                        planar = TRUE;
+                } else if (strcmp(argv[i], "-crop") == 0) {
+                        if (!(i + 1 < argc)) {      /* no rectangle */
+                                usage(argv[0]);
+                        }
+                        char end;
+
+                        if (sscanf(argv[++i], "%d,%d,%d,%d%c", &crop.col,
+                                   &crop.row, &crop.w, &crop.h, &end) != 4
+                            || crop.col < 0 || crop.row < 0 ||
+                            crop.w <= 0 || crop.h <= 0) {
+                                fprintf(stderr, 
+                    "Crop must be <x>,<y>,<width>,<height>\n");
+                                usage(argv[0]);
+                        }
+                        cropping = TRUE;
                 } else if ((strcmp(argv[i], "-flip") == 0)) {
                         if (!(i + 1 < argc)) {      /* no rotate value */
                                 usage(argv[0]);
@@ -337,13 +679,82 @@ int main(int argc, char *argv[])
                         }
                 } else if (strcmp(argv[i], "-time") == 0) {
                         time_file_name = argv[++i];
+                } else if (strcmp(argv[i], "-time-format") == 0) {
+                        if (!(i + 1 < argc)) {      /* no format */
+                                usage(argv[0]);
+                        }
+                        i++;
+                        if (strcmp(argv[i], "text") == 0) {
+                                format = REPORT_TEXT;
+                        } else if (strcmp(argv[i], "json") == 0) {
+                                format = REPORT_JSON;
+                        } else if (strcmp(argv[i], "csv") == 0) {
+                                format = REPORT_CSV;
+                        } else {
+                                fprintf(stderr, 
+                    "Time format must be text, json or csv\n");
+                                usage(argv[0]);
+                        }
+                } else if (strcmp(argv[i], "-pipeline") == 0) {
+                        pipelined = TRUE;
+                } else if (strcmp(argv[i], "-io-uring") == 0) {
+                        backend = IMAGEIO_URING;
+                } else if (strcmp(argv[i], "-band") == 0) {
+                        if (!(i + 1 < argc)) {      /* no band height */
+                                usage(argv[0]);
+                        }
+                        char *endptr;
+
+                        bandRows = strtol(argv[++i], &endptr, 10);
+                        if (*endptr != '\0' || bandRows <= 0) {
+                                fprintf(stderr, 
+                    "Band height must be a positive number of rows\n");
+                                usage(argv[0]);
+                        }
+                } else if (strcmp(argv[i], "-threads") == 0) {
+                        if (!(i + 1 < argc)) {      /* no thread count */
+                                usage(argv[0]);
+                        }
+                        char *endptr;
+
+                        nthreads = strtol(argv[++i], &endptr, 10);
+                        if (*endptr != '\0' || nthreads <= 0) {
+                                fprintf(stderr, 
+                    "Thread count must be a positive number\n");
+                                usage(argv[0]);
+                        }
+                } else if (strcmp(argv[i], "-pin") == 0) {
+                        if (!(i + 1 < argc)) {      /* no CPU list */
+                                usage(argv[0]);
+                        }
+                        if (CPUTime_PinCPUs(argv[++i]) != 0) {
+                                fprintf(stderr, "%s: cannot pin to CPUs "
+                                        "'%s'\n", argv[0], argv[i]);
+                                exit(1);
+                        }
+                } else if (strcmp(argv[i], "-cold") == 0) {
+                        cold = TRUE;
+                } else if (strcmp(argv[i], "-generic") == 0) {
+                        setGenericTransform(1);
+                } else if (strcmp(argv[i], "-simulate") == 0) {
+                        if (!(i + 1 < argc)) {      /* no machine */
+                                usage(argv[0]);
+                        }
+                        machine = argv[++i];
+                } else if (strcmp(argv[i], "-sim-layout") == 0) {
+                        if (!(i + 1 < argc)) {      /* no layout model */
+                                usage(argv[0]);
+                        }
+                        simLayout = argv[++i];
                 } else if (*argv[i] == '-') {
                         fprintf(stderr, "%s: unknown option '%s'\n", argv[0],
                 argv[i]);
                 } else if (ppmOpen != TRUE) {
                         fp = fopen(argv[i], "r");
-                        if (fp != NULL) {
-                            ppm = Pnm_ppmread(fp, methods);
+                        if (fp == NULL) {
+                                fprintf(stderr, "%s: cannot open '%s'\n",
+                                        argv[0], argv[i]);
+                                exit(1);
                         }
                         ppmOpen = TRUE;
                 } else if (argc - i > 1) {
@@ -356,64 +767,433 @@ int main(int argc, char *argv[])
 
         /* if after all args still need image, take from stdin */
         if (ppmOpen != TRUE) {
-            ppm = Pnm_ppmread(stdin, methods);
+            fp = stdin;
+        }
+
+        if (anyAngle == TRUE && pipelined == TRUE) {
+            fprintf(stderr, "%s: -pipeline only rotates by multiples of "
+                            "90 degrees\n", argv[0]);
+            exit(1);
+        }
+        if (scaling == TRUE && pipelined == TRUE) {
+            fprintf(stderr, "%s: -scale cannot be used with -pipeline\n",
+                    argv[0]);
+            exit(1);
+        }
+        if (cropping == TRUE && (pipelined == TRUE || scaling == TRUE)) {
+            fprintf(stderr, "%s: -crop cannot be used with -pipeline or "
+                            "-scale\n", argv[0]);
+            exit(1);
+        }
+        if (viewing == TRUE && (anyAngle == TRUE || pipelined == TRUE ||
+                                convert == TRUE || autoSelect == TRUE ||
+                                machine != NULL)) {
+            fprintf(stderr, "%s: -view only rotates by multiples of 90 "
+                            "degrees, and cannot be used with -pipeline, "
+                            "-convert, -auto or -simulate\n", argv[0]);
+            exit(1);
+        }
+        /* gray and bilevel images are only rotated and flipped; the
+         * pipeline reads the file itself, so it is not looked at */
+        PNMGray_Kind kind = pipelined == TRUE ? PNMGRAY_COLOR
+                                              : PNMGray_kind(fp);
+        if (kind != PNMGRAY_COLOR &&
+            (anyAngle == TRUE || scaling == TRUE || cropping == TRUE ||
+             convert == TRUE || autoSelect == TRUE || machine != NULL)) {
+            fprintf(stderr, "%s: gray and bilevel images only rotate by "
+                            "multiples of 90 degrees and flip\n", argv[0]);
+            exit(1);
+        }
+        if (planar == TRUE && (kind != PNMGRAY_COLOR || anyAngle == TRUE ||
+                               scaling == TRUE || cropping == TRUE ||
+                               pipelined == TRUE || viewing == TRUE ||
+                               convert == TRUE || autoSelect == TRUE ||
+                               machine != NULL)) {
+            fprintf(stderr, "%s: -planar only rotates color images by "
+                            "multiples of 90 degrees and flips them, and "
+                            "cannot be used with -pipeline, -view, "
+                            "-convert, -auto or -simulate\n", argv[0]);
+            exit(1);
+        }
+        int identity = (degrees == 0 && strcmp(flip, " ") == 0);
+        if (autoSelect == TRUE) {
+            if (pipelined == TRUE || machine != NULL) {
+                fprintf(stderr, "%s: -auto cannot be used with "
+                                "-pipeline or -simulate\n", argv[0]);
+                exit(1);
+            }
+            methods = uarray2_methods_plain;    /* read row-major */
+            map = methods->map_row_major;
+            layout = "auto";
+        }
+        if (convert == TRUE) {
+            if (pipelined == TRUE || machine != NULL) {
+                fprintf(stderr, "%s: -convert cannot be used with "
+                                "-pipeline or -simulate\n", argv[0]);
+                exit(1);
+            }
+            methods = uarray2_methods_plain;
+            layout = "converted-block-major";
+        }
+
+        /* block and tile sizes tuned for this CPU by ppmtune, if there
+         * is a tuning file; -tile still wins */
+        int tunedBlock, tunedTile;
+        if (tuned == TRUE && Autotune_consult("rgb", rotation, flip,
+                                              &tunedBlock, &tunedTile) == 0) {
+            a2blocked_set_blocksize(tunedBlock);
+            if (tileGiven == FALSE) {
+                a2plain_set_tile_size(tunedTile);
+            }
+        }
+
+        /* -simulate: trace the transform through a cache simulator. The
+         * trace is one access stream, so it is single threaded */
+        CacheSim_T sim = NULL;
+        if (machine != NULL) {
+            if (pipelined == TRUE || nthreads > 1) {
+                fprintf(stderr, "%s: -simulate cannot be used with "
+                                "-pipeline or -threads\n", argv[0]);
+                exit(1);
+            }
+            sim = CacheSim_new(machine);
+            if (sim == NULL) {
+                fprintf(stderr, "%s: bad machine description '%s'\n",
+                        argv[0], machine);
+                exit(1);
+            }
+            methods = A2Trace_wrap(methods, sim, simLayout);
+            if (methods == NULL) {
+                fprintf(stderr, "%s: bad layout model '%s'\n", argv[0],
+                        simLayout);
+                exit(1);
+            }
+            map = A2Trace_map(map);
+        }
+
+        if (pipelined == TRUE) {
+            if (cold == TRUE) {
+                CPUTime_FlushCaches();
+            }
+            exit(runPipelined(fp, rotation, flip, methods, bandRows,
+                              backend, time_file_name, format, layout,
+                              cold, argv[0]));
+        }
+
+        /* if -time has been invoked, time every phase from here on;
+         * text goes to a fresh file, JSON and CSV lines are appended */
+        FILE *output = NULL;
+        TimeReport_T report = NULL;
+        char transform[64];
+        if (time_file_name != NULL) {
+            output = fopen(time_file_name, format == REPORT_TEXT ? "w" : "a");
+            if (output == NULL) {
+                fprintf(stderr, "%s: cannot open '%s'\n", argv[0],
+                        time_file_name);
+                exit(1);
+            }
+            report = TimeReport_new();
+        }
+
+        /* a bitmap never leaves its packed bytes */
+        if (kind == PNMGRAY_BILEVEL) {
+            transformBitmap(fp, rotation, flip, report, transform,
+                            sizeof(transform));
+            if (report != NULL) {
+                writeReport(&report, output, format);
+            }
+            if (fp != stdin) {
+                fclose(fp);
+            }
+            exit(EXIT_SUCCESS);
+        }
+
+        /* -planar: the image never is an array of struct Pnm_rgb */
+        if (planar == TRUE) {
+            snprintf(autoLayout, sizeof(autoLayout), "planar:%s", layout);
+            transformPlanar(fp, rotation, flip, methods, nthreads, report,
+                            autoLayout, transform, sizeof(transform));
+            if (report != NULL) {
+                writeReport(&report, output, format);
+            }
+            if (fp != stdin) {
+                fclose(fp);
+            }
+            exit(EXIT_SUCCESS);
+        }
+
+        /* two-byte samples are kept in 6 bytes a pixel rather than 12,
+         * and gray ones in 1 or 2 bytes, for the transforms that work on
+         * any element size. -convert and -auto still apply: they only
+         * pick the storage, and a compact image is always transformed
+         * through a view */
+        int compact = kind == PNMGRAY_GRAY ? TRUE : FALSE;
+        if (kind == PNMGRAY_COLOR && anyAngle != TRUE && scaling != TRUE &&
+            cropping != TRUE && sim == NULL) {
+            compact = isCompact(fp);
+        }
+
+        startPhase(report, PHASE_PARSE);
+        if (kind == PNMGRAY_GRAY) {
+            ppm = PNMGray_read(fp, methods);
+        } else if (compact == TRUE) {
+            ppm = PPM16_read(fp, methods);
+        } else if (cropping == TRUE) {
+            ppm = readRegion(fp, methods, rotation, degrees, flip, anyAngle,
+                             &crop, argv[0]);
+        } else {
+            ppm = Pnm_ppmread(fp, methods);
+        }
+        stopPhase(report, PHASE_PARSE);
+
+        /* -auto: now the shape is known, pick how to transform it; a
+         * blocked choice is carried out as -convert */
+        if (autoSelect == TRUE) {
+            AutoSelect_Choice choice =
+                    AutoSelect_choose(rotation, flip, ppm->width,
+                                      ppm->height,
+                                      methods->size(ppm->pixels));
+            map = choice.map;
+            nthreads = choice.nthreads;
+            if (choice.blocksize > 0) {
+                a2plain_set_tile_size(choice.blocksize);
+            }
+            convert = (choice.methods == uarray2_methods_blocked);
+            snprintf(autoLayout, sizeof(autoLayout), "auto:%s",
+                     choice.name);
+            layout = autoLayout;
+            if (report != NULL && format == REPORT_TEXT) {
+                fprintf(output, "Auto selection: %s, %d thread(s); "
+                        "estimated ns/pixel: row-major %.2f, col-major "
+                        "%.2f, tile-major %.2f, block-major %.2f\n",
+                        choice.name, choice.nthreads,
+                        choice.estimates[AUTOSELECT_ROW],
+                        choice.estimates[AUTOSELECT_COL],
+                        choice.estimates[AUTOSELECT_TILE],
+                        choice.estimates[AUTOSELECT_BLOCK]);
+            }
+        }
+
+        /* -convert: move the image into blocks for the transform; there
+         * is nothing to gain if there is no transform */
+        if (convert == TRUE && !identity) {
+            startPhase(report, PHASE_CONVERT);
+            A2Methods_UArray2 plain = ppm->pixels;
+            ppm->pixels = A2Convert_toBlocked(plain, 0, nthreads);
+            methods->free(&plain);
+            methods = uarray2_methods_blocked;
+            map = methods->map_block_major;
+            ppm->methods = methods;
+            stopPhase(report, PHASE_CONVERT);
+        }
+        if (report != NULL) {
+            TimeReport_image(report, ppm->width, ppm->height);
+            TimeReport_config(report, layout,
+                              strstr(layout, "tile-major") != NULL
+                                  ? a2plain_tile_size(ppm->pixels)
+                                  : methods->blocksize(ppm->pixels),
+                              nthreads,
+                              describeTransform(degrees, flip, transform,
+                                                sizeof(transform)));
+            TimeReport_cold(report, cold == TRUE);
+            TimeReport_allocated(report, arrayBytes(methods, ppm->pixels));
+        }
+
+        /* -scale with an exact transform: scale the source to the size
+         * that transforms to the one asked for, so the full-size result
+         * is never made. The scaling counts as part of the transform */
+        if (scaling == TRUE && anyAngle != TRUE && ppm->width > 0 &&
+            ppm->height > 0) {
+            int quarter = (rotation == 90 || rotation == 270);
+            int w, h;
+            if (quarter) {
+                scaledSize(scaleWidth, scaleHeight, ppm->height,
+                           ppm->width, &h, &w);
+            } else {
+                scaledSize(scaleWidth, scaleHeight, ppm->width,
+                           ppm->height, &w, &h);
+            }
+            startPhase(report, PHASE_TRANSFORM);
+            scaleImage(ppm, w, h, scaleFilter, nthreads);
+            stopPhase(report, PHASE_TRANSFORM);
         }
 
         /* if no rotation or flip given, default to 0 degrees */
-        if (rotation == 0 && strcmp(flip, " ") == 0) {
-            Pnm_ppmwrite(stdout, ppm);
+        if (identity) {
+            startPhase(report, PHASE_WRITE);
+            writeImage(ppm);
+            stopPhase(report, PHASE_WRITE);
+            startPhase(report, PHASE_FREE);
             Pnm_ppmfree(&ppm);
-            if (fp != NULL) {
+            stopPhase(report, PHASE_FREE);
+            if (report != NULL) {
+                writeReport(&report, output, format);
+            }
+            if (fp != stdin) {
                 fclose(fp);
             } 
             exit(EXIT_SUCCESS);
         }
 
-        A2Methods_UArray2 rotated = newRotatedUArray2(rotation, ppm, methods);
+        /* -view: the writer reads the source through a view of it, so no
+         * transformed copy is made */
+        if (viewing == TRUE) {
+            startPhase(report, PHASE_TRANSFORM);
+            A2Methods_UArray2 source = ppm->pixels;
+            ppm->pixels = A2View_new(methods, source, rotation, flip);
+            ppm->methods = a2view_methods;
+            ppm->width = a2view_methods->width(ppm->pixels);
+            ppm->height = a2view_methods->height(ppm->pixels);
+            stopPhase(report, PHASE_TRANSFORM);
+
+            startPhase(report, PHASE_WRITE);
+            writeImage(ppm);
+            stopPhase(report, PHASE_WRITE);
+            startPhase(report, PHASE_FREE);
+            Pnm_ppmfree(&ppm);          /* the view */
+            methods->free(&source);
+            stopPhase(report, PHASE_FREE);
+            if (report != NULL) {
+                writeReport(&report, output, format);
+            }
+            if (fp != stdin) {
+                fclose(fp);
+            }
+            exit(EXIT_SUCCESS);
+        }
+
+        startPhase(report, PHASE_ALLOCATE);
+        A2Methods_UArray2 rotated;
+        if (anyAngle == TRUE && cropping == TRUE) {
+            rotated = methods->new(crop.w, crop.h, sizeof(struct Pnm_rgb));
+        } else if (anyAngle == TRUE) {
+            rotated = AnyAngle_new(degrees, ppm);
+        } else {
+            /* a cropped source transforms to just the crop */
+            rotated = newRotatedUArray2(rotation, ppm, methods);
+        }
+        stopPhase(report, PHASE_ALLOCATE);
 
-        /* if -time has been invoked, start timing */
-        FILE *output;
         CPUTime_T timer;
+        CPUTime_T wallTimer;
         double timeTot;
-        if (time_file_name != NULL) {
-            output = fopen(time_file_name, "w");
+        if (report != NULL) {
+            TimeReport_allocated(report, arrayBytes(methods, rotated));
             timer = CPUTime_New();
-            fprintf(output, "Time Data for Image of height: %d \
+            wallTimer = CPUTime_NewWithClock(CPUTIME_WALL);
+            CPUTime_EnableCounters(timer);
+            if (format == REPORT_TEXT) {
+                fprintf(output, "Time Data for Image of height: %d \
 and width: %d\n", ppm->height, ppm->width); 
+            }
+            /* -cold: the transform starts with neither image cached */
+            if (cold == TRUE) {
+                CPUTime_FlushCaches();
+            }
+            CPUTime_Start(wallTimer);
             CPUTime_Start(timer);
         }
         else {
-            (void) output;
             (void) timer;
+            (void) wallTimer;
             (void) timeTot;
         }
 
         /*................... PERFORM OPERATION ...................*/
 
-        alterImage(rotation, flip, ppm, map, rotated);
+        if (sim != NULL) {
+            A2Trace_start();
+        }
+        if (compact == TRUE) {
+            /* copied through a view, which takes any element size */
+            A2Methods_UArray2 view = A2View_new(methods, ppm->pixels,
+                                                rotation, flip);
+            A2View_fill(view, methods, rotated);
+            a2view_methods->free(&view);
+        } else if (anyAngle == TRUE && cropping == TRUE) {
+            AnyAngle_rotateRegion(degrees, flip, filter, &crop, ppm, rotated,
+                                  nthreads);
+        } else if (anyAngle == TRUE) {
+            AnyAngle_rotate(degrees, flip, filter, ppm, rotated, nthreads);
+        } else if (nthreads > 1) {
+            alterImageThreaded(rotation, flip, ppm, map, rotated,
+                               nthreads);
+        } else {
+            alterImage(rotation, flip, ppm, map, rotated);
+        }
+        if (sim != NULL) {
+            A2Trace_stop();
+        }
 
         /* if -time has been invoked, stop timing */
-        if (time_file_name != NULL) {
+        if (report != NULL) {
             timeTot = CPUTime_Stop(timer);
-            fprintf(output, "Total time for %d degree rotation: %lf \
-nanoseconds\n", rotation, timeTot);
-            fprintf(output, "Time for each pixel: %lf nanoseconds\n", 
-                    timeTot / (ppm->width * ppm->height));   
+            double wallTot = CPUTime_Stop(wallTimer);
+            if (format == REPORT_TEXT) {
+                fprintf(output, "Total time for %g degree rotation: %lf \
+nanoseconds\n", degrees, timeTot);
+                fprintf(output, "Wall clock time: %lf nanoseconds\n",
+                        wallTot);
+                fprintf(output, "Time for each pixel: %lf nanoseconds\n", 
+                        timeTot / (ppm->width * ppm->height));   
+                printCounters(output, timer, 
+                              (double)ppm->width * ppm->height);
+            }
+            TimeReport_add(report, PHASE_TRANSFORM, timeTot, wallTot);
+            TimeReport_counters(report, timer);
             CPUTime_Free(&timer);
-            fclose(output);
+            CPUTime_Free(&wallTimer);
         }
-        
 
         /* copy rotated image back to Pnm_ppm and write out */
+        startPhase(report, PHASE_CONVERT);
         A2Methods_UArray2 pixels = ppm->pixels;
         methods->free(&pixels);
         ppm->pixels = rotated;
         ppm->height = methods->height(rotated);
         ppm->width = methods->width(rotated);
-        Pnm_ppmwrite(stdout, ppm);
+        stopPhase(report, PHASE_CONVERT);
+
+        /* -scale with any other angle: the rotated image is sampled
+         * already, so it is scaled after */
+        if (scaling == TRUE && anyAngle == TRUE && ppm->width > 0 &&
+            ppm->height > 0) {
+            int w, h;
+            scaledSize(scaleWidth, scaleHeight, ppm->width, ppm->height,
+                       &w, &h);
+            startPhase(report, PHASE_TRANSFORM);
+            scaleImage(ppm, w, h, scaleFilter, nthreads);
+            stopPhase(report, PHASE_TRANSFORM);
+            rotated = ppm->pixels;
+        }
 
+        startPhase(report, PHASE_CONVERT);
+        if (convert == TRUE) {      /* back to rows for the writer */
+            ppm->pixels = A2Convert_toPlain(rotated, nthreads);
+            methods->free(&rotated);
+            ppm->methods = uarray2_methods_plain;
+        }
+        stopPhase(report, PHASE_CONVERT);
+
+        startPhase(report, PHASE_WRITE);
+        writeImage(ppm);
+        stopPhase(report, PHASE_WRITE);
+
+        startPhase(report, PHASE_FREE);
         Pnm_ppmfree(&ppm);
-        if (fp != NULL) {
+        stopPhase(report, PHASE_FREE);
+        if (report != NULL) {
+            writeReport(&report, output, format);
+        }
+        if (sim != NULL) {
+            fprintf(stderr, "Simulated %s, %s layout model, %s:\n",
+                    machine, simLayout,
+                    describeTransform(degrees, flip, transform,
+                                      sizeof(transform)));
+            CacheSim_print(sim, stderr);
+            CacheSim_free(&sim);
+        }
+        if (fp != stdin) {
             fclose(fp);
         } 
 
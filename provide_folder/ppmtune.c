@@ -0,0 +1,71 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** ppmtune.c
+ ** 19 October 2026
+ **
+ ** Purpose: tune the block and tile sizes ppmtrans uses on this machine.
+ **          Times every candidate for every transform and writes the
+ **          winners to the tuning file under this CPU's model, where
+ **          ppmtrans finds them at startup.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assert.h"
+#include "cputiming.h"
+#include "autotune.h"
+
+static void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s [-file <tuning file>] [-size <w>x<h>] "
+                    "[-reps <n>] [-pin <cpus>] [-quiet]\n", progname);
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *file = Autotune_file();
+    int width = AUTOTUNE_WIDTH;
+    int height = AUTOTUNE_HEIGHT;
+    int reps = AUTOTUNE_REPS;
+    FILE *log = stdout;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-file") == 0 && i + 1 < argc) {
+            file = argv[++i];
+        } else if (strcmp(argv[i], "-size") == 0 && i + 1 < argc) {
+            char x;
+            if (sscanf(argv[++i], "%d%c%d", &width, &x, &height) != 3 ||
+                x != 'x' || width <= 0 || height <= 0) {
+                usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "-reps") == 0 && i + 1 < argc) {
+            char *end;
+            reps = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || reps <= 0) {
+                usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "-pin") == 0 && i + 1 < argc) {
+            if (CPUTime_PinCPUs(argv[++i]) != 0) {
+                fprintf(stderr, "%s: cannot pin to CPUs '%s'\n", argv[0],
+                        argv[i]);
+                exit(1);
+            }
+        } else if (strcmp(argv[i], "-quiet") == 0) {
+            log = NULL;
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    if (Autotune_run(file, width, height, reps, log) != 0) {
+        fprintf(stderr, "%s: cannot write '%s'\n", argv[0], file);
+        exit(1);
+    }
+    if (log != NULL) {
+        fprintf(log, "Wrote %s\n", file);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,315 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** resize.c
+ ** 19 October 2026
+ **
+ ** Purpose: separable resizing. For every output column (and row) the
+ **          source pixels it draws on and their weights are worked out
+ **          once; a band of output rows then costs one pass along the
+ **          source rows it needs and one pass down the result. UArray2
+ **          and UArray2b images are read and written through their
+ **          storage; any other methods suite goes through at().
+ **/
+
+#include <math.h>
+#include <pthread.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+#include "pnm.h"
+#include "transloops.h"
+#include "resize.h"
+
+#define PI 3.14159265358979323846
+#define BAND_ROWS 32            /* for arrays without blocks */
+
+typedef A2Methods_UArray2 A2;
+
+/* the source pixels output pixel i draws on: count of them from first,
+ * weighted by weights[i * stride .. i * stride + count - 1] */
+struct Taps {
+    int *first, *count;
+    float *weights;
+    int stride;
+};
+
+/* an image, and how to get at its pixels */
+struct Image {
+    TransLoops_Image storage;   /* unused when direct is 0 */
+    int direct;                 /* 1 for UArray2 and UArray2b */
+    A2Methods_T methods;
+    A2 array;
+};
+
+/* what every thread shares, and the bands that are one thread's */
+struct Job {
+    const struct Image *src, *dst;
+    const struct Taps *across, *down;
+    int width, height;
+    int band;
+    unsigned denominator;
+    int firstBand, lastBand;
+};
+
+/* @function: support
+ * @purpose: how far either side of the centre a filter reaches, in
+ *           output pixels
+ */
+static double support(Resize_Filter filter)
+{
+    switch (filter) {
+        case RESIZE_BOX:
+            return 0.5;
+        case RESIZE_BILINEAR:
+            return 1.0;
+        default:
+            return 3.0;
+    }
+}
+
+static double sinc(double x)
+{
+    return x == 0 ? 1.0 : sin(PI * x) / (PI * x);
+}
+
+/* @function: filterAt
+ * @purpose: the filter's weight at distance x from the centre
+ */
+static double filterAt(Resize_Filter filter, double x)
+{
+    x = fabs(x);
+    switch (filter) {
+        case RESIZE_BOX:
+            return x <= 0.5 ? 1.0 : 0.0;
+        case RESIZE_BILINEAR:
+            return x < 1.0 ? 1.0 - x : 0.0;
+        default:
+            return x < 3.0 ? sinc(x) * sinc(x / 3) : 0.0;
+    }
+}
+
+/* @function: makeTaps
+ * @purpose: the taps for resizing in pixels to out pixels. When
+ *           shrinking, the filter is stretched to cover every source
+ *           pixel that falls in an output pixel.
+ */
+static struct Taps makeTaps(int in, int out, Resize_Filter filter)
+{
+    double scale = (double)in / out;
+    double stretch = scale > 1 ? scale : 1;
+    double reach = support(filter) * stretch;
+    struct Taps taps;
+    taps.stride = 2 * (int)ceil(reach) + 2;
+    taps.first = ALLOC(out * sizeof(int));
+    taps.count = ALLOC(out * sizeof(int));
+    taps.weights = ALLOC((size_t)out * taps.stride * sizeof(float));
+
+    for (int i = 0; i < out; i++) {
+        double centre = (i + 0.5) * scale;
+        int lo = (int)floor(centre - reach);
+        int hi = (int)ceil(centre + reach);
+        lo = lo > 0 ? lo : 0;
+        hi = hi < in ? hi : in;
+        if (hi - lo > taps.stride) {
+            hi = lo + taps.stride;
+        }
+
+        float *w = &taps.weights[(size_t)i * taps.stride];
+        double sum = 0;
+        for (int k = 0; k < hi - lo; k++) {
+            w[k] = filterAt(filter, (lo + k + 0.5 - centre) / stretch);
+            sum += w[k];
+        }
+        if (sum == 0) {                 /* nothing in reach: nearest */
+            lo = (int)centre < in ? (int)centre : in - 1;
+            hi = lo + 1;
+            w[0] = 1;
+            sum = 1;
+        }
+        for (int k = 0; k < hi - lo; k++) {
+            w[k] /= sum;
+        }
+        taps.first[i] = lo;
+        taps.count[i] = hi - lo;
+    }
+    return taps;
+}
+
+static void freeTaps(struct Taps *taps)
+{
+    FREE(taps->first);
+    FREE(taps->count);
+    FREE(taps->weights);
+}
+
+/* @function: findImage
+ * @purpose: fill in an Image, finding its storage where it can be
+ */
+static void findImage(struct Image *img, A2Methods_T methods, A2 array)
+{
+    img->methods = methods;
+    img->array = array;
+    img->direct = methods == uarray2_methods_plain ||
+                  methods == uarray2_methods_blocked;
+    if (img->direct) {
+        TransLoops_image(&img->storage, methods, array,
+                         methods == uarray2_methods_blocked);
+    }
+}
+
+/* @function: pixelAt
+ * @purpose: the pixel at (col, row), which must be in the image
+ */
+static inline Pnm_rgb pixelAt(const struct Image *img, int col, int row)
+{
+    if (!img->direct) {
+        return img->methods->at(img->array, col, row);
+    }
+    return TransLoops_at(&img->storage, col, row);
+}
+
+/* @function: channel
+ * @purpose: round a filtered value and keep it within [0, denominator]
+ */
+static inline unsigned channel(float value, unsigned denominator)
+{
+    if (value <= 0) {
+        return 0;
+    }
+    unsigned v = (unsigned)(value + 0.5f);
+    return v < denominator ? v : denominator;
+}
+
+/* @function: scaleBands
+ * @purpose: make one thread's bands of output rows
+ */
+static void *scaleBands(void *vjob)
+{
+    struct Job *job = vjob;
+    const struct Taps *across = job->across, *down = job->down;
+    float *buffer = NULL;
+    size_t bufferRows = 0;
+
+    for (int b = job->firstBand; b < job->lastBand; b++) {
+        int top = b * job->band;
+        int bottom = top + job->band < job->height ? top + job->band
+                                                   : job->height;
+        /* the source rows the band reaches, halo and all */
+        int srcTop = down->first[top];
+        int srcBottom = srcTop;
+        for (int row = top; row < bottom; row++) {
+            int end = down->first[row] + down->count[row];
+            srcBottom = end > srcBottom ? end : srcBottom;
+        }
+        size_t rows = srcBottom - srcTop;
+        if (rows > bufferRows) {
+            if (buffer != NULL) {
+                FREE(buffer);
+            }
+            buffer = ALLOC(rows * job->width * 3 * sizeof(float));
+            bufferRows = rows;
+        }
+
+        /* along the source rows */
+        for (int sr = srcTop; sr < srcBottom; sr++) {
+            float *out = &buffer[(size_t)(sr - srcTop) * job->width * 3];
+            Pnm_rgb line = job->src->direct &&
+                           job->src->storage.blocks == NULL
+                           ? pixelAt(job->src, 0, sr) : NULL;
+            for (int col = 0; col < job->width; col++) {
+                const float *w = &across->weights[(size_t)col *
+                                                  across->stride];
+                int first = across->first[col];
+                float r = 0, g = 0, bl = 0;
+                for (int k = 0; k < across->count[col]; k++) {
+                    Pnm_rgb p = line != NULL ? &line[first + k]
+                                             : pixelAt(job->src, first + k,
+                                                       sr);
+                    r += w[k] * p->red;
+                    g += w[k] * p->green;
+                    bl += w[k] * p->blue;
+                }
+                out[3 * col] = r;
+                out[3 * col + 1] = g;
+                out[3 * col + 2] = bl;
+            }
+        }
+
+        /* down the columns of the buffer */
+        for (int row = top; row < bottom; row++) {
+            const float *w = &down->weights[(size_t)row * down->stride];
+            int first = down->first[row] - srcTop;
+            for (int col = 0; col < job->width; col++) {
+                float r = 0, g = 0, bl = 0;
+                for (int k = 0; k < down->count[row]; k++) {
+                    const float *in = &buffer[((size_t)(first + k) *
+                                               job->width + col) * 3];
+                    r += w[k] * in[0];
+                    g += w[k] * in[1];
+                    bl += w[k] * in[2];
+                }
+                Pnm_rgb p = pixelAt(job->dst, col, row);
+                p->red = channel(r, job->denominator);
+                p->green = channel(g, job->denominator);
+                p->blue = channel(bl, job->denominator);
+            }
+        }
+    }
+    if (buffer != NULL) {
+        FREE(buffer);
+    }
+    return NULL;
+}
+
+extern A2 Resize_scale(Pnm_ppm ppm, int width, int height,
+                       Resize_Filter filter, int nthreads)
+{
+    assert(ppm != NULL && width > 0 && height > 0 && nthreads > 0);
+    assert(ppm->width > 0 && ppm->height > 0);
+    A2Methods_T methods = ppm->methods;
+    A2 scaled = methods->new(width, height, sizeof(struct Pnm_rgb));
+
+    struct Image src, dst;
+    findImage(&src, methods, ppm->pixels);
+    findImage(&dst, methods, scaled);
+    struct Taps across = makeTaps(ppm->width, width, filter);
+    struct Taps down = makeTaps(ppm->height, height, filter);
+
+    /* a band is a row of blocks, so no two threads write one block */
+    int band = methods == uarray2_methods_blocked
+               ? methods->blocksize(scaled) : BAND_ROWS;
+    int bands = (height + band - 1) / band;
+    if (nthreads > bands) {
+        nthreads = bands;
+    }
+    struct Job jobs[nthreads];
+    pthread_t threads[nthreads];
+    for (int i = 0; i < nthreads; i++) {
+        struct Job job = { &src, &dst, &across, &down, width, height,
+                           band, ppm->denominator,
+                           bands * i / nthreads, bands * (i + 1) / nthreads };
+        jobs[i] = job;
+    }
+
+    /* the calling thread takes the first bands itself */
+    for (int i = 1; i < nthreads; i++) {
+        pthread_create(&threads[i], NULL, scaleBands, &jobs[i]);
+    }
+    scaleBands(&jobs[0]);
+    for (int i = 1; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    freeTaps(&across);
+    freeTaps(&down);
+    if (src.direct) {
+        TransLoops_free(&src.storage);
+    }
+    if (dst.direct) {
+        TransLoops_free(&dst.storage);
+    }
+    return scaled;
+}
@@ -0,0 +1,41 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** resize.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for resize.c, which scales an image to a new
+ **          size with a separable filter: each output pixel is a weighted
+ **          sum along its row of the source, then down its column.
+ **/
+
+#ifndef RESIZE_INCLUDED
+#define RESIZE_INCLUDED
+
+#include "a2methods.h"
+#include "pnm.h"
+
+typedef enum Resize_Filter {
+    RESIZE_BOX = 0,         /* the average of the pixels covered */
+    RESIZE_BILINEAR,        /* a triangle, two pixels wide per output */
+    RESIZE_LANCZOS          /* windowed sinc, three lobes */
+} Resize_Filter;
+
+/* @function: Resize_scale
+ * @purpose: make a width x height copy of ppm's image, in an array of
+ *           ppm->methods. The output is made a band of rows at a time
+ *           (a row of blocks when blocked): the source rows the band's
+ *           filter reaches, including a halo above and below it, are
+ *           filtered along their rows into a buffer, which is then
+ *           filtered down its columns into the band. Bands are shared
+ *           out over nthreads threads; neighbouring bands each filter
+ *           the rows of their shared halo.
+ *
+ * @precondition: width > 0, height > 0, nthreads > 0, and the image is
+ *                not empty
+ * @returns: the new array; channels are rounded and kept within
+ *           [0, ppm->denominator]
+ */
+extern A2Methods_UArray2 Resize_scale(Pnm_ppm ppm, int width, int height,
+                                      Resize_Filter filter, int nthreads);
+
+#endif /* RESIZE_INCLUDED */
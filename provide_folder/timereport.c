@@ -0,0 +1,336 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** timereport.c
+ ** 18 October 2026
+ **
+ ** Purpose: per-phase timing of a ppmtrans run, written as text, JSON or
+ **          CSV. Times that were never measured are kept as -1 and come
+ **          out as null in JSON and as an empty field in CSV.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/resource.h>
+#include "assert.h"
+#include "mem.h"
+#include "cputiming.h"
+#include "timereport.h"
+
+#define T TimeReport_T
+
+static const char *phaseNames[TIMEREPORT_NPHASES] = {
+    "parse", "allocate", "transform", "convert", "write", "free"
+};
+
+struct T {
+    CPUTime_T cpuTimer;
+    CPUTime_T wallTimer;
+    double cpu[TIMEREPORT_NPHASES];
+    double wall[TIMEREPORT_NPHASES];
+    double totalCpu, totalWall;
+    double counters[CPUTIME_NCOUNTERS];
+    double allocated;
+    int width, height;
+    const char *layout;
+    int blocksize;
+    int threads;
+    const char *transform;
+    int cold;
+};
+
+extern T TimeReport_new(void)
+{
+    T report;
+    NEW(report);
+    report->cpuTimer = CPUTime_New();
+    report->wallTimer = CPUTime_NewWithClock(CPUTIME_WALL);
+    for (int i = 0; i < TIMEREPORT_NPHASES; i++) {
+        report->cpu[i] = -1;
+        report->wall[i] = -1;
+    }
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        report->counters[i] = -1;
+    }
+    report->totalCpu = -1;
+    report->totalWall = -1;
+    report->allocated = 0;
+    report->width = 0;
+    report->height = 0;
+    report->layout = "";
+    report->blocksize = 1;
+    report->threads = 1;
+    report->transform = "";
+    report->cold = 0;
+    return report;
+}
+
+extern void TimeReport_free(T *report)
+{
+    assert(report != NULL && *report != NULL);
+    CPUTime_Free(&(*report)->cpuTimer);
+    CPUTime_Free(&(*report)->wallTimer);
+    FREE(*report);
+}
+
+extern void TimeReport_start(T report, TimeReport_Phase phase)
+{
+    assert(report != NULL);
+    assert(phase >= 0 && phase < TIMEREPORT_NPHASES);
+    CPUTime_Start(report->wallTimer);
+    CPUTime_Start(report->cpuTimer);
+}
+
+extern void TimeReport_stop(T report, TimeReport_Phase phase)
+{
+    assert(report != NULL);
+    double cpu = CPUTime_Stop(report->cpuTimer);
+    double wall = CPUTime_Stop(report->wallTimer);
+    TimeReport_add(report, phase, cpu, wall);
+}
+
+/* @function: addTime
+ * @purpose: add a measurement to a time that may not have been measured
+ */
+static void addTime(double *time, double ns)
+{
+    if (ns < 0) {
+        return;
+    }
+    *time = (*time < 0) ? ns : *time + ns;
+}
+
+extern void TimeReport_add(T report, TimeReport_Phase phase,
+                           double cpuNanoseconds, double wallNanoseconds)
+{
+    assert(report != NULL);
+    assert(phase >= 0 && phase < TIMEREPORT_NPHASES);
+    addTime(&report->cpu[phase], cpuNanoseconds);
+    addTime(&report->wall[phase], wallNanoseconds);
+}
+
+extern void TimeReport_total(T report, double cpuNanoseconds,
+                             double wallNanoseconds)
+{
+    assert(report != NULL);
+    report->totalCpu = cpuNanoseconds;
+    report->totalWall = wallNanoseconds;
+}
+
+extern void TimeReport_image(T report, int width, int height)
+{
+    assert(report != NULL);
+    report->width = width;
+    report->height = height;
+}
+
+extern void TimeReport_config(T report, const char *layout, int blocksize,
+                              int threads, const char *transform)
+{
+    assert(report != NULL);
+    assert(layout != NULL && transform != NULL);
+    report->layout = layout;
+    report->blocksize = blocksize;
+    report->threads = threads;
+    report->transform = transform;
+}
+
+extern void TimeReport_cold(T report, int cold)
+{
+    assert(report != NULL);
+    report->cold = cold;
+}
+
+extern void TimeReport_counters(T report, CPUTime_T timer)
+{
+    assert(report != NULL && timer != NULL);
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        report->counters[i] = CPUTime_Count(timer, i);
+    }
+}
+
+extern void TimeReport_allocated(T report, double bytes)
+{
+    assert(report != NULL);
+    report->allocated += bytes;
+}
+
+/* @function: sumPhases
+ * @purpose: the total of the measured phases, or -1 if none were
+ */
+static double sumPhases(double *times)
+{
+    double sum = -1;
+    for (int i = 0; i < TIMEREPORT_NPHASES; i++) {
+        addTime(&sum, times[i]);
+    }
+    return sum;
+}
+
+/* @function: peakRSS
+ * @purpose: the largest resident set size of the process so far, in
+ *           bytes (Linux reports kilobytes)
+ */
+static double peakRSS(void)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+    return (double)usage.ru_maxrss * 1024;
+}
+
+/* @function: printKey
+ * @purpose: write a counter name as a key: lower case, '_' for spaces
+ */
+static void printKey(FILE *fp, const char *name)
+{
+    for (; *name != '\0'; name++) {
+        fputc(*name == ' ' ? '_' : tolower((unsigned char)*name), fp);
+    }
+}
+
+/* @function: printJSONNumber, printCSVNumber
+ * @purpose: write a measurement, or the format's "missing" for -1
+ */
+static void printJSONNumber(FILE *fp, double value)
+{
+    if (value < 0) {
+        fprintf(fp, "null");
+    } else {
+        fprintf(fp, "%.0f", value);
+    }
+}
+
+static void printCSVNumber(FILE *fp, double value)
+{
+    fputc(',', fp);
+    if (value >= 0) {
+        fprintf(fp, "%.0f", value);
+    }
+}
+
+static void writeText(T report, double totalCpu, double totalWall,
+                      double rss, FILE *fp)
+{
+    fprintf(fp, "Image %dx%d, %s (blocksize %d), %d thread(s), %s, "
+                "%s caches\n",
+            report->width, report->height, report->layout,
+            report->blocksize, report->threads, report->transform,
+            report->cold ? "cold" : "warm");
+    for (int i = 0; i < TIMEREPORT_NPHASES; i++) {
+        if (report->cpu[i] < 0 && report->wall[i] < 0) {
+            continue;
+        }
+        fprintf(fp, "Phase %s: ", phaseNames[i]);
+        if (report->cpu[i] >= 0) {
+            fprintf(fp, "%.0f ns CPU", report->cpu[i]);
+        }
+        if (report->wall[i] >= 0) {
+            fprintf(fp, "%s%.0f ns wall", report->cpu[i] >= 0 ? ", " : "",
+                    report->wall[i]);
+        }
+        fprintf(fp, "\n");
+    }
+    fprintf(fp, "All phases: %.0f ns CPU, %.0f ns wall\n",
+            totalCpu, totalWall);
+    fprintf(fp, "Image storage allocated: %.0f bytes\n", report->allocated);
+    fprintf(fp, "Peak resident set size: %.0f bytes\n", rss);
+}
+
+static void writeJSON(T report, double totalCpu, double totalWall,
+                      double rss, FILE *fp)
+{
+    fprintf(fp, "{\"width\":%d,\"height\":%d,\"layout\":\"%s\","
+                "\"blocksize\":%d,\"threads\":%d,\"transform\":\"%s\","
+                "\"cache\":\"%s\"",
+            report->width, report->height, report->layout,
+            report->blocksize, report->threads, report->transform,
+            report->cold ? "cold" : "warm");
+    for (int i = 0; i < TIMEREPORT_NPHASES; i++) {
+        fprintf(fp, ",\"%s_cpu_ns\":", phaseNames[i]);
+        printJSONNumber(fp, report->cpu[i]);
+        fprintf(fp, ",\"%s_wall_ns\":", phaseNames[i]);
+        printJSONNumber(fp, report->wall[i]);
+    }
+    fprintf(fp, ",\"total_cpu_ns\":");
+    printJSONNumber(fp, totalCpu);
+    fprintf(fp, ",\"total_wall_ns\":");
+    printJSONNumber(fp, totalWall);
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        fprintf(fp, ",\"");
+        printKey(fp, CPUTime_CounterName(i));
+        fprintf(fp, "\":");
+        printJSONNumber(fp, report->counters[i]);
+    }
+    fprintf(fp, ",\"allocated_bytes\":%.0f,\"peak_rss_bytes\":",
+            report->allocated);
+    printJSONNumber(fp, rss);
+    fprintf(fp, "}\n");
+}
+
+static void writeCSVHeader(FILE *fp)
+{
+    fprintf(fp, "width,height,layout,blocksize,threads,transform,cache");
+    for (int i = 0; i < TIMEREPORT_NPHASES; i++) {
+        fprintf(fp, ",%s_cpu_ns,%s_wall_ns", phaseNames[i], phaseNames[i]);
+    }
+    fprintf(fp, ",total_cpu_ns,total_wall_ns");
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        fputc(',', fp);
+        printKey(fp, CPUTime_CounterName(i));
+    }
+    fprintf(fp, ",allocated_bytes,peak_rss_bytes\n");
+}
+
+static void writeCSV(T report, double totalCpu, double totalWall,
+                     double rss, FILE *fp)
+{
+    /* ftell is -1 on a pipe; every run into a pipe gets its header */
+    if (fseek(fp, 0, SEEK_END) != 0 || ftell(fp) <= 0) {
+        writeCSVHeader(fp);
+    }
+    fprintf(fp, "%d,%d,%s,%d,%d,%s,%s", report->width, report->height,
+            report->layout, report->blocksize, report->threads,
+            report->transform, report->cold ? "cold" : "warm");
+    for (int i = 0; i < TIMEREPORT_NPHASES; i++) {
+        printCSVNumber(fp, report->cpu[i]);
+        printCSVNumber(fp, report->wall[i]);
+    }
+    printCSVNumber(fp, totalCpu);
+    printCSVNumber(fp, totalWall);
+    for (int i = 0; i < CPUTIME_NCOUNTERS; i++) {
+        printCSVNumber(fp, report->counters[i]);
+    }
+    printCSVNumber(fp, report->allocated);
+    printCSVNumber(fp, rss);
+    fprintf(fp, "\n");
+}
+
+extern void TimeReport_write(T report, FILE *fp, TimeReport_Format format)
+{
+    assert(report != NULL && fp != NULL);
+
+    double totalCpu = report->totalCpu;
+    double totalWall = report->totalWall;
+    if (totalCpu < 0 && totalWall < 0) {
+        totalCpu = sumPhases(report->cpu);
+        totalWall = sumPhases(report->wall);
+    }
+    double rss = peakRSS();
+
+    switch (format) {
+        case REPORT_JSON:
+            writeJSON(report, totalCpu, totalWall, rss, fp);
+            break;
+        case REPORT_CSV:
+            writeCSV(report, totalCpu, totalWall, rss, fp);
+            break;
+        default:
+            writeText(report, totalCpu, totalWall, rss, fp);
+            break;
+    }
+}
+
+#undef T
@@ -0,0 +1,121 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** timereport.h
+ ** 18 October 2026
+ **
+ ** Purpose: public interface for timereport.c, which times each phase of
+ **          one ppmtrans run and writes the results, with the image and
+ **          configuration they belong to, as text, a JSON line, or a CSV
+ **          line.
+ **/
+
+#ifndef TIMEREPORT_INCLUDED
+#define TIMEREPORT_INCLUDED
+
+#include <stdio.h>
+#include "cputiming.h"
+
+typedef enum TimeReport_Format {
+    REPORT_TEXT = 0,
+    REPORT_JSON,
+    REPORT_CSV
+} TimeReport_Format;
+
+typedef enum TimeReport_Phase {
+    PHASE_PARSE = 0,        /* read and decode the input */
+    PHASE_ALLOCATE,         /* make the destination array */
+    PHASE_TRANSFORM,        /* rotate/flip */
+    PHASE_CONVERT,          /* swap the result into the Pnm_ppm */
+    PHASE_WRITE,            /* encode and write the output */
+    PHASE_FREE,             /* free everything */
+    TIMEREPORT_NPHASES
+} TimeReport_Phase;
+
+#define T TimeReport_T
+typedef struct T *T;
+
+/* @function: TimeReport_new
+ * @purpose: make an empty report, in which no phase has been measured
+ *
+ * @returns: type T
+ */
+extern T TimeReport_new(void);
+
+/* @function: TimeReport_free
+ * @purpose: deallocate a report
+ */
+extern void TimeReport_free(T *report);
+
+/* @function: TimeReport_start, TimeReport_stop
+ * @purpose: time one phase in CPU time and in wall clock time. A phase
+ *           timed more than once adds up.
+ *
+ * @precondition: phases are not nested or overlapped
+ */
+extern void TimeReport_start(T report, TimeReport_Phase phase);
+extern void TimeReport_stop(T report, TimeReport_Phase phase);
+
+/* @function: TimeReport_add
+ * @purpose: add a phase time measured elsewhere (for example by the
+ *           stages of the pipelined mode); -1 means not measured
+ */
+extern void TimeReport_add(T report, TimeReport_Phase phase,
+                           double cpuNanoseconds, double wallNanoseconds);
+
+/* @function: TimeReport_total
+ * @purpose: set the CPU and wall time of the whole run; if it is never
+ *           set, the sum of the phases is reported
+ */
+extern void TimeReport_total(T report, double cpuNanoseconds,
+                             double wallNanoseconds);
+
+/* @function: TimeReport_image
+ * @purpose: record the size of the input image
+ */
+extern void TimeReport_image(T report, int width, int height);
+
+/* @function: TimeReport_config
+ * @purpose: record how the image was processed
+ *
+ * @parameters: 1) T report
+ *              2) const char *layout, e.g. "row-major"
+ *              3) int blocksize, of the storage (1 for plain arrays)
+ *              4) int threads, threads that did the work
+ *              5) const char *transform, e.g. "rotate 90"
+ * @returns: none
+ */
+extern void TimeReport_config(T report, const char *layout, int blocksize,
+                              int threads, const char *transform);
+
+/* @function: TimeReport_cold
+ * @purpose: record whether the caches were flushed before the transform
+ */
+extern void TimeReport_cold(T report, int cold);
+
+/* @function: TimeReport_counters
+ * @purpose: keep the hardware counters of a stopped timer (the one that
+ *           timed the transform, or the whole run) to go in the report
+ */
+extern void TimeReport_counters(T report, CPUTime_T timer);
+
+/* @function: TimeReport_allocated
+ * @purpose: count bytes of image storage allocated during the run
+ */
+extern void TimeReport_allocated(T report, double bytes);
+
+/* @function: TimeReport_write
+ * @purpose: write the report. Text is a few readable lines. JSON is one
+ *           object on one line. CSV is one line; a header line is
+ *           written first if fp is at its start. Peak resident set size
+ *           is read from the system at the time of the call.
+ *
+ * @parameters: 1) T report
+ *              2) FILE *fp, where to write (JSON and CSV lines are meant
+ *                 to be appended to a file that collects many runs)
+ *              3) TimeReport_Format format
+ * @returns: none
+ */
+extern void TimeReport_write(T report, FILE *fp, TimeReport_Format format);
+
+#undef T
+#endif /* TIMEREPORT_INCLUDED */
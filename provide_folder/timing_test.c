@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include "assert.h"
 #include "cputiming.h"
 
 
@@ -17,6 +18,8 @@ main(int argc, char *argv[])
 	int innerlimit = 1;
 
 	timer = CPUTime_New();
+	if (CPUTime_EnableCounters(timer) == 0)
+		printf("Hardware counters are not available here\n");
 
 
 	for (outerct = 0; outerct < outerlooptimes; outerct++) {
@@ -27,11 +30,67 @@ main(int argc, char *argv[])
 		}
 		time_used = CPUTime_Stop(timer);
 		printf ("Sum %.0f was computed in %.0f nanoseconds\n", sum, time_used);
+		for (int c = 0; c < CPUTIME_NCOUNTERS; c++) {
+			double count = CPUTime_Count(timer, c);
+			if (count >= 0)
+				printf ("    %s: %.0f\n", CPUTime_CounterName(c),
+					count);
+		}
 		innerlimit *= 10;
 	}
 
 	CPUTime_Free(&timer);
 
+	/* The same small loop many times on every clock, summarized */
+	printf ("TSC frequency: %.0f ticks per second\n",
+		CPUTime_TSCFrequency());
+	for (int clock = CPUTIME_PROCESS; clock <= CPUTIME_TSC; clock++) {
+		CPUStats_T stats = CPUStats_New("sum of 1000", clock);
+		for (outerct = 0; outerct < 1000; outerct++) {
+			sum = 0.0;
+			CPUStats_Start(stats);
+			for (i = 0; i < 1000; i++) {
+				sum += i;
+			}
+			CPUStats_Stop(stats);
+		}
+		assert(CPUStats_Count(stats) == 1000);
+		assert(CPUStats_Min(stats) <= CPUStats_Median(stats));
+		assert(CPUStats_Median(stats) <= CPUStats_Percentile(stats, 90));
+		assert(CPUStats_Percentile(stats, 90) <= CPUStats_Max(stats));
+		CPUStats_Print(stdout, stats);
+		CPUStats_Free(&stats);
+	}
+
+	/* Stopping twice must not disturb the start time */
+	timer = CPUTime_NewWithClock(CPUTIME_WALL);
+	CPUTime_Start(timer);
+	double first = CPUTime_Stop(timer);
+	double second = CPUTime_Stop(timer);
+	assert(first <= second);
+	CPUTime_Free(&timer);
+
+	/* One wild sample among steady ones is rejected, the rest kept */
+	CPUStats_T stats = CPUStats_New("outliers", CPUTIME_WALL);
+	for (i = 0; i < 9; i++)
+		CPUStats_Add(stats, 100 + i);
+	CPUStats_Add(stats, 100000);
+	assert(CPUStats_RejectOutliers(stats) == 1);
+	assert(CPUStats_Count(stats) == 9);
+	assert(CPUStats_Max(stats) == 108);
+	assert(CPUStats_Total(stats) == 936);
+	CPUStats_Free(&stats);
+
+	/* Pinning and flushing work, or say why not */
+	if (CPUTime_PinCPUs("0") != 0)
+		printf("Could not pin to CPU 0\n");
+	timer = CPUTime_NewWithClock(CPUTIME_WALL);
+	CPUTime_FlushCaches();
+	CPUTime_Start(timer);
+	CPUTime_FlushCaches();
+	printf ("Cache flush took %.0f nanoseconds\n", CPUTime_Stop(timer));
+	CPUTime_Free(&timer);
+
 	return EXIT_SUCCESS;
 }
 
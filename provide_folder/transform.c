@@ -0,0 +1,698 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** transform.c
+ ** 18 October 2026
+ **
+ ** Purpose: the rotations and flips of ppmtrans. The apply functions and
+ **          alterImage were written for ppmtrans.c (20 February 2020) and
+ **          moved here so ppmbench can time exactly the same code.
+ **
+ **          For UArray2 and UArray2b images the work is done by the
+ **          specialized loops of transloops.h. Any other methods suite
+ **          (and -generic) goes through the span maps, with one callback
+ **          per run of a row, or through the apply functions where there
+ **          is no span map (column-major).
+ **/
+
+#include <string.h>
+#include <pthread.h>
+
+#include "assert.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+#include "pnm.h"
+#include "transform.h"
+#include "transloops.h"
+
+static int generic = 0;
+
+/* @function: apply90
+ * @purpose: apply function to be passed in to map function to rotate
+ *           image 90 degrees clockwise. The way our apply functions
+ *           work, we iterate over the 2D array which will be the finished,
+ *           rotated, image. The original image is passed in via the closure
+ *           variable.
+ *
+ * @postcondition: the value at a given index will be set to value in
+ *                 ppm 90 degrees COUNTERclockwise to current position in
+ *                 array2
+ *
+ * @parameters: 1) int col, the col in the array2 we are at
+ *              2) int row, the row in the array2 we are at
+ *              3) A2Methods_UArray2 array2, the array2 we are iterating over
+ *              4) A2MEthods_Object *ptr, the element at the given row and col
+                   in array2
+ *              5) void *cl, the Pnm_ppm holding the original image we want to 
+ *                 rotate
+ *
+ * @returns: none
+ */
+static void apply90(int col, int row, A2Methods_UArray2 array2,
+            A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    assert(ptr != NULL);
+    assert(cl != NULL);
+
+    Pnm_ppm *ppm = cl;
+    int oldRow = (*ppm)->height - col - 1;
+    int oldCol = row;
+
+    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
+                                                     oldCol, oldRow)); 
+}
+
+/* @function: apply180
+ * @purpose: apply function to be passed in to map function to rotate
+ *           image 180 degrees. 
+ *
+ * @postcondition: the value at a given index will be set to value in
+ *                 ppm 180 degrees from current position in array2
+ *
+ * @parameters: 1) int col, the col in the array2 we are at
+ *              2) int row, the row in the array2 we are at
+ *              3) A2Methods_UArray2 array2, the array2 we are iterating over
+ *              4) A2MEthods_Object *ptr, the element at the given row and col
+                   in array2
+ *              5) void *cl, the Pnm_ppm holding the original image we want to 
+ *                 rotate
+ *
+ * @returns: none
+ */
+static void apply180(int col, int row, A2Methods_UArray2 array2,
+            A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    assert(ptr != NULL);
+    assert(cl != NULL);
+
+    Pnm_ppm *ppm = cl;
+    int oldRow = (*ppm)->height - row - 1;
+    int oldCol = (*ppm)->width - col - 1;
+
+    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
+                                                     oldCol, oldRow)); 
+}
+
+/* @function: apply270
+ * @purpose: apply function to be passed in to map function to rotate
+ *           image 270 degrees clockwise. 
+ *
+ * @postcondition: the value at a given index will be set to value in
+ *                 ppm 270 degrees COUNTERclockwise from current position
+ *                 in array2.
+ *
+ * @parameters: 1) int col, the col in the array2 we are at
+ *              2) int row, the row in the array2 we are at
+ *              3) A2Methods_UArray2 array2, the array2 we are iterating over
+ *              4) A2MEthods_Object *ptr, the element at the given row and col
+                   in array2
+ *              5) void *cl, the Pnm_ppm holding the original image we want to 
+ *                 rotate
+ *
+ * @returns: none
+ */
+static void apply270(int col, int row, A2Methods_UArray2 array2,
+            A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    assert(ptr != NULL);
+    assert(cl != NULL);
+
+    Pnm_ppm *ppm = cl;
+    int oldRow = col;
+    int oldCol = (*ppm)->width - row - 1;
+
+    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
+                                                     oldCol, oldRow)); 
+}
+
+/* @function: applyFlipHorizontal
+ * @purpose: apply function to be passed in to map function to flip
+ *           image horizontally. 
+ *
+ * @postcondition: the value at a given index will be set to value in
+ *                 ppm flipped across the horizontal axis
+ *
+ * @parameters: 1) int col, the col in the array2 we are at
+ *              2) int row, the row in the array2 we are at
+ *              3) A2Methods_UArray2 array2, the array2 we are iterating over
+ *              4) A2MEthods_Object *ptr, the element at the given row and col
+ *                 in array2
+ *              5) void *cl, the Pnm_ppm holding the original image we want to 
+ *                 flip
+ *
+ * @returns: none
+ */
+static void applyFlipHorizontal(int col, int row, A2Methods_UArray2 array2,
+            A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    assert(ptr != NULL);
+    assert(cl != NULL);
+
+    Pnm_ppm *ppm = cl;
+    int oldRow = (*ppm)->height - row - 1;
+    int oldCol = col;
+
+    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
+                                                     oldCol, oldRow)); 
+}
+
+/* @function: applyFlipVertical
+ * @purpose: apply function to be passed in to map function to flip
+ *           image vertically. 
+ *
+ * @postcondition: the value at a given index will be set to value in
+ *                 ppm flipped across the vertical axis
+ *
+ * @parameters: 1) int col, the col in the array2 we are at
+ *              2) int row, the row in the array2 we are at
+ *              3) A2Methods_UArray2 array2, the array2 we are iterating over
+ *              4) A2MEthods_Object *ptr, the element at the given row and col
+ *                 in array2
+ *              5) void *cl, the Pnm_ppm holding the original image we want to 
+ *                 flip
+ *
+ * @returns: none
+ */
+static void applyFlipVertical(int col, int row, A2Methods_UArray2 array2,
+            A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    assert(ptr != NULL);
+    assert(cl != NULL);
+
+    Pnm_ppm *ppm = cl;
+    int oldRow = row;
+    int oldCol = (*ppm)->width - col - 1;
+
+    *(Pnm_rgb)ptr = *(Pnm_rgb)((*ppm)->methods->at((*ppm)->pixels, 
+                                                     oldCol, oldRow)); 
+}
+
+/* @function: span90, span180, span270, spanFlipHorizontal,
+ *            spanFlipVertical
+ * @purpose: span functions to be passed in to span map functions. Each
+ *           does what the apply function of the same name does, for all
+ *           n elements of a run of a row of array2, so the map calls back
+ *           once per run instead of once per pixel.
+ *
+ * @parameters: 1) int col, int row, where the run starts in array2
+ *              2) int n, the length of the run
+ *              3) A2Methods_UArray2 array2, the array2 we are filling
+ *              4) A2Methods_Object *ptr, the first element of the run
+ *              5) void *cl, the Pnm_ppm holding the original image
+ *
+ * @returns: none
+ */
+static void span90(int col, int row, int n, A2Methods_UArray2 array2,
+                   A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    Pnm_ppm ppm = *(Pnm_ppm *)cl;
+    Pnm_rgb out = ptr;
+    for (int k = 0; k < n; k++) {
+        out[k] = *(Pnm_rgb)ppm->methods->at(ppm->pixels, row,
+                                            ppm->height - (col + k) - 1);
+    }
+}
+
+static void span180(int col, int row, int n, A2Methods_UArray2 array2,
+                    A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    Pnm_ppm ppm = *(Pnm_ppm *)cl;
+    Pnm_rgb out = ptr;
+    for (int k = 0; k < n; k++) {
+        out[k] = *(Pnm_rgb)ppm->methods->at(ppm->pixels,
+                                            ppm->width - (col + k) - 1,
+                                            ppm->height - row - 1);
+    }
+}
+
+static void span270(int col, int row, int n, A2Methods_UArray2 array2,
+                    A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    Pnm_ppm ppm = *(Pnm_ppm *)cl;
+    Pnm_rgb out = ptr;
+    for (int k = 0; k < n; k++) {
+        out[k] = *(Pnm_rgb)ppm->methods->at(ppm->pixels,
+                                            ppm->width - row - 1, col + k);
+    }
+}
+
+static void spanFlipHorizontal(int col, int row, int n,
+                               A2Methods_UArray2 array2,
+                               A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    Pnm_ppm ppm = *(Pnm_ppm *)cl;
+    Pnm_rgb out = ptr;
+    for (int k = 0; k < n; k++) {
+        out[k] = *(Pnm_rgb)ppm->methods->at(ppm->pixels, col + k,
+                                            ppm->height - row - 1);
+    }
+}
+
+static void spanFlipVertical(int col, int row, int n,
+                             A2Methods_UArray2 array2,
+                             A2Methods_Object *ptr, void *cl)
+{
+    (void) array2;
+    Pnm_ppm ppm = *(Pnm_ppm *)cl;
+    Pnm_rgb out = ptr;
+    for (int k = 0; k < n; k++) {
+        out[k] = *(Pnm_rgb)ppm->methods->at(ppm->pixels,
+                                            ppm->width - (col + k) - 1, row);
+    }
+}
+
+/* the span function for each TransLoops_Op */
+static A2Methods_spanfun *const spanFuns[TRANSLOOPS_NOPS] = {
+    span90, span180, span270, spanFlipHorizontal, spanFlipVertical
+};
+
+/* @function: newRotatedUArray2
+ * @purpose: helper function to break up the code from main. Simply
+ *           created new UArray2 in particular style
+ *
+ * @postcondition: new UArray2 is returned in proper format
+ *
+ * @parameters: 1) int rotation, the degrees we are rotating
+ *              2) Pnm_ppm ppm, the image we are rotating
+ *              3) A2Methods_T methods, the methods suite we are using
+ *
+ * @returns: A2Methods_UArray2, correctly formatted and initialized UArray2
+ */
+A2Methods_UArray2 newRotatedUArray2(int rotation, Pnm_ppm ppm, 
+                                    A2Methods_T methods)
+{
+    int newWidth = ppm->width;
+    int newHeight = ppm->height;
+    /* if rotating 90 or 270, height and width of
+     * image must be flipped 
+     */
+    if (rotation == 90 || rotation == 270) {
+        newHeight = ppm->width;
+        newWidth = ppm-> height;
+    }
+    return methods->new(newWidth, newHeight, methods->size(ppm->pixels));
+}
+
+void setGenericTransform(int on)
+{
+    generic = on;
+}
+
+/* @function: loopKind
+ * @purpose: which specialized loops fit a methods suite visited with a
+ *           given map function
+ *
+ * @returns: a TransLoops_Kind, or -1 if the apply functions must be used
+ */
+static int loopKind(A2Methods_T methods, A2Methods_mapfun map)
+{
+    if (generic) {
+        return -1;
+    }
+    if (methods == uarray2_methods_plain) {
+        if (map == methods->map_col_major) {
+            return TRANSLOOPS_PLAIN_COLS;
+        }
+        if (map == a2plain_map_tile_major) {
+            return TRANSLOOPS_PLAIN_TILES;
+        }
+        if (map == methods->map_row_major || map == methods->map_default) {
+            return TRANSLOOPS_PLAIN_ROWS;
+        }
+    } else if (methods == uarray2_methods_blocked) {
+        if (map == methods->map_block_major || map == methods->map_default) {
+            return TRANSLOOPS_BLOCKED;
+        }
+    }
+    return -1;
+}
+
+/* @function: spanMapFor
+ * @purpose: the span map visiting in the same order as map, if the
+ *           methods suite has one
+ *
+ * @returns: the span map, or NULL (column-major has none)
+ */
+static A2Methods_spanmapfun *spanMapFor(A2Methods_T methods,
+                                        A2Methods_mapfun map)
+{
+    if (map == methods->map_row_major) {
+        return methods->span_map_row_major;
+    } else if (map == methods->map_block_major) {
+        return methods->span_map_block_major;
+    } else if (map == methods->map_default) {
+        return methods->span_map_default;
+    } else if (map == a2plain_map_tile_major) {
+        return a2plain_span_map_tile_major;
+    }
+    return NULL;
+}
+
+/* @function: shapeFits
+ * @purpose: whether rotated has the shape op makes from ppm, and has
+ *           pixels. The loops read the source without bounds checks, and
+ *           TransLoops_image takes the address of pixel (0, 0), so anything
+ *           else goes to the apply functions, whose maps visit nothing when
+ *           the image is empty and whose at() asserts as it always has.
+ */
+static int shapeFits(TransLoops_Op op, Pnm_ppm ppm, A2Methods_UArray2 rotated)
+{
+    int width = ppm->methods->width(rotated);
+    int height = ppm->methods->height(rotated);
+    if (width == 0 || height == 0) {
+        return 0;
+    }
+    if (op == TRANSLOOPS_ROTATE90 || op == TRANSLOOPS_ROTATE270) {
+        return width == (int)ppm->height && height == (int)ppm->width;
+    }
+    return width == (int)ppm->width && height == (int)ppm->height;
+}
+
+/* @function: transformOnce
+ * @purpose: fill rotated from ppm with one rotation or flip, with the
+ *           specialized loop if there is one, else with the span function
+ *           and the span map in map's order, else with the apply function
+ *           and map
+ */
+static void transformOnce(TransLoops_Op op, A2Methods_applyfun apply,
+                          Pnm_ppm ppm, A2Methods_mapfun map,
+                          A2Methods_UArray2 rotated)
+{
+    int kind = loopKind(ppm->methods, map);
+    if (kind < 0 || !shapeFits(op, ppm, rotated)) {
+        A2Methods_spanmapfun *spanMap = spanMapFor(ppm->methods, map);
+        if (spanMap != NULL) {
+            spanMap(rotated, spanFuns[op], &ppm);
+        } else {
+            map(rotated, apply, &ppm);
+        }
+        return;
+    }
+
+    TransLoops_Image dst, src;
+    int blocked = (kind == TRANSLOOPS_BLOCKED);
+    TransLoops_image(&dst, ppm->methods, rotated, blocked);
+    TransLoops_image(&src, ppm->methods, ppm->pixels, blocked);
+    if (kind == TRANSLOOPS_PLAIN_TILES) {
+        dst.tile = a2plain_tile_size(rotated);
+    }
+    TransLoops_select(op, kind)(&dst, &src, 0, dst.height);
+    TransLoops_free(&dst);
+    TransLoops_free(&src);
+}
+
+static void applyInStrips(TransLoops_Op op, A2Methods_applyfun *apply,
+                          Pnm_ppm *ppm, A2Methods_mapfun map,
+                          A2Methods_UArray2 rotated, int nthreads);
+
+/* @function: transformStep
+ * @purpose: fill dest from ppm with one rotation or flip: with
+ *           transformOnce if nthreads is 0, else in strips on nthreads
+ *           threads
+ */
+static void transformStep(TransLoops_Op op, A2Methods_applyfun apply,
+                          Pnm_ppm ppm, A2Methods_mapfun map,
+                          A2Methods_UArray2 dest, int nthreads)
+{
+    if (nthreads == 0) {
+        transformOnce(op, apply, ppm, map, dest);
+    } else {
+        applyInStrips(op, apply, &ppm, map, dest, nthreads);
+    }
+}
+
+/* @function: rotateThenFlip
+ * @purpose: fill rotated with ppm rotated clockwise and then flipped, as
+ *           -pipeline, -view, -planar and the gray images do. With both a
+ *           rotation and a flip the rotation goes into an image of its
+ *           own, which the flip then reads.
+ */
+static void rotateThenFlip(int rotation, char *flip, Pnm_ppm ppm,
+                           A2Methods_mapfun map, A2Methods_UArray2 rotated,
+                           int nthreads)
+{
+    TransLoops_Op turn = TRANSLOOPS_NOPS, mirror = TRANSLOOPS_NOPS;
+    A2Methods_applyfun *turnApply = NULL, *mirrorApply = NULL;
+    switch (rotation) {
+        case 90:
+            turn = TRANSLOOPS_ROTATE90;
+            turnApply = apply90;
+            break;
+        case 180:
+            turn = TRANSLOOPS_ROTATE180;
+            turnApply = apply180;
+            break;
+        case 270:
+            turn = TRANSLOOPS_ROTATE270;
+            turnApply = apply270;
+            break;
+        default:
+            break;
+    }
+    if (strcmp(flip, "horizontal") == 0) {
+        mirror = TRANSLOOPS_FLIP_HORIZONTAL;
+        mirrorApply = applyFlipHorizontal;
+    } else if (strcmp(flip, "vertical") == 0) {
+        mirror = TRANSLOOPS_FLIP_VERTICAL;
+        mirrorApply = applyFlipVertical;
+    }
+
+    if (mirror == TRANSLOOPS_NOPS) {
+        if (turn != TRANSLOOPS_NOPS) {
+            transformStep(turn, turnApply, ppm, map, rotated, nthreads);
+        }
+        return;
+    }
+    if (turn == TRANSLOOPS_NOPS) {
+        transformStep(mirror, mirrorApply, ppm, map, rotated, nthreads);
+        return;
+    }
+
+    A2Methods_T methods = ppm->methods;
+    struct Pnm_ppm turned = *ppm;
+    turned.width = methods->width(rotated);
+    turned.height = methods->height(rotated);
+    turned.pixels = methods->new_with_blocksize(turned.width, turned.height,
+                                                methods->size(rotated),
+                                                methods->blocksize(rotated));
+    transformStep(turn, turnApply, ppm, map, turned.pixels, nthreads);
+    transformStep(mirror, mirrorApply, &turned, map, rotated, nthreads);
+    methods->free(&turned.pixels);
+}
+
+/* @function: alterImage
+ * @purpose: helper function to break up the code from main. Handles
+ *           calling proper rotation function given input.
+ *
+ * @postcondition: rotated holds ppm rotated, then flipped
+ *
+ * @parameters: 1) int rotation, the rotation we are doing
+ *              2) char *flip, the flip being called
+ *              3) Pnm_ppm ppm, the image being rotated/flipped
+ *              4) A2Methods_mapfun map, the map function that has been
+ *                 determined by client
+ *              5) A2Methods_UArray2 rotated, the uarray2 that will become
+ *                 the fully rotated image.
+ *
+ * @returns: none
+ */
+void alterImage(int rotation, char *flip, Pnm_ppm ppm, A2Methods_mapfun map, 
+                A2Methods_UArray2 rotated)
+{
+    rotateThenFlip(rotation, flip, ppm, map, rotated, 0);
+}
+
+/* @function: sourceOf
+ * @purpose: where pixel (col, row) of the result of op comes from in a
+ *           sw x sh source
+ */
+static void sourceOf(TransLoops_Op op, int col, int row, int sw, int sh,
+                     int *srcCol, int *srcRow)
+{
+#define SOURCE_CASE(OP)                                         \
+        case TRANSLOOPS_##OP:                                   \
+            *srcCol = TRANSLOOPS_##OP##_COL(col, row, sw, sh);  \
+            *srcRow = TRANSLOOPS_##OP##_ROW(col, row, sw, sh);  \
+            return;
+    switch (op) {
+        SOURCE_CASE(ROTATE90)
+        SOURCE_CASE(ROTATE180)
+        SOURCE_CASE(ROTATE270)
+        SOURCE_CASE(FLIP_HORIZONTAL)
+        SOURCE_CASE(FLIP_VERTICAL)
+        default:
+            *srcCol = col;
+            *srcRow = row;
+            return;
+    }
+#undef SOURCE_CASE
+}
+
+int sourceRegion(int rotation, char *flip, int width, int height,
+                 int *col, int *row, int *w, int *h)
+{
+    assert(flip != NULL);
+    assert(col != NULL && row != NULL && w != NULL && h != NULL);
+    int quarter = (rotation == 90 || rotation == 270);
+    int resultWidth = quarter ? height : width;
+    int resultHeight = quarter ? width : height;
+    if (*w <= 0 || *h <= 0 || *col < 0 || *row < 0 ||
+        *col + *w > resultWidth || *row + *h > resultHeight) {
+        return -1;
+    }
+
+    /* alterImage rotates and then flips, so a pixel of the result comes
+     * through the flip from the rotated image (of the result's size),
+     * and through the rotation from the source */
+    TransLoops_Op mirror = TRANSLOOPS_NOPS, turn = TRANSLOOPS_NOPS;
+    if (strcmp(flip, "horizontal") == 0) {
+        mirror = TRANSLOOPS_FLIP_HORIZONTAL;
+    } else if (strcmp(flip, "vertical") == 0) {
+        mirror = TRANSLOOPS_FLIP_VERTICAL;
+    }
+    if (rotation == 90) {
+        turn = TRANSLOOPS_ROTATE90;
+    } else if (rotation == 180) {
+        turn = TRANSLOOPS_ROTATE180;
+    } else if (rotation == 270) {
+        turn = TRANSLOOPS_ROTATE270;
+    }
+
+    /* every op is a quarter turn or mirror, so two opposite corners map
+     * to two opposite corners */
+    int c0, r0, c1, r1;
+    sourceOf(mirror, *col, *row, resultWidth, resultHeight, &c0, &r0);
+    sourceOf(turn, c0, r0, width, height, &c0, &r0);
+    sourceOf(mirror, *col + *w - 1, *row + *h - 1, resultWidth, resultHeight,
+             &c1, &r1);
+    sourceOf(turn, c1, r1, width, height, &c1, &r1);
+    *col = c0 < c1 ? c0 : c1;
+    *row = r0 < r1 ? r0 : r1;
+    *w = (c0 < c1 ? c1 - c0 : c0 - c1) + 1;
+    *h = (r0 < r1 ? r1 - r0 : r0 - r1) + 1;
+    return 0;
+}
+
+/********** threaded transform **********/
+
+/* one thread's share of alterImageThreaded; loop is NULL when the apply
+ * function is used */
+struct Strip {
+    A2Methods_applyfun *apply;
+    TransLoops_fun *loop;
+    const TransLoops_Image *dst, *src;
+    Pnm_ppm *ppm;
+    A2Methods_UArray2 rotated;
+    int firstRow, lastRow;
+};
+
+/* @function: stripThread
+ * @purpose: run the apply function over rows [firstRow, lastRow) of the
+ *           destination, as the map functions would
+ */
+static void *stripThread(void *vstrip)
+{
+    struct Strip *strip = vstrip;
+    if (strip->loop != NULL) {
+        strip->loop(strip->dst, strip->src, strip->firstRow, strip->lastRow);
+        return NULL;
+    }
+
+    A2Methods_T methods = (*strip->ppm)->methods;
+    int width = methods->width(strip->rotated);
+
+    for (int row = strip->firstRow; row < strip->lastRow; row++) {
+        for (int col = 0; col < width; col++) {
+            strip->apply(col, row, strip->rotated,
+                         methods->at(strip->rotated, col, row), strip->ppm);
+        }
+    }
+    return NULL;
+}
+
+/* @function: applyInStrips
+ * @purpose: run one apply function over rotated on nthreads threads, with
+ *           the specialized loop for map if there is one
+ */
+static void applyInStrips(TransLoops_Op op, A2Methods_applyfun *apply,
+                          Pnm_ppm *ppm, A2Methods_mapfun map,
+                          A2Methods_UArray2 rotated, int nthreads)
+{
+    A2Methods_T methods = (*ppm)->methods;
+    int kind = loopKind(methods, map);
+    if (!shapeFits(op, *ppm, rotated)) {
+        kind = -1;
+    }
+    TransLoops_Image dst, src;
+    if (kind >= 0) {
+        int blocked = (kind == TRANSLOOPS_BLOCKED);
+        TransLoops_image(&dst, methods, rotated, blocked);
+        TransLoops_image(&src, methods, (*ppm)->pixels, blocked);
+    }
+
+    /* strips are whole blocks, or whole tiles */
+    int height = methods->height(rotated);
+    int unit = methods->blocksize(rotated);
+    if (kind == TRANSLOOPS_PLAIN_TILES) {
+        dst.tile = unit = a2plain_tile_size(rotated);
+    }
+    int units = (height + unit - 1) / unit;
+    if (nthreads > units) {
+        nthreads = units > 0 ? units : 1;
+    }
+
+    struct Strip strips[nthreads];
+    pthread_t threads[nthreads];
+    for (int i = 0; i < nthreads; i++) {
+        strips[i].apply = apply;
+        strips[i].loop = kind >= 0 ? TransLoops_select(op, kind) : NULL;
+        strips[i].dst = &dst;
+        strips[i].src = &src;
+        strips[i].ppm = ppm;
+        strips[i].rotated = rotated;
+        strips[i].firstRow = (units * i / nthreads) * unit;
+        strips[i].lastRow = (units * (i + 1) / nthreads) * unit;
+        if (strips[i].lastRow > height) {
+            strips[i].lastRow = height;
+        }
+    }
+
+    /* the calling thread takes the first strip itself, and any strip
+     * whose thread would not start */
+    int started[nthreads];
+    for (int i = 1; i < nthreads; i++) {
+        started[i] = pthread_create(&threads[i], NULL, stripThread,
+                                    &strips[i]) == 0;
+        if (!started[i]) {
+            stripThread(&strips[i]);
+        }
+    }
+    stripThread(&strips[0]);
+    for (int i = 1; i < nthreads; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    if (kind >= 0) {
+        TransLoops_free(&dst);
+        TransLoops_free(&src);
+    }
+}
+
+void alterImageThreaded(int rotation, char *flip, Pnm_ppm ppm,
+                        A2Methods_mapfun map, A2Methods_UArray2 rotated,
+                        int nthreads)
+{
+    assert(ppm != NULL && rotated != NULL);
+    assert(nthreads > 0);
+    rotateThenFlip(rotation, flip, ppm, map, rotated, nthreads);
+}
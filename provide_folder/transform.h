@@ -0,0 +1,92 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** transform.h
+ ** 18 October 2026
+ **
+ ** Purpose: public interface for transform.c, the rotations and flips
+ **          of ppmtrans, shared with ppmbench
+ **/
+
+#ifndef TRANSFORM_INCLUDED
+#define TRANSFORM_INCLUDED
+
+#include "a2methods.h"
+#include "pnm.h"
+
+/* @function: newRotatedUArray2
+ * @purpose: create the destination array for a rotation, in the storage
+ *           of the given methods suite
+ *
+ * @parameters: 1) int rotation, the degrees we are rotating
+ *              2) Pnm_ppm ppm, the image we are rotating
+ *              3) A2Methods_T methods, the methods suite we are using
+ *
+ * @returns: A2Methods_UArray2, correctly formatted and initialized UArray2
+ */
+extern A2Methods_UArray2 newRotatedUArray2(int rotation, Pnm_ppm ppm,
+                                           A2Methods_T methods);
+
+/* @function: setGenericTransform
+ * @purpose: with on nonzero, always use the apply functions and the map
+ *           (or at) of the methods suite, even where transloops.h has a
+ *           specialized loop; for comparing the two
+ */
+extern void setGenericTransform(int on);
+
+/* @function: alterImage
+ * @purpose: fill rotated with ppm rotated clockwise and then flipped,
+ *           visiting rotated in the order of the given map function. With
+ *           both a rotation and a flip the rotated image is made first, in
+ *           an array of its own.
+ *
+ * @parameters: 1) int rotation, the rotation we are doing
+ *              2) char *flip, the flip being called
+ *              3) Pnm_ppm ppm, the image being rotated/flipped
+ *              4) A2Methods_mapfun map, the map function that has been
+ *                 determined by client
+ *              5) A2Methods_UArray2 rotated, the uarray2 that will become
+ *                 the fully rotated image.
+ *
+ * @returns: none
+ */
+extern void alterImage(int rotation, char *flip, Pnm_ppm ppm,
+                       A2Methods_mapfun map, A2Methods_UArray2 rotated);
+
+/* @function: alterImageThreaded
+ * @purpose: do the same work as alterImage on nthreads threads. rotated
+ *           is cut into strips of whole rows (whole rows of blocks or
+ *           tiles, so no two threads write the same block) and each
+ *           thread fills its strip in the order of map where there is a
+ *           specialized loop for it, and in row-major order otherwise.
+ *
+ * @precondition: nthreads > 0
+ *
+ * @parameters: 1) int rotation, char *flip, Pnm_ppm ppm, as alterImage
+ *              2) A2Methods_mapfun map, as alterImage
+ *              3) A2Methods_UArray2 rotated, made by ppm->methods
+ *              4) int nthreads, the number of threads to use
+ *
+ * @returns: none
+ */
+extern void alterImageThreaded(int rotation, char *flip, Pnm_ppm ppm,
+                               A2Methods_mapfun map,
+                               A2Methods_UArray2 rotated, int nthreads);
+
+/* @function: sourceRegion
+ * @purpose: find the rectangle of a width x height source that rotation
+ *           and flip turn into the *w x *h rectangle at (*col, *row) of
+ *           the result. Transforming just that rectangle of the source
+ *           gives just that rectangle of the result.
+ *
+ * @parameters: 1) int rotation, char *flip, the transform
+ *              2) int width, int height, the size of the source
+ *              3) int *col, int *row, int *w, int *h, the rectangle of
+ *                 the result on the way in, of the source on the way out
+ *
+ * @returns: 0, or -1 (with nothing changed) if the rectangle is empty or
+ *           not inside the result
+ */
+extern int sourceRegion(int rotation, char *flip, int width, int height,
+                        int *col, int *row, int *w, int *h);
+
+#endif /* TRANSFORM_INCLUDED */
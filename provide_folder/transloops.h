@@ -0,0 +1,255 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** transloops.h
+ ** 19 October 2026
+ **
+ ** Purpose: header-only specialized loops for the rotations and flips of
+ **          transform.c. There is one loop per (transform, layout, order):
+ **          the source coordinate is a macro expression and the element
+ **          type is struct Pnm_rgb, so each loop is a plain copy the
+ **          compiler can inline and vectorize, with no apply function, no
+ **          methods->at and no asserts per pixel.
+ **
+ **          The loops read the arrays' storage directly. A UArray2 is one
+ **          row-major run starting at element (0, 0); a UArray2b is a grid
+ **          of blocks, each one blocksize * blocksize run starting at its
+ **          top left element. TransLoops_image finds those runs through
+ **          the methods suite once, before the loop starts.
+ **/
+
+#ifndef TRANSLOOPS_INCLUDED
+#define TRANSLOOPS_INCLUDED
+
+#include "a2methods.h"
+#include "pnm.h"
+#include "mem.h"
+
+/* the transforms there are loops for */
+typedef enum TransLoops_Op {
+    TRANSLOOPS_ROTATE90 = 0,
+    TRANSLOOPS_ROTATE180,
+    TRANSLOOPS_ROTATE270,
+    TRANSLOOPS_FLIP_HORIZONTAL,
+    TRANSLOOPS_FLIP_VERTICAL,
+    TRANSLOOPS_NOPS
+} TransLoops_Op;
+
+/* the storage and order the loops are specialized for */
+typedef enum TransLoops_Kind {
+    TRANSLOOPS_PLAIN_ROWS = 0,  /* UArray2, destination row by row */
+    TRANSLOOPS_PLAIN_COLS,      /* UArray2, destination column by column */
+    TRANSLOOPS_PLAIN_TILES,     /* UArray2, destination tile by tile */
+    TRANSLOOPS_BLOCKED,         /* UArray2b, destination block by block */
+    TRANSLOOPS_NKINDS
+} TransLoops_Kind;
+
+/* where an array's elements are */
+typedef struct TransLoops_Image {
+    Pnm_rgb base;               /* plain: element (0, 0) */
+    Pnm_rgb *blocks;            /* blocked: first element of every block,
+                                   blocks in row-major order */
+    int width, height;
+    int blocksize, blocksWide;
+    int tile;                   /* plain tiles: the tile size */
+} TransLoops_Image;
+
+/* @function: TransLoops_fun
+ * @purpose: fill rows [firstRow, lastRow) of dst from src. For blocked
+ *           arrays firstRow is a multiple of the blocksize, and so is
+ *           lastRow unless it is the height; the same goes for the tile
+ *           size when tiling.
+ */
+typedef void TransLoops_fun(const TransLoops_Image *dst,
+                            const TransLoops_Image *src,
+                            int firstRow, int lastRow);
+
+/* element (c, r) of a plain or blocked image */
+#define TRANSLOOPS_PLAIN_AT(img, c, r) \
+        ((img)->base[(size_t)(r) * (img)->width + (c)])
+#define TRANSLOOPS_BLOCKED_AT(img, c, r)                                \
+        ((img)->blocks[((r) / (img)->blocksize) * (img)->blocksWide +   \
+                       (c) / (img)->blocksize]                          \
+                      [((r) % (img)->blocksize) * (img)->blocksize +    \
+                       (c) % (img)->blocksize])
+
+/* @function: TransLoops_at
+ * @purpose: element (c, r) of an image found by TransLoops_image, for
+ *           code that does not know which kind of array it has
+ */
+static inline Pnm_rgb TransLoops_at(const TransLoops_Image *img, int c,
+                                    int r)
+{
+    return img->blocks != NULL ? &TRANSLOOPS_BLOCKED_AT(img, c, r)
+                               : &TRANSLOOPS_PLAIN_AT(img, c, r);
+}
+
+/* where destination (col, row) comes from in a sw x sh source */
+#define TRANSLOOPS_ROTATE90_COL(col, row, sw, sh)         (row)
+#define TRANSLOOPS_ROTATE90_ROW(col, row, sw, sh)         ((sh) - (col) - 1)
+#define TRANSLOOPS_ROTATE180_COL(col, row, sw, sh)        ((sw) - (col) - 1)
+#define TRANSLOOPS_ROTATE180_ROW(col, row, sw, sh)        ((sh) - (row) - 1)
+#define TRANSLOOPS_ROTATE270_COL(col, row, sw, sh)        ((sw) - (row) - 1)
+#define TRANSLOOPS_ROTATE270_ROW(col, row, sw, sh)        (col)
+#define TRANSLOOPS_FLIP_HORIZONTAL_COL(col, row, sw, sh)  (col)
+#define TRANSLOOPS_FLIP_HORIZONTAL_ROW(col, row, sw, sh)  ((sh) - (row) - 1)
+#define TRANSLOOPS_FLIP_VERTICAL_COL(col, row, sw, sh)    ((sw) - (col) - 1)
+#define TRANSLOOPS_FLIP_VERTICAL_ROW(col, row, sw, sh)    (row)
+
+/* @macro: TRANSLOOPS_DEFINE
+ * @purpose: define the four loops for one transform
+ */
+#define TRANSLOOPS_DEFINE(OP)                                                \
+static inline void TransLoops_##OP##_plain_rows(const TransLoops_Image *dst, \
+        const TransLoops_Image *src, int firstRow, int lastRow)              \
+{                                                                            \
+    int sw = src->width, sh = src->height;                                   \
+    (void) sw; (void) sh;                                                    \
+    for (int row = firstRow; row < lastRow; row++) {                         \
+        Pnm_rgb out = &TRANSLOOPS_PLAIN_AT(dst, 0, row);                     \
+        for (int col = 0; col < dst->width; col++) {                         \
+            out[col] = TRANSLOOPS_PLAIN_AT(src,                              \
+                    TRANSLOOPS_##OP##_COL(col, row, sw, sh),                 \
+                    TRANSLOOPS_##OP##_ROW(col, row, sw, sh));                \
+        }                                                                    \
+    }                                                                        \
+}                                                                            \
+                                                                             \
+static inline void TransLoops_##OP##_plain_cols(const TransLoops_Image *dst, \
+        const TransLoops_Image *src, int firstRow, int lastRow)              \
+{                                                                            \
+    int sw = src->width, sh = src->height;                                   \
+    (void) sw; (void) sh;                                                    \
+    for (int col = 0; col < dst->width; col++) {                             \
+        for (int row = firstRow; row < lastRow; row++) {                     \
+            TRANSLOOPS_PLAIN_AT(dst, col, row) = TRANSLOOPS_PLAIN_AT(src,    \
+                    TRANSLOOPS_##OP##_COL(col, row, sw, sh),                 \
+                    TRANSLOOPS_##OP##_ROW(col, row, sw, sh));                \
+        }                                                                    \
+    }                                                                        \
+}                                                                            \
+                                                                             \
+static inline void TransLoops_##OP##_plain_tiles(const TransLoops_Image *dst,\
+        const TransLoops_Image *src, int firstRow, int lastRow)              \
+{                                                                            \
+    int sw = src->width, sh = src->height;                                   \
+    int t = dst->tile;                                                       \
+    (void) sw; (void) sh;                                                    \
+    for (int top = firstRow; top < lastRow; top += t) {                      \
+        int bottom = top + t < lastRow ? top + t : lastRow;                  \
+        for (int left = 0; left < dst->width; left += t) {                   \
+            int right = left + t < dst->width ? left + t : dst->width;       \
+            for (int row = top; row < bottom; row++) {                       \
+                Pnm_rgb out = &TRANSLOOPS_PLAIN_AT(dst, 0, row);             \
+                for (int col = left; col < right; col++) {                   \
+                    out[col] = TRANSLOOPS_PLAIN_AT(src,                      \
+                            TRANSLOOPS_##OP##_COL(col, row, sw, sh),         \
+                            TRANSLOOPS_##OP##_ROW(col, row, sw, sh));        \
+                }                                                            \
+            }                                                                \
+        }                                                                    \
+    }                                                                        \
+}                                                                            \
+                                                                             \
+static inline void TransLoops_##OP##_blocked(const TransLoops_Image *dst,    \
+        const TransLoops_Image *src, int firstRow, int lastRow)              \
+{                                                                            \
+    int sw = src->width, sh = src->height;                                   \
+    int bs = dst->blocksize;                                                 \
+    (void) sw; (void) sh;                                                    \
+    for (int top = firstRow; top < lastRow; top += bs) {                     \
+        int bottom = top + bs < lastRow ? top + bs : lastRow;                \
+        for (int left = 0; left < dst->width; left += bs) {                  \
+            int right = left + bs < dst->width ? left + bs : dst->width;     \
+            Pnm_rgb block = dst->blocks[(top / bs) * dst->blocksWide +       \
+                                        left / bs];                          \
+            for (int row = top; row < bottom; row++) {                       \
+                Pnm_rgb out = block + (row - top) * bs;                      \
+                for (int col = left; col < right; col++) {                   \
+                    out[col - left] = TRANSLOOPS_BLOCKED_AT(src,             \
+                            TRANSLOOPS_##OP##_COL(col, row, sw, sh),         \
+                            TRANSLOOPS_##OP##_ROW(col, row, sw, sh));        \
+                }                                                            \
+            }                                                                \
+        }                                                                    \
+    }                                                                        \
+}
+
+TRANSLOOPS_DEFINE(ROTATE90)
+TRANSLOOPS_DEFINE(ROTATE180)
+TRANSLOOPS_DEFINE(ROTATE270)
+TRANSLOOPS_DEFINE(FLIP_HORIZONTAL)
+TRANSLOOPS_DEFINE(FLIP_VERTICAL)
+
+#undef TRANSLOOPS_DEFINE
+
+/* @function: TransLoops_select
+ * @purpose: the loop for a transform, storage and order
+ */
+static inline TransLoops_fun *TransLoops_select(TransLoops_Op op,
+                                                TransLoops_Kind kind)
+{
+#define TRANSLOOPS_ROW(OP) { TransLoops_##OP##_plain_rows,  \
+                             TransLoops_##OP##_plain_cols,  \
+                             TransLoops_##OP##_plain_tiles, \
+                             TransLoops_##OP##_blocked }
+    static TransLoops_fun *const loops[TRANSLOOPS_NOPS][TRANSLOOPS_NKINDS] = {
+        TRANSLOOPS_ROW(ROTATE90),
+        TRANSLOOPS_ROW(ROTATE180),
+        TRANSLOOPS_ROW(ROTATE270),
+        TRANSLOOPS_ROW(FLIP_HORIZONTAL),
+        TRANSLOOPS_ROW(FLIP_VERTICAL)
+    };
+#undef TRANSLOOPS_ROW
+    return loops[op][kind];
+}
+
+/* @function: TransLoops_image
+ * @purpose: find the storage of a non-empty array of struct Pnm_rgb. For
+ *           a blocked array the block table is allocated and must be
+ *           given back with TransLoops_free.
+ *
+ * @parameters: 1) TransLoops_Image *img, filled in
+ *              2) A2Methods_T methods, the suite array was made with
+ *              3) A2Methods_UArray2 array
+ *              4) int blocked, whether methods is the UArray2b suite
+ * @returns: none
+ */
+static inline void TransLoops_image(TransLoops_Image *img,
+                                    A2Methods_T methods,
+                                    A2Methods_UArray2 array, int blocked)
+{
+    img->width = methods->width(array);
+    img->height = methods->height(array);
+    img->blocksize = blocked ? methods->blocksize(array) : 1;
+    img->blocksWide = (img->width + img->blocksize - 1) / img->blocksize;
+    img->tile = 0;
+    img->base = NULL;
+    img->blocks = NULL;
+    if (!blocked) {
+        img->base = methods->at(array, 0, 0);
+        return;
+    }
+
+    int bs = img->blocksize;
+    int blocksHigh = (img->height + bs - 1) / bs;
+    img->blocks = ALLOC((size_t)img->blocksWide * blocksHigh *
+                        sizeof(Pnm_rgb));
+    for (int br = 0; br < blocksHigh; br++) {
+        for (int bc = 0; bc < img->blocksWide; bc++) {
+            img->blocks[br * img->blocksWide + bc] =
+                    methods->at(array, bc * bs, br * bs);
+        }
+    }
+}
+
+/* @function: TransLoops_free
+ * @purpose: give back what TransLoops_image allocated
+ */
+static inline void TransLoops_free(TransLoops_Image *img)
+{
+    if (img->blocks != NULL) {
+        FREE(img->blocks);
+    }
+}
+
+#endif /* TRANSLOOPS_INCLUDED */
@@ -13,6 +13,7 @@
 #include "uarray.h"
 #include "mem.h"
 #include "uarray2.h"
+#include "elemcopy.h"
 
 #define T UArray2_T
 //typedef struct T *T;
@@ -24,6 +25,7 @@ struct T
     int MAX_ROWS;
     int MAX_COLS;
     int size;
+    ElemCopy_T copier;      /* copies of elements of size */
     UArray_T array;
 };
 
@@ -58,6 +60,7 @@ T UArray2_new(int width, int height, int size)
     uarray2->MAX_ROWS = height;
     uarray2->MAX_COLS = width;
     uarray2->size = size;
+    uarray2->copier = ElemCopy_select(size);
 
     uarray2->array = UArray_new(height * width, size);
 
@@ -165,6 +168,37 @@ void *UArray2_at(T uarray2, int col, int row)
     return UArray_at(uarray2->array, index);
 }
 
+/* @function: UArray2_copy, UArray2_copy_span, UArray2_swap
+ * @purpose: copy or swap elements with the copier chosen for the element
+ *           size in UArray2_new, so the size is dispatched on once per
+ *           array rather than once per element
+ *
+ * @precondition: T uarray2 is valid and initialized type T
+ * @postcondition: the elements have been copied or swapped
+ *
+ * @parameters: as in uarray2.h
+ * @returns: none
+ */
+void UArray2_copy(T uarray2, void *dst, const void *src)
+{
+    assert(uarray2 != NULL);
+    uarray2->copier->copy(dst, src, uarray2->size);
+}
+
+void UArray2_copy_span(T uarray2, void *dst, const void *src, int n,
+                       long step)
+{
+    assert(uarray2 != NULL);
+    assert(n >= 0);
+    uarray2->copier->copy_span(dst, src, n, step, uarray2->size);
+}
+
+void UArray2_swap(T uarray2, void *a, void *b)
+{
+    assert(uarray2 != NULL);
+    uarray2->copier->swap(a, b, uarray2->size);
+}
+
 /* @function: UArray2_map_row_major
  * @purpose: map function which performs function void apply to all
  *           elements in uarray2, starting with (0, 0) and iterating
@@ -239,5 +273,62 @@ void UArray2_map_col_major(T uarray2,
     }
 }
 
+/* @function: UArray2_map_tiled
+ * @purpose: map function which performs function void apply to all
+ *           elements in uarray2 one tile at a time, tiles row-major and
+ *           row-major within each tile
+ *
+ * @precondition: 1) T uarray2 is valid and initialized type T
+ *                2) tile is > 0
+ *                3) void apply is valid function following 
+ *                   parameter specifications
+ * @postcondition: function void apply will have been run on all elements,
+ *                 tile by tile
+ *
+ * @parameters: 1) T uarray2, which is UArray whose elements are being acted
+ *                 upon
+ *              2) int tile, which is the width and height of a tile
+ *              3) void apply(int col, int row, UArray2_T x, 
+ *                 void *element, void *cl), which is function that will 
+ *                 be run on all elements
+ *              4) void *cl, which is the client specifed pointer
+ * @returns: none
+ */
+void UArray2_map_tiled(T uarray2, int tile,
+                                    void apply(int col, int row,
+                                               UArray2_T x,
+                                               void *element, void *cl), 
+                                    void *cl)
+{
+    assert(uarray2 != NULL);
+    assert(tile > 0);
+    assert(apply != NULL);
+
+    int width = uarray2->MAX_COLS;
+    int height = uarray2->MAX_ROWS;
+    int size = uarray2->size;
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    /* the elements are one row-major run, so within a row of a tile the
+     * next element is size bytes on and no indexing is needed
+     */
+    char *first = UArray_at(uarray2->array, 0);
+    for (int top = 0; top < height; top += tile) {
+        int bottom = top + tile < height ? top + tile : height;
+        for (int left = 0; left < width; left += tile) {
+            int right = left + tile < width ? left + tile : width;
+            for (int r = top; r < bottom; r++) {
+                char *elem = first + ((size_t)r * width + left) * size;
+                for (int c = left; c < right; c++) {
+                    apply(c, r, uarray2, elem, cl);
+                    elem += size;
+                }
+            }
+        }
+    }
+}
+
 
 #undef T
\ No newline at end of file
@@ -99,6 +99,54 @@ extern int UArray2_size(T uarray2);
  */
 extern void *UArray2_at(T uarray2, int row, int col);
 
+/* @function: UArray2_copy
+ * @purpose: copy one element of uarray2's size from src to dst, with the
+ *           copy made for that size when uarray2 was created
+ *
+ * @precondition: 1) T uarray2 is valid and initialized type T
+ *                2) src and dst each hold an element of uarray2's size
+ * @postcondition: the element at src has been copied to dst
+ *
+ * @parameters: 1) T uarray2, whose element size is copied
+ *              2) void *dst, where the element is copied to
+ *              3) const void *src, where the element is copied from
+ * @returns: none
+ */
+extern void UArray2_copy(T uarray2, void *dst, const void *src);
+
+/* @function: UArray2_copy_span
+ * @purpose: copy n elements of uarray2's size to dst, one after another,
+ *           from src, src + step, src + 2 * step and so on. A step of the
+ *           element size copies a run; any other walks a column or a
+ *           row backwards.
+ *
+ * @precondition: 1) T uarray2 is valid and initialized type T
+ *                2) dst has room for n elements
+ * @postcondition: the n elements have been copied to dst
+ *
+ * @parameters: 1) T uarray2, whose element size is copied
+ *              2) void *dst, where the elements are copied to
+ *              3) const void *src, where the first element is
+ *              4) int n, how many elements are copied
+ *              5) long step, the bytes from one element of src to the
+ *                 next, which may be negative
+ * @returns: none
+ */
+extern void UArray2_copy_span(T uarray2, void *dst, const void *src, int n,
+                              long step);
+
+/* @function: UArray2_swap
+ * @purpose: swap the elements of uarray2's size at a and b
+ *
+ * @precondition: T uarray2 is valid and initialized type T
+ * @postcondition: a holds what b held, and b what a held
+ *
+ * @parameters: 1) T uarray2, whose element size is swapped
+ *              2) void *a, void *b, the elements
+ * @returns: none
+ */
+extern void UArray2_swap(T uarray2, void *a, void *b);
+
 /* @function: UArray2_map_row_major
  * @purpose: map function which performs function void apply to all
  *           elements in uarray2, starting with (0, 0) and iterating
@@ -149,5 +197,34 @@ extern void UArray2_map_col_major(T uarray2,
                                                void *element, void *cl), 
                                     void *cl);
 
+/* @function: UArray2_map_tiled
+ * @purpose: map function which performs function void apply to all
+ *           elements in uarray2 one tile at a time. Tiles are tile x tile
+ *           squares (smaller at the right and bottom edges) visited
+ *           row-major, and the elements of each tile are visited
+ *           row-major too.
+ *
+ * @precondition: 1) T uarray2 is valid and initialized type T
+ *                2) tile is > 0
+ *                3) void apply is valid function following 
+ *                   parameter specifications
+ * @postcondition: function void apply will have been run on all elements,
+ *                 tile by tile
+ *
+ * @parameters: 1) T uarray2, which is UArray whose elements are being acted
+ *                 upon
+ *              2) int tile, which is the width and height of a tile
+ *              3) void apply(int col, int row, UArray2_T x, 
+ *                 void *element, void *cl), which is function that will 
+ *                 be run on all elements   
+ *              4) void *cl, which is the client specifed pointer
+ * @returns: none
+ */
+extern void UArray2_map_tiled(T uarray2, int tile,
+                                    void apply(int col, int row,
+                                               UArray2_T x,
+                                               void *element, void *cl), 
+                                    void *cl);
+
 #undef T
 #endif /* UARRAY2_INCLUDED */
@@ -13,9 +13,13 @@
 #include "uarray2.h"
 #include "a2methods.h"
 #include "uarray2b.h"
+#include "elemcopy.h"
 #include <math.h>
+#include <unistd.h>
 
 #define SIXTYFOURK 65536
+#define DEFAULT_L1_BYTES (32 * 1024)
+#define DEFAULT_L2_BYTES (1024 * 1024)
 
 #define T UArray2b_T
 
@@ -30,7 +34,11 @@ struct T
     int size;
     int blocksize;
     int numCells;
-    UArray2_T array;
+    int tiles;              /* blocks a side of a superblock */
+    ElemCopy_T copier;      /* copies of elements of size */
+    UArray2_T array;        /* the first cell of each block */
+    UArray2_T supers;       /* a UArray_T per superblock: its blocks,
+                             * row-major, one after another */
 };
 
 /* @function: UArray2b_new
@@ -53,11 +61,38 @@ struct T
  * @returns: type T, which is the UArray2b
  */
 extern T UArray2b_new (int width, int height, int size, int blocksize)
+{
+    return UArray2b_new_two_level(width, height, size, blocksize, 1);
+}
+
+/* @function: UArray2b_new_two_level
+ * @purpose: Initialize new UArray2b whose blocks are grouped into
+ *           superblocks of tiles x tiles blocks. The blocks of a
+ *           superblock are allocated together, row-major, so a
+ *           superblock is one run of memory; superblocks at the right and
+ *           bottom edges hold only the blocks the array needs.
+ *
+ * @precondition: 1) width is >= 0
+ *                2) height is >= 0
+ *                3) size is > 0
+ *                4) blocksize > 0
+ *                5) tiles > 0
+ * @postcondition: new type T has been created and returned
+ *
+ * @parameters: 1) int width, int height, the size of the new UArray2b
+ *              2) int size, the bytes per element
+ *              3) int blocksize, the size of one side of a block
+ *              4) int tiles, the blocks along one side of a superblock
+ * @returns: type T, which is the UArray2b
+ */
+extern T UArray2b_new_two_level(int width, int height, int size,
+                                int blocksize, int tiles)
 {
     assert(width >= 0);
     assert(height >= 0);
     assert(size > 0);
     assert(blocksize > 0);
+    assert(tiles > 0);
 
     T uarray2b = malloc(sizeof(*uarray2b));
     assert(uarray2b != NULL);
@@ -66,14 +101,8 @@ extern T UArray2b_new (int width, int height, int size, int blocksize)
      * This gives us the number of blocks we need and ensures
      * we won't run out of space.
      */
-    int roundedWidth = width / blocksize;
-    if (blocksize % width != 0) {
-        roundedWidth += 1;
-    }
-    int roundedHeight = height / blocksize;
-    if (blocksize % height != 0) {
-        roundedHeight += 1;
-    }   
+    int roundedWidth = (width + blocksize - 1) / blocksize;
+    int roundedHeight = (height + blocksize - 1) / blocksize;
 
     uarray2b->MAX_ROWS = height;
     uarray2b->BLOCK_ROWS = roundedHeight;
@@ -83,21 +112,88 @@ extern T UArray2b_new (int width, int height, int size, int blocksize)
 
     uarray2b->blocksize = blocksize;
     uarray2b->numCells = blocksize * blocksize;
+    uarray2b->tiles = tiles;
     uarray2b->size = size;
+    uarray2b->copier = ElemCopy_select(size);
 
     uarray2b->array = UArray2_new(roundedWidth, roundedHeight, 
-                                  sizeof(UArray_T));
-
-    for (int row = 0; row < uarray2b->BLOCK_ROWS; row++) {
-        for (int col = 0; col < uarray2b->BLOCK_COLS; col++) {
-            *(UArray_T *)UArray2_at(uarray2b->array, col, row) = 
-                         UArray_new(uarray2b->numCells, size);
+                                  sizeof(char *));
+    uarray2b->supers = UArray2_new((roundedWidth + tiles - 1) / tiles,
+                                   (roundedHeight + tiles - 1) / tiles,
+                                   sizeof(UArray_T));
+
+    for (int srow = 0; srow < UArray2_height(uarray2b->supers); srow++) {
+        for (int scol = 0; scol < UArray2_width(uarray2b->supers);
+             scol++) {
+            int top = srow * tiles;
+            int left = scol * tiles;
+            int down = top + tiles < roundedHeight ? tiles
+                                                   : roundedHeight - top;
+            int across = left + tiles < roundedWidth ? tiles
+                                                     : roundedWidth - left;
+            UArray_T super = UArray_new(down * across *
+                                        uarray2b->numCells, size);
+            *(UArray_T *)UArray2_at(uarray2b->supers, scol, srow) = super;
+
+            for (int row = 0; row < down; row++) {
+                for (int col = 0; col < across; col++) {
+                    *(char **)UArray2_at(uarray2b->array, left + col,
+                                         top + row) =
+                        UArray_at(super, (row * across + col) *
+                                         uarray2b->numCells);
+                }
+            }
         }
     }
 
     return uarray2b;
 }
 
+/* @function: UArray2b_new_cache_sized
+ * @purpose: Initialize new two-level UArray2b sized from the caches of
+ *           this machine: a block of the source and a block of the
+ *           destination of a transform fit in L1 together, and a
+ *           superblock of each fit in L2
+ *
+ * @precondition: 1) width is >= 0
+ *                2) height is >= 0
+ *                3) size is > 0
+ * @postcondition: new type T has been created and returned
+ *
+ * @parameters: 1) int width, int height, the size of the new UArray2b
+ *              2) int size, the bytes per element
+ * @returns: type T, which is the UArray2b
+ */
+extern T UArray2b_new_cache_sized(int width, int height, int size)
+{
+    assert(size > 0);
+    long l1 = -1;
+    long l2 = -1;
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    if (l1 <= 0) {
+        l1 = DEFAULT_L1_BYTES;
+    }
+    if (l2 <= l1) {
+        l2 = l1 > DEFAULT_L2_BYTES ? 4 * l1 : DEFAULT_L2_BYTES;
+    }
+
+    /*must round down*/
+    int blocksize = sqrt((double)l1 / (2 * size));
+    if (blocksize == 0) {
+        blocksize = 1;
+    }
+    int tiles = sqrt((double)l2 / (2 * size)) / blocksize;
+    if (tiles == 0) {
+        tiles = 1;
+    }
+    return UArray2b_new_two_level(width, height, size, blocksize, tiles);
+}
+
 /* @function: UArray2b_new_64K_block
  * @purpose: Initialize new UArray2b with blocksize such that
  *           blocks are as big as possible while fitting within
@@ -143,12 +239,13 @@ extern T UArray2b_new_64K_block(int width, int height, int size)
 extern void UArray2b_free (T *array2b)
 {
     assert(array2b != NULL);
-    for (int row = 0; row < (*array2b)->BLOCK_ROWS; row++) {
-        for (int col = 0; col < (*array2b)->BLOCK_COLS; col++) {
-            UArray_free(((UArray_T *)(UArray2_at((*array2b)->array, 
-                        col, row))));
+    UArray2_T supers = (*array2b)->supers;
+    for (int row = 0; row < UArray2_height(supers); row++) {
+        for (int col = 0; col < UArray2_width(supers); col++) {
+            UArray_free(((UArray_T *)(UArray2_at(supers, col, row))));
         }
     }
+    UArray2_free(&supers);
     UArray2_free(&(*array2b)->array);
     free(*array2b);
 }
@@ -217,6 +314,22 @@ extern int UArray2b_blocksize(T array2b)
     return array2b->blocksize;
 }
 
+/* @function: UArray2b_superblock
+ * @purpose: return the number of blocks along one side of a superblock
+ *
+ * @precondition: T array2b is valid and initialized type T
+ * @postcondition: the blocks a side of a superblock have been returned
+ *
+ * @parameters: T array2b, which is type T whose superblocks the client
+ *              wants to know
+ * @returns: integer value, 1 if array2b has one level of blocks
+ */
+extern int UArray2b_superblock(T array2b)
+{
+    assert(array2b != NULL);
+    return array2b->tiles;
+}
+
 /* @function: UArray2b_at
  * @purpose: allows client to index value in T array2b
  *
@@ -246,20 +359,62 @@ extern void *UArray2b_at(T array2b, int column, int row)
 
     int blockRow = row / array2b->blocksize;
     int blockCol = column / array2b->blocksize;
-    UArray_T block;
-    block = *(UArray_T *)UArray2_at(array2b->array, blockCol, blockRow);
+    char *block;
+    block = *(char **)UArray2_at(array2b->array, blockCol, blockRow);
 
     int index = (array2b->blocksize * (row % array2b->blocksize))
                  + (column % array2b->blocksize);
-    return UArray_at(block, index);
+    return block + (size_t)index * array2b->size;
+}
+
+/* @function: UArray2b_copy, UArray2b_copy_span, UArray2b_swap
+ * @purpose: copy or swap elements with the copier chosen for the element
+ *           size in UArray2b_new, so the size is dispatched on once per
+ *           array rather than once per element
+ *
+ * @precondition: T array2b is valid and initialized type T
+ * @postcondition: the elements have been copied or swapped
+ *
+ * @parameters: as in uarray2b.h
+ * @returns: none
+ */
+extern void UArray2b_copy(T array2b, void *dst, const void *src)
+{
+    assert(array2b != NULL);
+    array2b->copier->copy(dst, src, array2b->size);
+}
+
+extern void UArray2b_copy_span(T array2b, void *dst, const void *src, int n,
+                               long step)
+{
+    assert(array2b != NULL);
+    assert(n >= 0);
+    array2b->copier->copy_span(dst, src, n, step, array2b->size);
+}
+
+extern void UArray2b_swap(T array2b, void *a, void *b)
+{
+    assert(array2b != NULL);
+    array2b->copier->swap(a, b, array2b->size);
 }
 
 
+/* @function: blockStart
+ * @purpose: return the first cell of the block in the given block column
+ *           and block row. The cells of a block are one run, row-major.
+ */
+static char *blockStart(T array2b, int blockCol, int blockRow)
+{
+    return *(char **)UArray2_at(array2b->array, blockCol, blockRow);
+}
+
 /* @function: UArray2_map
  * @purpose: map function which performs function void apply to all
  *           elements in array2b, starting with the first block and iterating
  *           block-major (first all elements in block one, then block two, 
- *           etc.)
+ *           etc.). Superblocks are visited row-major, the blocks of each
+ *           superblock row-major before the next superblock, so memory is
+ *           walked in the order it is laid out.
  *
  * @precondition: 1) T array2b is valid and initialized type T
  *                2) void apply is valid function following 
@@ -284,18 +439,147 @@ extern void UArray2b_map(T array2b,
     assert(apply != NULL);
 
     int blocksize = array2b->blocksize;
-    for (int i = 0; i < array2b->BLOCK_ROWS; i++) {
-        for (int j = 0; j < array2b->BLOCK_COLS; j++) {
-            for (int k = 0; k < array2b->numCells; k++) {
-                int col = (k % blocksize) + (blocksize * j);
-                int row = (k / blocksize) + (blocksize * i);
-
-                if (row >= array2b->MAX_ROWS || col >= array2b->MAX_COLS) {
-                    continue;
+    int tiles = array2b->tiles;
+    for (int top = 0; top < array2b->BLOCK_ROWS; top += tiles) {
+        for (int left = 0; left < array2b->BLOCK_COLS; left += tiles) {
+            int down = top + tiles < array2b->BLOCK_ROWS ?
+                       top + tiles : array2b->BLOCK_ROWS;
+            int across = left + tiles < array2b->BLOCK_COLS ?
+                         left + tiles : array2b->BLOCK_COLS;
+            for (int i = top; i < down; i++) {
+                for (int j = left; j < across; j++) {
+                    char *start = blockStart(array2b, j, i);
+                    for (int k = 0; k < array2b->numCells; k++) {
+                        int col = (k % blocksize) + (blocksize * j);
+                        int row = (k / blocksize) + (blocksize * i);
+
+                        if (row >= array2b->MAX_ROWS ||
+                            col >= array2b->MAX_COLS) {
+                            continue;
+                        }
+
+                        void *elem = start + (size_t)k * array2b->size;
+                        apply(col, row, array2b, elem, cl);
+                    }
                 }
+            }
+        }
+    }
+}
 
-                void *elem = UArray2b_at(array2b, col, row);
-                apply(col, row, array2b, elem, cl);
+/* @function: UArray2b_map_row_major
+ * @purpose: map function which performs function void apply to all
+ *           elements in array2b in row-major order. The rows of one band
+ *           of blocks are visited together; each row is a segment of
+ *           blocksize cells from each block of the band, walked with
+ *           pointer arithmetic rather than UArray2b_at.
+ *
+ * @precondition: 1) T array2b is valid and initialized type T
+ *                2) void apply is valid function following 
+ *                   parameter specifications
+ * @postcondition: function void apply will have been run on all elements,
+ *                 in row-major order
+ *
+ * @parameters: 1) T array2b, which is UArray2b whose elements are being acted
+ *                 upon
+ *              2) void apply(int col, int row, T array2b, 
+ *                 void *elem, void *cl), which is function that will 
+ *                 be run on all elements   
+ *              3) void *cl, which is the client specifed pointer
+ * @returns: none
+ */
+extern void UArray2b_map_row_major(T array2b,
+                                   void apply(int col, int row, T array2b,
+                                              void *elem, void *cl),
+                                   void *cl)
+{
+    assert(array2b != NULL);
+    assert(apply != NULL);
+
+    int blocksize = array2b->blocksize;
+    int size = array2b->size;
+    int blocksWide = (array2b->MAX_COLS + blocksize - 1) / blocksize;
+    if (blocksWide == 0) {
+        return;
+    }
+    char *starts[blocksWide];
+
+    for (int top = 0; top < array2b->MAX_ROWS; top += blocksize) {
+        for (int j = 0; j < blocksWide; j++) {
+            starts[j] = blockStart(array2b, j, top / blocksize);
+        }
+        int bottom = top + blocksize < array2b->MAX_ROWS ?
+                     top + blocksize : array2b->MAX_ROWS;
+        for (int row = top; row < bottom; row++) {
+            int offset = (row - top) * blocksize * size;
+            for (int j = 0; j < blocksWide; j++) {
+                char *elem = starts[j] + offset;
+                int left = j * blocksize;
+                int right = left + blocksize < array2b->MAX_COLS ?
+                            left + blocksize : array2b->MAX_COLS;
+                for (int col = left; col < right; col++) {
+                    apply(col, row, array2b, elem, cl);
+                    elem += size;
+                }
+            }
+        }
+    }
+}
+
+/* @function: UArray2b_map_col_major
+ * @purpose: map function which performs function void apply to all
+ *           elements in array2b in column-major order, one band of block
+ *           columns at a time; down a column of a block the next cell is
+ *           blocksize cells on.
+ *
+ * @precondition: 1) T array2b is valid and initialized type T
+ *                2) void apply is valid function following 
+ *                   parameter specifications
+ * @postcondition: function void apply will have been run on all elements,
+ *                 in column-major order
+ *
+ * @parameters: 1) T array2b, which is UArray2b whose elements are being acted
+ *                 upon
+ *              2) void apply(int col, int row, T array2b, 
+ *                 void *elem, void *cl), which is function that will 
+ *                 be run on all elements   
+ *              3) void *cl, which is the client specifed pointer
+ * @returns: none
+ */
+extern void UArray2b_map_col_major(T array2b,
+                                   void apply(int col, int row, T array2b,
+                                              void *elem, void *cl),
+                                   void *cl)
+{
+    assert(array2b != NULL);
+    assert(apply != NULL);
+
+    int blocksize = array2b->blocksize;
+    int size = array2b->size;
+    int blocksHigh = (array2b->MAX_ROWS + blocksize - 1) / blocksize;
+    if (blocksHigh == 0) {
+        return;
+    }
+    char *starts[blocksHigh];
+    int step = blocksize * size;
+
+    for (int left = 0; left < array2b->MAX_COLS; left += blocksize) {
+        for (int i = 0; i < blocksHigh; i++) {
+            starts[i] = blockStart(array2b, left / blocksize, i);
+        }
+        int right = left + blocksize < array2b->MAX_COLS ?
+                    left + blocksize : array2b->MAX_COLS;
+        for (int col = left; col < right; col++) {
+            int offset = (col - left) * size;
+            for (int i = 0; i < blocksHigh; i++) {
+                char *elem = starts[i] + offset;
+                int top = i * blocksize;
+                int bottom = top + blocksize < array2b->MAX_ROWS ?
+                             top + blocksize : array2b->MAX_ROWS;
+                for (int row = top; row < bottom; row++) {
+                    apply(col, row, array2b, elem, cl);
+                    elem += step;
+                }
             }
         }
     }
@@ -0,0 +1,96 @@
+/**
+ ** Max Mitchell & Jack Burns
+ ** uarray2b.h
+ ** 19 October 2026
+ **
+ ** Purpose: public interface for uarray2b.c: the course's uarray2b.h
+ **          with row-major and column-major maps added
+ **/
+
+#ifndef UARRAY2B_INCLUDED
+#define UARRAY2B_INCLUDED
+
+#define T UArray2b_T
+typedef struct T *T;
+
+/* new blocked 2d array: blocksize = square root of # of cells in block */
+extern T    UArray2b_new (int width, int height, int size, int blocksize);
+
+/* new blocked 2d array: blocksize as large as possible provided
+ * block occupies at most 64KB (if possible)
+ */
+extern T    UArray2b_new_64K_block(int width, int height, int size);
+
+/* new blocked 2d array in two levels: blocks of blocksize x blocksize
+ * cells, grouped tiles x tiles into superblocks whose blocks are one run
+ * of memory. UArray2b_new is this with tiles = 1.
+ */
+extern T    UArray2b_new_two_level(int width, int height, int size,
+                                   int blocksize, int tiles);
+
+/* new two-level array sized from this machine's caches: a source and a
+ * destination block fit in L1, a source and a destination superblock in
+ * L2
+ */
+extern T    UArray2b_new_cache_sized(int width, int height, int size);
+
+extern void  UArray2b_free     (T *array2b);
+extern int   UArray2b_width    (T array2b);
+extern int   UArray2b_height   (T array2b);
+extern int   UArray2b_size     (T array2b);
+extern int   UArray2b_blocksize(T array2b);
+extern int   UArray2b_superblock(T array2b);   /* blocks a side, or 1 */
+
+/* return a pointer to the cell in the given column and row.
+ * index out of range is a checked run-time error
+ */
+extern void *UArray2b_at(T array2b, int column, int row);
+
+/* copy one element of the array's size from src to dst; copy n of them
+ * to dst, one after another, from src, src + step ... (step in bytes,
+ * and may be negative); swap the elements at a and b. Each uses the copy
+ * chosen for the element size when the array was made.
+ */
+extern void  UArray2b_copy     (T array2b, void *dst, const void *src);
+extern void  UArray2b_copy_span(T array2b, void *dst, const void *src,
+                                int n, long step);
+extern void  UArray2b_swap     (T array2b, void *a, void *b);
+
+/* visits every cell in one block before moving to another block, and
+ * every block of a superblock before moving to another superblock
+ */
+extern void  UArray2b_map(T array2b,
+                          void apply(int col, int row, T array2b,
+                                     void *elem, void *cl),
+                          void *cl);
+
+/* @function: UArray2b_map_row_major
+ * @purpose: visit every cell in row-major order, as a UArray2 would. The
+ *           array is walked one band of block rows at a time, and each
+ *           row of the band one block-row segment at a time.
+ *
+ * @parameters: 1) T array2b, the array being visited
+ *              2) void apply(int col, int row, T array2b, void *elem,
+ *                 void *cl), run on every cell
+ *              3) void *cl, the client specified pointer
+ * @returns: none
+ */
+extern void  UArray2b_map_row_major(T array2b,
+                                    void apply(int col, int row, T array2b,
+                                               void *elem, void *cl),
+                                    void *cl);
+
+/* @function: UArray2b_map_col_major
+ * @purpose: visit every cell in column-major order, one band of block
+ *           columns at a time
+ *
+ * @parameters: as UArray2b_map_row_major
+ * @returns: none
+ */
+extern void  UArray2b_map_col_major(T array2b,
+                                    void apply(int col, int row, T array2b,
+                                               void *elem, void *cl),
+                                    void *cl);
+
+#undef T
+#endif